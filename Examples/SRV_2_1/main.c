@@ -33,7 +33,7 @@ static void prvTask2Function( void *pvParameters );
  * @brief Task 1 function
  *
  * This task check if button is pressed and change state of diode
- * LD3. At the end, task is blocked for 200 Ticks
+ * LD3. Task is released every 200 Ticks
  */
 static void prvTask1Function( void *pvParameters )
 {
@@ -41,6 +41,7 @@ static void prvTask1Function( void *pvParameters )
     /*Initial button states are 1 because of pull-up configuration*/
     uint8_t     previousButtonState = 1;
     uint8_t     currentButtonState  = 1;
+    TickType_t  xLastRelease        = xTaskGetTickCount();
     for ( ;; )
     {
         /*Read button state*/
@@ -56,25 +57,26 @@ static void prvTask1Function( void *pvParameters )
                 halTOGGLE_LED( LED3 );
             }
         }
-        /* delay for synchronization */
-        vTaskDelay( 200 );
+        /* wait for next release */
+        xTaskWaitForNextRelease( &xLastRelease, 200 );
     }
 }
 /**
  * @brief Task 2 function
  *
- * This task change state of diode LD 4. At the end, task is blocked
- * for 100 Ticks
+ * This task change state of diode LD 4. Task is released every
+ * 100 Ticks
  */
 static void prvTask2Function( void *pvParameters )
 {
     /* low priority task that toggles LED D4 */
+    TickType_t xLastRelease = xTaskGetTickCount();
     for ( ;; )
     {
         /* toggle LED D4 */
         halTOGGLE_LED( LED4 );
-        /* delay for synchronization */
-        vTaskDelay( 100 );
+        /* wait for next release */
+        xTaskWaitForNextRelease( &xLastRelease, 100 );
     }
 }
 /**
@@ -60,6 +60,8 @@
 #define configUSE_MALLOC_FAILED_HOOK	1
 #define configUSE_APPLICATION_TASK_TAG	0
 #define configUSE_COUNTING_SEMAPHORES	1
+/* Periodic tasks own their release schedule, see xTaskWaitForNextRelease */
+#define configUSE_PERIODIC_TASKS		1
 
 #ifdef __LARGE_DATA_MODEL__
 	#define configMINIMAL_STACK_SIZE		( ( unsigned short ) 80 )
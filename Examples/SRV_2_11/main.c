@@ -22,53 +22,11 @@
 /* User's includes */
 #include "../common/ETF5529_HAL/hal_ETF_5529.h"
 
-/** "Display task" priority */
-#define mainDISPLAY_TASK_PRIO           ( 1 )
 /** "ADC task" priority */
 #define mainADC_TASK_PRIO               ( 2 )
 
-/* Display queue parameters value*/
-/* Queue with length 1 is mailbox*/
-#define mainDISPLAY_QUEUE_LENGTH            1
-
 static void prvSetupHardware( void );
 
-/* This queue will be used to send data to display task*/
-xQueueHandle        xDisplayMailbox;
-/**
- * @brief "Display Task" Function
- *
- * This task read data from xDisplayQueue but reading is not blocking.
- * xDisplayQueue is used to send data which will be printed on 7Seg
- * display. After data is received it is decomposed on high and low digit.
- */
-static void prvDisplayTaskFunction( void *pvParameters )
-{
-    /* New received 8bit data */
-    uint8_t         NewValueToShow      = 0;
-    /* High and Low number digit*/
-    uint8_t         digitLow, digitHigh;
-    for ( ;; )
-    {
-        /* Check if new number is received*/
-        if(xQueueReceive(xDisplayMailbox, &NewValueToShow, 0) == pdTRUE){
-            /* If there is new number to show on display, split it on High and Low digit */
-            /* Extract high digit*/
-            digitHigh = NewValueToShow/10;
-            /* Extract low digit*/
-            digitLow = NewValueToShow - digitHigh*10;
-        }
-        HAL_7SEG_DISPLAY_1_ON;
-        HAL_7SEG_DISPLAY_2_OFF;
-        vHAL7SEGWriteDigit(digitLow);
-        vTaskDelay(5);
-        HAL_7SEG_DISPLAY_2_ON;
-        HAL_7SEG_DISPLAY_1_OFF;
-        vHAL7SEGWriteDigit(digitHigh);
-        vTaskDelay(5);
-    }
-}
-
 /**
  * @brief "ADC Task" Function
  *
@@ -76,12 +34,12 @@ static void prvDisplayTaskFunction( void *pvParameters )
  */
 static void prvADCTaskFunction( void *pvParameters )
 {
-
+    TickType_t xLastRelease = xTaskGetTickCount();
     for ( ;; )
     {
        /*Trigger ADC Conversion*/
        ADC12CTL0 |= ADC12SC;
-       vTaskDelay(200);
+       xTaskWaitForNextRelease(&xLastRelease, 200);
     }
 }
 /**
@@ -93,13 +51,6 @@ void main( void )
     prvSetupHardware();
 
     /* Create tasks */
-    xTaskCreate( prvDisplayTaskFunction,
-                 "Display Task",
-                 configMINIMAL_STACK_SIZE,
-                 NULL,
-                 mainDISPLAY_TASK_PRIO,
-                 NULL
-               );
     xTaskCreate( prvADCTaskFunction,
                  "ADC Task",
                  configMINIMAL_STACK_SIZE,
@@ -107,8 +58,6 @@ void main( void )
                  mainADC_TASK_PRIO,
                  NULL
                );
-    /* Create FreeRTOS objects  */
-    xDisplayMailbox       =   xQueueCreate(mainDISPLAY_QUEUE_LENGTH,sizeof(uint8_t));
     /* Start the scheduler. */
     vTaskStartScheduler();
 
@@ -148,14 +97,14 @@ static void prvSetupHardware( void )
 
     /* initialize LEDs */
     vHALInitLED();
-    /* initialize display*/
+    /* initialize display and refresh it from timer interrupt*/
     vHAL7SEGInit();
+    vHAL7SEGStartRefresh();
     /*enable global interrupts*/
     taskENABLE_INTERRUPTS();
 }
 void __attribute__ ( ( interrupt( ADC12_VECTOR  ) ) ) vADC12ISR( void )
 {
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
     uint16_t    temp;
     switch(__even_in_range(ADC12IV,34))
     {
@@ -165,7 +114,7 @@ void __attribute__ ( ( interrupt( ADC12_VECTOR  ) ) ) vADC12ISR( void )
         case  6:                                  // Vector  6:  ADC12IFG0
             /* Scaling ADC value to fit on two digits representation*/
             temp    = ADC12MEM0>>6;
-            xQueueSendToBackFromISR(xDisplayMailbox,&temp,&xHigherPriorityTaskWoken);
+            vHAL7SEGSetNumber(temp);
             break;
         case  8:                                  // Vector  8:  ADC12IFG1
             break;
@@ -184,6 +133,4 @@ void __attribute__ ( ( interrupt( ADC12_VECTOR  ) ) ) vADC12ISR( void )
         case 34: break;                           // Vector 34:  ADC12IFG14
         default: break;
     }
-    /* trigger scheduler if higher priority task is woken */
-    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
 }
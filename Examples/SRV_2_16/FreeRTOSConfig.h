@@ -60,6 +60,11 @@
 #define configUSE_MALLOC_FAILED_HOOK	1
 #define configUSE_APPLICATION_TASK_TAG	0
 #define configUSE_COUNTING_SEMAPHORES	1
+/* Index 0 is left to the application's xTaskNotify calls, hal_adc uses index
+1 and hal_button index 2 */
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES	3
+/* Tasks woken by interrupts while the scheduler is suspended are held in a bitmap */
+#define configUSE_BATCHED_WAKEUPS		1
 
 #ifdef __LARGE_DATA_MODEL__
 	#define configMINIMAL_STACK_SIZE		( ( unsigned short ) 80 )
@@ -68,7 +73,7 @@
 #endif
 
 /* Co-routine definitions. */
-#define configUSE_CO_ROUTINES 		0
+#define configUSE_CO_ROUTINES 		1
 #define configMAX_CO_ROUTINE_PRIORITIES ( 2 )
 
 /* Software timer definitions. */
@@ -86,6 +91,7 @@ to exclude the API function. */
 #define INCLUDE_vTaskSuspend			1
 #define INCLUDE_vTaskDelayUntil			1
 #define INCLUDE_vTaskDelay				1
+#define INCLUDE_xTaskGetTicksToNextUnblock	1
 
 /* The MSP430X port uses a callback function to configure its tick interrupt.
 This allows the application to choose the tick interrupt source.
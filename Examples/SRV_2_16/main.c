@@ -15,6 +15,7 @@
 #include "semphr.h"
 #include "queue.h"
 #include "event_groups.h"
+#include "croutine.h"
 
 /* Hardware includes. */
 #include "msp430.h"
@@ -24,162 +25,124 @@
 
 #define ULONG_MAX                       0xFFFFFFFF
 
-/** "Display task" priority */
-#define mainDISPLAY_TASK_PRIO           ( 1 )
 /** "ADC task" priority */
 #define mainADC_TASK_PRIO               ( 2 )
 /** "Button task" priority */
 #define mainBUTTON_TASK_PRIO            ( 3 )
-/** "Diode task" priority */
-#define mainDIODE_TASK_PRIO             ( 3 )
+/** "Diode co-routine" priority */
+#define mainDIODE_CO_ROUTINE_PRIO       ( 0 )
 
 
-/** ADC Task bit masks */
-#define mainADC_TAKE_SAMPLE             0x01    /* Start AD conversion bit mask */
-#define mainADC_CHANGE_CHANEL           0x02    /* Change AD conversion channel bit mask */
+/** ADC acquisition parameters */
+#define mainADC_CHANNEL_COUNT           2       /* Channels sampled in every frame */
+#define mainADC_FRAME_RATE              200     /* Frames per second */
+#define mainADC_FRAMES_PER_BUFFER       HAL_ADC_FRAMES_PER_SEQUENCE(mainADC_CHANNEL_COUNT)
 
-/* Display queue parameters value*/
-/* Queue with length 1 is mailbox*/
-#define mainDISPLAY_QUEUE_LENGTH            1
+/* One ADC frame, members are in pucADCChannels order */
+typedef struct{
+    uint16_t    usChannel0;
+    uint16_t    usChannel1;
+}ADCFrame_t;
 
 static void prvSetupHardware( void );
 
-/* This queue will be used to send data to display task*/
-xQueueHandle        xDisplayMailbox;
+/* Channels converted in every frame, A0 and A1 */
+static const uint8_t    pucADCChannels[mainADC_CHANNEL_COUNT] = {0, 1};
+/* Two buffers filled by DMA */
+static uint16_t         pusADCBuffers[HAL_ADC_BUFFERS_SIZE(mainADC_CHANNEL_COUNT, mainADC_FRAMES_PER_BUFFER)];
+/* Newest frame, written by ADC task and read by Button task */
+static ADCFrame_t       xLatestFrame;
+
 /* This handle will be used as Button task instance*/
 TaskHandle_t        xButtonTaskHandle;
 /* This handle will be used as ADC task instance*/
 TaskHandle_t        xADCTaskHandle;
-/* This handle will be used as DIODE task instance*/
-TaskHandle_t        xDIODETaskHandle;
+/* Handle of Diode co-routine, known after its first run*/
+CoRoutineHandle_t   xDIODECoRoutineHandle;
 
 /**
- * @brief "Diode Control" task function
+ * @brief "Diode Control" co-routine function
  *
- * This task set diode state based on prvDIODE_COMMAND variable
+ * Swaps LD3 and LD4 every time Button task notifies it. Co-routine runs
+ * from the idle task and has no stack of its own, local state that has to
+ * survive crNOTIFY_TAKE is static.
  */
-static void prvDiodeControlTaskFunction( void *pvParameters )
+static void prvDiodeControlCoRoutine( CoRoutineHandle_t xHandle, UBaseType_t uxIndex )
 {
-    uint8_t         diodeToTurnOn   =   LED3;
-    uint8_t         diodeToTurnOff  =   LED4;
-    halSET_LED(diodeToTurnOn);
-    halCLR_LED(diodeToTurnOff);
+    static uint8_t      diodeToTurnOn   =   LED3;
+    static BaseType_t   result;
+    uint8_t             diodeToTurnOff;
+
+    xDIODECoRoutineHandle = xHandle;
+    crSTART( xHandle );
+    halSET_LED(LED3);
+    halCLR_LED(LED4);
     for ( ;; )
     {
         /* Wait for notification*/
-        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        crNOTIFY_TAKE( xHandle, portMAX_DELAY, &result );
+        if(result != pdPASS) continue;
         diodeToTurnOn = diodeToTurnOn == LED3? LED4 : LED3;
         diodeToTurnOff = diodeToTurnOn == LED3? LED4 : LED3;
         halSET_LED(diodeToTurnOn);
         halCLR_LED(diodeToTurnOff);
     }
+    crEND();
 }
-/**
- * @brief "Display Task" Function
- *
- * This task read data from xDisplayQueue but reading is not blocking.
- * xDisplayQueue is used to send data which will be printed on 7Seg
- * display. After data is received it is decomposed on high and low digit.
- */
-static void prvDisplayTaskFunction( void *pvParameters )
-{
-    /* New received 8bit data */
-    uint8_t         NewValueToShow      = 0;
-    /* High and Low number digit*/
-    uint8_t         digitLow, digitHigh;
-    for ( ;; )
-    {
-        /* Check if new number is received*/
-        if(xQueueReceive(xDisplayMailbox, &NewValueToShow, 0) == pdTRUE){
-            /* If there is new number to show on display, split it on High and Low digit */
-            /* Extract high digit*/
-            digitHigh = NewValueToShow/10;
-            /* Extract low digit*/
-            digitLow = NewValueToShow - digitHigh*10;
-        }
-        HAL_7SEG_DISPLAY_1_ON;
-        HAL_7SEG_DISPLAY_2_OFF;
-        vHAL7SEGWriteDigit(digitLow);
-        vTaskDelay(5);
-        HAL_7SEG_DISPLAY_2_ON;
-        HAL_7SEG_DISPLAY_1_OFF;
-        vHAL7SEGWriteDigit(digitHigh);
-        vTaskDelay(5);
-    }
-}
-
 /**
  * @brief "ADC Task" Function
  *
- * This task start ADC conversion or change ADC channel wich depends on
- * notification value
+ * This task receives buffers of ADC frames. Both channels are sampled in
+ * every frame so only the newest frame is kept for Button task.
  */
 static void prvADCTaskFunction( void *pvParameters )
 {
-    uint32_t    notifyValue;
-    uint8_t     channel      = 1;
+    ADCFrames_t     frames;
+    uint8_t         ucStartError;
+    /* Frame rate must be reachable by Timer B0 from SMCLK */
+    ucStartError = vHALADCStart(configCPU_CLOCK_HZ, mainADC_FRAME_RATE, xADCTaskHandle);
+    configASSERT( ucStartError == 0 );
     for ( ;; )
     {
-       /* Waits for notification value */
-       xTaskNotifyWait(ULONG_MAX, ULONG_MAX, &notifyValue, portMAX_DELAY);
-       /* Check if notification bit value, defined with mainADC_TAKE_SAMPLE mask, is set*/
-       if((notifyValue & mainADC_TAKE_SAMPLE) != 0){
-           ADC12CTL0 |= ADC12SC;
-       }
-       /* Check if notification bit value, defined with mainADC_CHANGE_CHANEL mask, is set*/
-       if((notifyValue & mainADC_CHANGE_CHANEL) != 0){
-           /* Determine what is next channel */
-           channel        = channel == 1 ? 0 : 1;
-           /* Change ADC12 periphery channel */
-           ADC12CTL0      &=~ ADC12ENC;
-           switch(channel){
-           case 0:
-
-               ADC12MCTL0     &=~ ADC12INCH_1;
-               ADC12MCTL0     |= ADC12INCH_0;
-               xTaskNotifyGive(xDIODETaskHandle);
-               break;
-           case 1:
-               ADC12MCTL0     &=~ ADC12INCH_0;
-               ADC12MCTL0     |= ADC12INCH_1;
-               xTaskNotifyGive(xDIODETaskHandle);
-               break;
-           }
-           ADC12CTL0      |= ADC12ENC;
-       }
+        /* Waits for next full buffer */
+        if(vHALADCWaitFrames(&frames, portMAX_DELAY) != 0) continue;
+        /* Keep the last frame of the buffer */
+        taskENTER_CRITICAL();
+        xLatestFrame = HAL_ADC_FRAME(&frames, ADCFrame_t, frames.usFrameCount - 1);
+        taskEXIT_CRITICAL();
     }
 }
 /**
  * @brief "Button Task" Function
  *
- * This task waits for ISR notification
+ * This task waits for debounced button events. S3 shows newest sample of
+ * selected channel and S4 selects the other channel. Both channels are
+ * always converted so changing channel does not touch ADC12.
  */
 static void prvButtonTaskFunction( void *pvParameters )
 {
-    uint16_t i;
-    /*Initial button states are 1 because of pull-up configuration*/
-    uint8_t         currentButtonState  = 1;
+    uint32_t        events;
+    uint8_t         channel             = 1;
+    uint8_t         valueToShow;
+    vHALButtonSubscribe(xButtonTaskHandle,
+                        HAL_BUTTON_BIT(HAL_BUTTON_S3, HAL_BUTTON_EVENT_PRESS) |
+                        HAL_BUTTON_BIT(HAL_BUTTON_S4, HAL_BUTTON_EVENT_PRESS));
     for ( ;; )
     {
-        /* Wait for notification from ISR*/
-        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
-        /*wait for a little to check that button is still pressed*/
-        for(i = 0; i < 1000; i++);
-        /* check if button SW3 is pressed*/
-        currentButtonState = ((P1IN & 0x10) >> 4);
-        if(currentButtonState == 0){
-            /* If S3 is pressed set ADC task notification value bit defined
-             * with mainADC_TAKE_SAMPLE mask */
-            xTaskNotify(xADCTaskHandle, mainADC_TAKE_SAMPLE, eSetBits);
-            continue;
+        /* Wait for button events, sent to the HAL drivers' notification*/
+        xTaskNotifyWaitIndexed(HAL_BUTTON_NOTIFY_INDEX, 0, ULONG_MAX, &events, portMAX_DELAY);
+        if((events & HAL_BUTTON_BIT(HAL_BUTTON_S3, HAL_BUTTON_EVENT_PRESS)) != 0){
+            /* If S3 is pressed scale newest sample of selected channel
+             * to fit on two digits representation and show it on display */
+            taskENTER_CRITICAL();
+            valueToShow = (channel == 0 ? xLatestFrame.usChannel0 : xLatestFrame.usChannel1) >> 6;
+            taskEXIT_CRITICAL();
+            vHAL7SEGSetNumber(valueToShow);
         }
-        /* check if button S4 is pressed*/
-        currentButtonState = ((P1IN & 0x20) >> 5);
-        if(currentButtonState == 0){
-            /* If S4 is pressed set ADC task notification value bit defined
-             * with mainADC_CHANGE_CHANEL mask */
-            xTaskNotify(xADCTaskHandle, mainADC_CHANGE_CHANEL, eSetBits);
-            continue;
+        if((events & HAL_BUTTON_BIT(HAL_BUTTON_S4, HAL_BUTTON_EVENT_PRESS)) != 0){
+            /* If S4 is pressed select the other channel */
+            channel        = channel == 1 ? 0 : 1;
+            if(xDIODECoRoutineHandle != NULL) xCoRoutineNotifyGive(xDIODECoRoutineHandle);
         }
     }
 }
@@ -192,13 +155,6 @@ void main( void )
     prvSetupHardware();
 
     /* Create tasks */
-    xTaskCreate( prvDisplayTaskFunction,
-                 "Display Task",
-                 configMINIMAL_STACK_SIZE,
-                 NULL,
-                 mainDISPLAY_TASK_PRIO,
-                 NULL
-               );
     xTaskCreate( prvADCTaskFunction,
                  "ADC Task",
                  configMINIMAL_STACK_SIZE,
@@ -213,15 +169,11 @@ void main( void )
                  mainBUTTON_TASK_PRIO,
                  &xButtonTaskHandle
                );
-    xTaskCreate( prvDiodeControlTaskFunction,
-                 "Diode Task",
-                 configMINIMAL_STACK_SIZE,
-                 NULL,
-                 mainBUTTON_TASK_PRIO,
-                 &xDIODETaskHandle
-               );
-    /* Create FreeRTOS objects  */
-    xDisplayMailbox       =   xQueueCreate(mainDISPLAY_QUEUE_LENGTH,sizeof(uint8_t));
+    /* Diode control needs no stack, it runs as co-routine */
+    xCoRoutineCreate( prvDiodeControlCoRoutine,
+                      mainDIODE_CO_ROUTINE_PRIO,
+                      0
+                    );
     /* Start the scheduler. */
     vTaskStartScheduler();
 
@@ -244,78 +196,25 @@ static void prvSetupHardware( void )
 
     hal430SetSystemClock( configCPU_CLOCK_HZ, configLFXT_CLOCK_HZ );
 
-    /* - Init buttons - */
-    /*Set direction to input*/
-    P1DIR &= ~0x30;
-    /*Enable pull-up resistor*/
-    P1REN |= 0x30;
-    P1OUT |= 0x30;
-    /*Enable interrupt for pin connected to SW3*/
-    P1IE  |= 0x30;
-    P1IFG &=~0x30;
-    /*Interrupt is generated during high to low transition*/
-    P1IES |= 0x30;
+    /* Init buttons, debouncing runs on a software timer */
+    vHALButtonInit();
 
-    /*Initialize ADC */
-    ADC12CTL0      = ADC12SHT02 + ADC12ON;       // Sampling time, ADC12 on
-    ADC12CTL1      = ADC12SHP;                   // Use sampling timer
-    ADC12IE        = 0x01;                       // Enable interrupt
-    ADC12MCTL0     |= ADC12INCH_1;
-    ADC12CTL0      |= ADC12ENC;
-    P6SEL          |= 0x03;                      // P6.0 and P6.1 ADC option select
+    /*Initialize ADC, channel list is configured once */
+    vHALADCInit(pucADCChannels, mainADC_CHANNEL_COUNT, mainADC_FRAMES_PER_BUFFER, pusADCBuffers);
 
     /* initialize LEDs */
     vHALInitLED();
-    /* initialize display*/
+    /* initialize display and refresh it from timer interrupt*/
     vHAL7SEGInit();
+    vHAL7SEGStartRefresh();
     /*enable global interrupts*/
     taskENABLE_INTERRUPTS();
 }
-void __attribute__ ( ( interrupt( ADC12_VECTOR  ) ) ) vADC12ISR( void )
-{
-    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    uint16_t    temp;
-    switch(__even_in_range(ADC12IV,34))
-    {
-        case  0: break;                           // Vector  0:  No interrupt
-        case  2: break;                           // Vector  2:  ADC overflow
-        case  4: break;                           // Vector  4:  ADC timing overflow
-        case  6:                                  // Vector  6:  ADC12IFG0
-            /* Scaling ADC value to fit on two digits representation*/
-            temp    = ADC12MEM0>>6;
-            xQueueSendToBackFromISR(xDisplayMailbox,&temp,&xHigherPriorityTaskWoken);
-            break;
-        case  8:                                  // Vector  8:  ADC12IFG1
-            break;
-        case 10: break;                           // Vector 10:  ADC12IFG2
-        case 12: break;                           // Vector 12:  ADC12IFG3
-        case 14: break;                           // Vector 14:  ADC12IFG4
-        case 16: break;                           // Vector 16:  ADC12IFG5
-        case 18: break;                           // Vector 18:  ADC12IFG6
-        case 20: break;                           // Vector 20:  ADC12IFG7
-        case 22: break;                           // Vector 22:  ADC12IFG8
-        case 24: break;                           // Vector 24:  ADC12IFG9
-        case 26: break;                           // Vector 26:  ADC12IFG10
-        case 28: break;                           // Vector 28:  ADC12IFG11
-        case 30: break;                           // Vector 30:  ADC12IFG12
-        case 32: break;                           // Vector 32:  ADC12IFG13
-        case 34: break;                           // Vector 34:  ADC12IFG14
-        default: break;
-    }
-    /* trigger scheduler if higher priority task is woken */
-    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
-}
 void __attribute__ ( ( interrupt( PORT1_VECTOR  ) ) ) vPORT1ISR( void )
 {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    /* Notify Button task that one of the button is pressed*/
-    /* Note: This check is not truly necessary but it is good to
-     * have it*/
-    if(((P1IFG & 0x10) == 0x10) || ((P1IFG & 0x20) == 0x20)){
-        vTaskNotifyGiveFromISR(xButtonTaskHandle, &xHigherPriorityTaskWoken);
-    }
-    /*Clear IFG register on exit. Read more about it in offical MSP430F5529 documentation*/
-    P1IFG &=~0x30;
+    /* Button HAL starts debouncing and clears IFG*/
+    vHALButtonISR(&xHigherPriorityTaskWoken);
     /* trigger scheduler if higher priority task is woken */
     portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
 }
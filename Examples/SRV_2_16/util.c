@@ -15,6 +15,7 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "timers.h"
+#include "croutine.h"
 
 /* Hardware includes. */
 #include "msp430.h"
@@ -27,7 +28,7 @@
  */
 void vApplicationTickHook( void )
 {
-    ;
+    vHALLPMTickHook();
 }
 
 /**
@@ -74,8 +75,10 @@ void vApplicationSetupTimerInterrupt( void )
 void vApplicationIdleHook( void )
 {
     /* Called on each iteration of the idle task.  In this case the idle task
-    just enters a low(ish) power mode. */
-    __bis_SR_register( LPM0_bits + GIE );
+    runs a ready co-routine, then enters the deepest low power mode that
+    active peripherals and the next task wake up allow. */
+    vCoRoutineSchedule();
+    vHALLPMIdleHook();
 }
 
 /**
@@ -33,14 +33,16 @@ static uint8_t              data;
 /**
  * @brief Task 1 function
  *
- * This task implements 2 digit 7seg multiplexing functionality
- *
+ * This task implements 2 digit 7seg multiplexing functionality, each
+ * display is refreshed every 10 ms
  */
 static void prvTask1Function( void *pvParameters )
 {
     hal_7seg_display_t xCurrentActiveDisplay = HAL_DISPLAY_1;
     uint8_t xSecondDigit     = data / 10;
     uint8_t xFirstDigit    = data - xSecondDigit*10;
+    /* Displays are switched without drift, flicker does not depend on load */
+    TickType_t xLastRelease = xTaskGetTickCount();
     for ( ;; )
     {
         switch(xCurrentActiveDisplay){
@@ -65,7 +67,7 @@ static void prvTask1Function( void *pvParameters )
                 xCurrentActiveDisplay = HAL_DISPLAY_1;
                 break;
         }
-        vTaskDelay( pdMS_TO_TICKS(5) );
+        xTaskWaitForNextRelease( &xLastRelease, pdMS_TO_TICKS(5) );
     }
 }
 /**
@@ -10,6 +10,100 @@
 #include "hal_7seg.h"
 #include "msp430.h"
 
+/*Segments of a glyph*/
+#define prvSEG_A                        0x01
+#define prvSEG_B                        0x02
+#define prvSEG_C                        0x04
+#define prvSEG_D                        0x08
+#define prvSEG_E                        0x10
+#define prvSEG_F                        0x20
+#define prvSEG_G                        0x40
+
+/*Bit of segment in given port if segment is on that port and selected by segments*/
+#define prvSEG_BITS(segments, seg, port) \
+    ((HAL_7SEG_SEGMENT_##seg##_PORT == (port) && ((segments) & prvSEG_##seg)) ? HAL_7SEG_SEGMENT_##seg##_MASK : 0)
+#define prvPORT_BITS(segments, port) \
+    (prvSEG_BITS(segments, A, port) | prvSEG_BITS(segments, B, port) | prvSEG_BITS(segments, C, port) | \
+     prvSEG_BITS(segments, D, port) | prvSEG_BITS(segments, E, port) | prvSEG_BITS(segments, F, port) | \
+     prvSEG_BITS(segments, G, port))
+/*All segment bits of a port*/
+#define prvPORT_MASK(port)              prvPORT_BITS(0x7F, port)
+/*Segments are active low, so bits of segments that are off are set*/
+#define prvGLYPH(segments)              { prvPORT_BITS(~(segments), 2), prvPORT_BITS(~(segments), 3), \
+                                          prvPORT_BITS(~(segments), 4), prvPORT_BITS(~(segments), 8) }
+
+/*Port output values of one glyph*/
+typedef struct{
+    uint8_t ucPort2;
+    uint8_t ucPort3;
+    uint8_t ucPort4;
+    uint8_t ucPort8;
+}hal_7seg_glyph_t;
+
+static const hal_7seg_glyph_t xGlyphs[HAL_7SEG_GLYPH_COUNT] = {
+    prvGLYPH(prvSEG_A | prvSEG_B | prvSEG_C | prvSEG_D | prvSEG_E | prvSEG_F),             /*0*/
+    prvGLYPH(prvSEG_B | prvSEG_C),                                                         /*1*/
+    prvGLYPH(prvSEG_A | prvSEG_B | prvSEG_D | prvSEG_E | prvSEG_G),                        /*2*/
+    prvGLYPH(prvSEG_A | prvSEG_B | prvSEG_C | prvSEG_D | prvSEG_G),                        /*3*/
+    prvGLYPH(prvSEG_B | prvSEG_C | prvSEG_F | prvSEG_G),                                   /*4*/
+    prvGLYPH(prvSEG_A | prvSEG_C | prvSEG_D | prvSEG_F | prvSEG_G),                        /*5*/
+    prvGLYPH(prvSEG_A | prvSEG_C | prvSEG_D | prvSEG_E | prvSEG_F | prvSEG_G),             /*6*/
+    prvGLYPH(prvSEG_A | prvSEG_B | prvSEG_C),                                              /*7*/
+    prvGLYPH(prvSEG_A | prvSEG_B | prvSEG_C | prvSEG_D | prvSEG_E | prvSEG_F | prvSEG_G),  /*8*/
+    prvGLYPH(prvSEG_A | prvSEG_B | prvSEG_C | prvSEG_F | prvSEG_G),                        /*9*/
+    prvGLYPH(prvSEG_A | prvSEG_B | prvSEG_C | prvSEG_E | prvSEG_F | prvSEG_G),             /*A*/
+    prvGLYPH(prvSEG_C | prvSEG_D | prvSEG_E | prvSEG_F | prvSEG_G),                        /*b*/
+    prvGLYPH(prvSEG_A | prvSEG_D | prvSEG_E | prvSEG_F),                                   /*C*/
+    prvGLYPH(prvSEG_B | prvSEG_C | prvSEG_D | prvSEG_E | prvSEG_G),                        /*d*/
+    prvGLYPH(prvSEG_A | prvSEG_D | prvSEG_E | prvSEG_F | prvSEG_G),                        /*E*/
+    prvGLYPH(prvSEG_A | prvSEG_E | prvSEG_F | prvSEG_G),                                   /*F*/
+    prvGLYPH(0),                                                                           /*Blank*/
+    prvGLYPH(prvSEG_G),                                                                    /*-*/
+    prvGLYPH(prvSEG_D),                                                                    /*_*/
+    prvGLYPH(prvSEG_A | prvSEG_B | prvSEG_F | prvSEG_G),                                   /*Degree*/
+    prvGLYPH(prvSEG_B | prvSEG_C | prvSEG_E | prvSEG_F | prvSEG_G),                        /*H*/
+    prvGLYPH(prvSEG_D | prvSEG_E | prvSEG_F),                                              /*L*/
+    prvGLYPH(prvSEG_A | prvSEG_B | prvSEG_E | prvSEG_F | prvSEG_G)                         /*P*/
+};
+
+/*Display enable outputs, least significant display first*/
+static volatile uint8_t* const  pucDisplayOut[HAL_7SEG_DISPLAY_COUNT]   = HAL_7SEG_DISPLAY_OUT_LIST;
+static const uint8_t            ucDisplayMask[HAL_7SEG_DISPLAY_COUNT]   = HAL_7SEG_DISPLAY_MASK_LIST;
+/*Glyphs for every display, refresh interrupt shows one image while the other is written*/
+static volatile uint8_t ucImage[2][HAL_7SEG_DISPLAY_COUNT];
+/*Last complete image and image shown in current refresh cycle*/
+static volatile uint8_t ucReadyImage;
+static volatile uint8_t ucShownImage;
+static uint8_t          ucActiveDisplay;
+/*Timer ticks every display stays on in one refresh slot*/
+static uint16_t         usOnTicks[HAL_7SEG_DISPLAY_COUNT];
+static uint8_t          ucBlanked;
+
+/*Timer ticks in one display slot*/
+#define prvREFRESH_PERIOD               (HAL_7SEG_REFRESH_CLOCK_HZ / HAL_7SEG_REFRESH_RATE_HZ)
+
+static void prvDisplaysOff(){
+    uint8_t i;
+    for(i = 0; i < HAL_7SEG_DISPLAY_COUNT; i++){
+        *pucDisplayOut[i] |= ucDisplayMask[i];
+    }
+}
+
+static void prvSetImage(const uint8_t* glyphs){
+    unsigned short  interruptState;
+    uint8_t         image;
+    uint8_t         i;
+    /*Short section so refresh interrupt can not start showing the image being written*/
+    interruptState = __get_interrupt_state();
+    __disable_interrupt();
+    image = ucShownImage ^ 1;
+    for(i = 0; i < HAL_7SEG_DISPLAY_COUNT; i++){
+        ucImage[image][i] = glyphs[i];
+    }
+    ucReadyImage = image;
+    __set_interrupt_state(interruptState);
+}
+
 void vHAL7SEGInit(){
     /*Init segment a*/
     HAL_7SEG_DISPLAY_1_DIR |=   HAL_7SEG_DISPLAY_1_MASK;
@@ -24,103 +118,147 @@ void vHAL7SEGInit(){
 }
 
 uint8_t vHAL7SEGWriteDigit(uint8_t digit){
-    switch(digit){
-        case 0:
-            HAL_7SEG_SEGMENT_A_ON;
-            HAL_7SEG_SEGMENT_B_ON;
-            HAL_7SEG_SEGMENT_C_ON;
-            HAL_7SEG_SEGMENT_D_ON;
-            HAL_7SEG_SEGMENT_E_ON;
-            HAL_7SEG_SEGMENT_F_ON;
-            HAL_7SEG_SEGMENT_G_OFF;
-            break;
-        case 1:
-            HAL_7SEG_SEGMENT_A_OFF;
-            HAL_7SEG_SEGMENT_B_ON;
-            HAL_7SEG_SEGMENT_C_ON;
-            HAL_7SEG_SEGMENT_D_OFF;
-            HAL_7SEG_SEGMENT_E_OFF;
-            HAL_7SEG_SEGMENT_F_OFF;
-            HAL_7SEG_SEGMENT_G_OFF;
-            break;
-        case 2:
-            HAL_7SEG_SEGMENT_A_ON;
-            HAL_7SEG_SEGMENT_B_ON;
-            HAL_7SEG_SEGMENT_C_OFF;
-            HAL_7SEG_SEGMENT_D_ON;
-            HAL_7SEG_SEGMENT_E_ON;
-            HAL_7SEG_SEGMENT_F_OFF;
-            HAL_7SEG_SEGMENT_G_ON;
-            break;
-        case 3:
-            HAL_7SEG_SEGMENT_A_ON;
-            HAL_7SEG_SEGMENT_B_ON;
-            HAL_7SEG_SEGMENT_C_ON;
-            HAL_7SEG_SEGMENT_D_ON;
-            HAL_7SEG_SEGMENT_E_OFF;
-            HAL_7SEG_SEGMENT_F_OFF;
-            HAL_7SEG_SEGMENT_G_ON;
-            break;
-        case 4:
-            HAL_7SEG_SEGMENT_A_OFF;
-            HAL_7SEG_SEGMENT_B_ON;
-            HAL_7SEG_SEGMENT_C_ON;
-            HAL_7SEG_SEGMENT_D_OFF;
-            HAL_7SEG_SEGMENT_E_OFF;
-            HAL_7SEG_SEGMENT_F_ON;
-            HAL_7SEG_SEGMENT_G_ON;
-            break;
-        case 5:
-            HAL_7SEG_SEGMENT_A_ON;
-            HAL_7SEG_SEGMENT_B_OFF;
-            HAL_7SEG_SEGMENT_C_ON;
-            HAL_7SEG_SEGMENT_D_ON;
-            HAL_7SEG_SEGMENT_E_OFF;
-            HAL_7SEG_SEGMENT_F_ON;
-            HAL_7SEG_SEGMENT_G_ON;
-            break;
-        case 6:
-            HAL_7SEG_SEGMENT_A_ON;
-            HAL_7SEG_SEGMENT_B_OFF;
-            HAL_7SEG_SEGMENT_C_ON;
-            HAL_7SEG_SEGMENT_D_ON;
-            HAL_7SEG_SEGMENT_E_ON;
-            HAL_7SEG_SEGMENT_F_ON;
-            HAL_7SEG_SEGMENT_G_ON;
-            break;
-        case 7:
-            HAL_7SEG_SEGMENT_A_ON;
-            HAL_7SEG_SEGMENT_B_ON;
-            HAL_7SEG_SEGMENT_C_ON;
-            HAL_7SEG_SEGMENT_D_OFF;
-            HAL_7SEG_SEGMENT_E_OFF;
-            HAL_7SEG_SEGMENT_F_OFF;
-            HAL_7SEG_SEGMENT_G_OFF;
-            break;
-        case 8:
-            HAL_7SEG_SEGMENT_A_ON;
-            HAL_7SEG_SEGMENT_B_ON;
-            HAL_7SEG_SEGMENT_C_ON;
-            HAL_7SEG_SEGMENT_D_ON;
-            HAL_7SEG_SEGMENT_E_ON;
-            HAL_7SEG_SEGMENT_F_ON;
-            HAL_7SEG_SEGMENT_G_ON;
-            break;
-        case 9:
-            HAL_7SEG_SEGMENT_A_ON;
-            HAL_7SEG_SEGMENT_B_ON;
-            HAL_7SEG_SEGMENT_C_ON;
-            HAL_7SEG_SEGMENT_D_OFF;
-            HAL_7SEG_SEGMENT_E_OFF;
-            HAL_7SEG_SEGMENT_F_ON;
-            HAL_7SEG_SEGMENT_G_ON;
-            break;
-        default:
-            return 1;
+    const hal_7seg_glyph_t* glyph;
+    if(digit >= HAL_7SEG_GLYPH_COUNT) return 1;
+    glyph   = &xGlyphs[digit];
+    P2OUT   = (P2OUT & ~prvPORT_MASK(2)) | glyph->ucPort2;
+    P3OUT   = (P3OUT & ~prvPORT_MASK(3)) | glyph->ucPort3;
+    P4OUT   = (P4OUT & ~prvPORT_MASK(4)) | glyph->ucPort4;
+    P8OUT   = (P8OUT & ~prvPORT_MASK(8)) | glyph->ucPort8;
+    return 0;
+}
+
+void vHAL7SEGStartRefresh(){
+    uint8_t i;
+    for(i = 0; i < HAL_7SEG_DISPLAY_COUNT; i++){
+        usOnTicks[i] = prvREFRESH_PERIOD;
     }
+    ucBlanked           = 0;
+    ucActiveDisplay     = HAL_7SEG_DISPLAY_COUNT - 1;
+    TA1CCR0             = prvREFRESH_PERIOD - 1;
+    TA1CCTL0            = CCIE;
+    TA1CCTL1            = 0;
+    TA1CTL              = TASSEL_1 + MC_1 + TACLR;          // ACLK, up mode
+}
+
+uint8_t vHAL7SEGSetBrightness(uint8_t display, uint8_t duty){
+    if(display >= HAL_7SEG_DISPLAY_COUNT || duty > 100) return 1;
+    usOnTicks[display] = (uint16_t)((uint32_t)prvREFRESH_PERIOD * duty / 100);
     return 0;
 }
 
+void vHAL7SEGBlank(uint8_t blank){
+    if(blank){
+        /*Timer and segment current are both stopped*/
+        TA1CTL      = MC_0;
+        prvDisplaysOff();
+        vHAL7SEGWriteDigit(HAL_7SEG_GLYPH_BLANK);
+        ucBlanked   = 1;
+    }else if(ucBlanked){
+        ucBlanked   = 0;
+        TA1CTL      = TASSEL_1 + MC_1 + TACLR;
+    }
+}
+
+uint8_t vHAL7SEGSetGlyphs(const uint8_t* glyphs){
+    uint8_t i;
+    for(i = 0; i < HAL_7SEG_DISPLAY_COUNT; i++){
+        if((glyphs[i] & ~HAL_7SEG_DECIMAL_POINT) >= HAL_7SEG_GLYPH_COUNT) return 1;
+    }
+    prvSetImage(glyphs);
+    return 0;
+}
+
+uint8_t vHAL7SEGSetNumber(uint16_t number){
+    uint8_t glyphs[HAL_7SEG_DISPLAY_COUNT];
+    uint8_t i;
+    for(i = 0; i < HAL_7SEG_DISPLAY_COUNT; i++){
+        glyphs[i]   = number % 10;
+        number     /= 10;
+    }
+    if(number != 0) return 1;
+    prvSetImage(glyphs);
+    return 0;
+}
+
+uint8_t vHAL7SEGSetDecimal(int16_t value, uint8_t decimals){
+    uint8_t     glyphs[HAL_7SEG_DISPLAY_COUNT];
+    uint16_t    magnitude   = value < 0 ? (uint16_t)(-(int32_t)value) : (uint16_t)value;
+    uint8_t     used        = 0;
+#ifndef HAL_7SEG_SEGMENT_DP_OUT
+    /*Without decimal point pin fraction can not be told apart from integer part*/
+    if(decimals != 0) return 1;
+#endif
+    /*Digits up to and including the one before decimal point are always shown*/
+    do{
+        if(used == HAL_7SEG_DISPLAY_COUNT) return 1;
+        glyphs[used++]  = magnitude % 10;
+        magnitude      /= 10;
+    }while(magnitude != 0 || used <= decimals);
+    if(value < 0){
+        if(used == HAL_7SEG_DISPLAY_COUNT) return 1;
+        glyphs[used++]  = HAL_7SEG_GLYPH_MINUS;
+    }
+    while(used < HAL_7SEG_DISPLAY_COUNT){
+        glyphs[used++]  = HAL_7SEG_GLYPH_BLANK;
+    }
+    if(decimals != 0){
+        glyphs[decimals] |= HAL_7SEG_DECIMAL_POINT;
+    }
+    prvSetImage(glyphs);
+    return 0;
+}
 
+uint8_t vHAL7SEGSetHex(uint16_t value){
+    uint8_t glyphs[HAL_7SEG_DISPLAY_COUNT];
+    uint8_t i;
+    for(i = 0; i < HAL_7SEG_DISPLAY_COUNT; i++){
+        glyphs[i]   = value & 0x0F;
+        value     >>= 4;
+    }
+    if(value != 0) return 1;
+    prvSetImage(glyphs);
+    return 0;
+}
 
+void __attribute__ ( ( interrupt( TIMER1_A0_VECTOR ) ) ) vHAL7SEGRefreshISR( void )
+{
+    uint8_t glyph;
+    /*Displays are off while segments change*/
+    prvDisplaysOff();
+    if(++ucActiveDisplay == HAL_7SEG_DISPLAY_COUNT){
+        /*Take new image only at the beginning of refresh cycle*/
+        ucActiveDisplay = 0;
+        ucShownImage    = ucReadyImage;
+    }
+    glyph = ucImage[ucShownImage][ucActiveDisplay];
+    vHAL7SEGWriteDigit(glyph & ~HAL_7SEG_DECIMAL_POINT);
+#ifdef HAL_7SEG_SEGMENT_DP_OUT
+    if(glyph & HAL_7SEG_DECIMAL_POINT){
+        HAL_7SEG_SEGMENT_DP_OUT &=~ HAL_7SEG_SEGMENT_DP_MASK;
+    }else{
+        HAL_7SEG_SEGMENT_DP_OUT |=  HAL_7SEG_SEGMENT_DP_MASK;
+    }
+#endif
+    if(usOnTicks[ucActiveDisplay] == 0) return;
+    *pucDisplayOut[ucActiveDisplay] &= ~ucDisplayMask[ucActiveDisplay];
+    /*CCR1 turns display off before the end of slot when it is dimmed*/
+    if(usOnTicks[ucActiveDisplay] < prvREFRESH_PERIOD){
+        TA1CCR1     = usOnTicks[ucActiveDisplay];
+        TA1CCTL1    = CCIE;
+    }else{
+        TA1CCTL1    = 0;
+    }
+}
 
+void __attribute__ ( ( interrupt( TIMER1_A1_VECTOR ) ) ) vHAL7SEGDimISR( void )
+{
+    switch(__even_in_range(TA1IV,14))
+    {
+        case  0: break;                           // Vector  0:  No interrupt
+        case  2:                                  // Vector  2:  TA1CCR1, end of on time
+            prvDisplaysOff();
+            break;
+        default: break;
+    }
+}
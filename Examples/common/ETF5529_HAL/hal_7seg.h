@@ -5,6 +5,16 @@
  * @brief   7SEG DISPLAY API
  *
  * Helper functions for 7SEG Display management
+ *
+ * Displays can be multiplexed by the application with vHAL7SEGWriteDigit,
+ * or refreshed from Timer A1 interrupt after vHAL7SEGStartRefresh. In the
+ * second case vHAL7SEGSet* functions only write the image that interrupt
+ * shows, so no task has to wake up for refresh.
+ *
+ * Every display gets one slot of the refresh period. Timer A1 CCR0 starts
+ * the slot and CCR1 ends on time early for dimmed displays, so brightness
+ * costs two short interrupts per slot and no task time. Setters use
+ * integer arithmetic only, no printf.
  */
 
 
@@ -16,6 +26,14 @@
 /*Displays position inside of register*/
 #define HAL_7SEG_DISPLAY_1_MASK          0x10
 #define HAL_7SEG_DISPLAY_2_MASK          0x01
+/*Number of multiplexed displays and their enable outputs, least significant display first*/
+#define HAL_7SEG_DISPLAY_COUNT           2
+#define HAL_7SEG_DISPLAY_OUT_LIST        { &HAL_7SEG_DISPLAY_1_OUT, &HAL_7SEG_DISPLAY_2_OUT }
+#define HAL_7SEG_DISPLAY_MASK_LIST       { HAL_7SEG_DISPLAY_1_MASK, HAL_7SEG_DISPLAY_2_MASK }
+/*Refresh timer runs from ACLK*/
+#define HAL_7SEG_REFRESH_CLOCK_HZ        32768
+/*Switches to next display per second*/
+#define HAL_7SEG_REFRESH_RATE_HZ         200
 /*Segments position inside of registers*/
 #define HAL_7SEG_SEGMENT_A_MASK          0x80
 #define HAL_7SEG_SEGMENT_B_MASK          0x08
@@ -50,6 +68,15 @@
 #define HAL_7SEG_SEGMENT_F_OUT          P4OUT
 #define HAL_7SEG_SEGMENT_G_OUT          P8OUT
 
+/*Segments port numbers, used to build glyph table at compile time*/
+#define HAL_7SEG_SEGMENT_A_PORT         3
+#define HAL_7SEG_SEGMENT_B_PORT         4
+#define HAL_7SEG_SEGMENT_C_PORT         2
+#define HAL_7SEG_SEGMENT_D_PORT         8
+#define HAL_7SEG_SEGMENT_E_PORT         2
+#define HAL_7SEG_SEGMENT_F_PORT         4
+#define HAL_7SEG_SEGMENT_G_PORT         8
+
 #define HAL_7SEG_SEGMENT_A_ON  HAL_7SEG_SEGMENT_A_OUT &=~ HAL_7SEG_SEGMENT_A_MASK
 #define HAL_7SEG_SEGMENT_B_ON  HAL_7SEG_SEGMENT_B_OUT &=~ HAL_7SEG_SEGMENT_B_MASK
 #define HAL_7SEG_SEGMENT_C_ON  HAL_7SEG_SEGMENT_C_OUT &=~ HAL_7SEG_SEGMENT_C_MASK
@@ -75,14 +102,42 @@
 
 
 
+/*Glyphs accepted by vHAL7SEGWriteDigit, 0-9 and 0xA-0xF are shown as hex digits*/
+#define HAL_7SEG_GLYPH_BLANK            16
+#define HAL_7SEG_GLYPH_MINUS            17
+#define HAL_7SEG_GLYPH_UNDERSCORE       18
+#define HAL_7SEG_GLYPH_DEGREE           19
+#define HAL_7SEG_GLYPH_H                20
+#define HAL_7SEG_GLYPH_L                21
+#define HAL_7SEG_GLYPH_P                22
+#define HAL_7SEG_GLYPH_COUNT            23
+/*Added to glyph passed to vHAL7SEGSetGlyphs to light decimal point, used only if
+ *HAL_7SEG_SEGMENT_DP_OUT and HAL_7SEG_SEGMENT_DP_MASK are defined for the board*/
+#define HAL_7SEG_DECIMAL_POINT          0x80
+
 typedef enum{
     HAL_DISPLAY_1 = 0,
     HAL_DISPLAY_2 = 1
 }hal_7seg_display_t;
 /*Init 7seg displays and segments*/
 void        vHAL7SEGInit();
-/*Write digit to previously enabled display*/
+/*Write digit or glyph to previously enabled display, returns 1 if there is no such glyph*/
 uint8_t     vHAL7SEGWriteDigit(uint8_t digit);
+/*Start refreshing displays from Timer A1 interrupt, all displays at full brightness*/
+void        vHAL7SEGStartRefresh();
+/*Part of refresh slot, 0-100 %, display is on, returns 1 if arguments are invalid*/
+uint8_t     vHAL7SEGSetBrightness(uint8_t display, uint8_t duty);
+/*Blank all displays and stop refresh timer, or resume refresh*/
+void        vHAL7SEGBlank(uint8_t blank);
+/*Show glyph on every display, least significant first, returns 1 if glyph does not exist*/
+uint8_t     vHAL7SEGSetGlyphs(const uint8_t* glyphs);
+/*Show number with leading zeros, returns 1 if it does not fit*/
+uint8_t     vHAL7SEGSetNumber(uint16_t number);
+/*Show signed value/10^decimals without leading zeros, returns 1 if it does not fit or
+ *decimals is not 0 and board has no decimal point pin (HAL_7SEG_SEGMENT_DP_OUT)*/
+uint8_t     vHAL7SEGSetDecimal(int16_t value, uint8_t decimals);
+/*Show value in hex with leading zeros, returns 1 if it does not fit*/
+uint8_t     vHAL7SEGSetHex(uint16_t value);
 
 
 #endif /* ETF5529_HAL_HAL_7SEG_H_ */
@@ -13,6 +13,13 @@ in order to use MSP-EXP430F5438 HAL.
 #include "hal_board.h"
 #include "hal_led.h"
 #include "hal_7seg.h"
+#include "hal_uart.h"
+#include "hal_adc.h"
+#include "hal_dsp.h"
+#include "hal_button.h"
+#include "hal_fll.h"
+#include "hal_dvfs.h"
+#include "hal_lpm.h"
 #include "../drivers/MSP430F5xx_6xx/pmm.h"
 #include "../drivers/MSP430F5xx_6xx/ucs.h"
 
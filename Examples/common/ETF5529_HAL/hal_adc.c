@@ -0,0 +1,160 @@
+/**
+ * @file    hal_adc.c
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   ADC API
+ *
+ * Timer triggered ADC12 sampling with DMA transfer into two buffers
+ */
+
+#include "hal_adc.h"
+#include "msp430.h"
+
+/*Largest Timer B0 input divider is ID_3 (8) times TBIDEX_7 (8)*/
+#define prvMAX_DIVIDER_SHIFT            6
+#define prvMAX_PERIOD                   65536UL
+
+static const uint16_t usInputDivider[4] = {ID_0, ID_1, ID_2, ID_3};
+
+/*Buffers handed to the consumer*/
+static uint16_t*        pusBuffers;
+/*Words in one buffer and in one sequence*/
+static uint16_t         usBufferLength;
+static uint16_t         usFramesPerBuffer;
+static uint16_t         usSequenceLength;
+static uint8_t          ucChannelCount;
+/*Buffer being filled and position of the next sequence in it*/
+static uint8_t          ucFillBuffer;
+static uint16_t         usFillOffset;
+static uint16_t         usOverruns;
+static TaskHandle_t     xConsumer;
+
+static void prvArmDMA(){
+    /*Source address is reloaded on every block, only destination changes*/
+    __data16_write_addr((unsigned short)&DMA0DA, (unsigned long)(pusBuffers + ucFillBuffer * usBufferLength + usFillOffset));
+    DMA0SZ      = usSequenceLength;
+    DMA0CTL    |= DMAEN;
+}
+
+uint8_t vHALADCInit(const uint8_t* channels, uint8_t channelCount, uint16_t framesPerBuffer, uint16_t* buffers){
+    volatile uint8_t*   memoryControl = &ADC12MCTL0;
+    uint8_t             framesPerSequence;
+    uint8_t             i;
+
+    if(channelCount == 0 || channelCount > HAL_ADC_MEMORY_COUNT) return 1;
+    framesPerSequence = HAL_ADC_FRAMES_PER_SEQUENCE(channelCount);
+    if(framesPerBuffer == 0 || framesPerBuffer % framesPerSequence != 0) return 1;
+
+    pusBuffers          = buffers;
+    ucChannelCount      = channelCount;
+    usSequenceLength    = channelCount * framesPerSequence;
+    usBufferLength      = channelCount * framesPerBuffer;
+    usFramesPerBuffer   = framesPerBuffer;
+
+    /*Channel list is repeated as many times as it fits in conversion memory*/
+    ADC12CTL0          &= ~ADC12ENC;
+    for(i = 0; i < usSequenceLength; i++){
+        memoryControl[i] = ADC12INCH_0 + channels[i % channelCount];
+        /*Analog function of input pins, A0-A7 are on P6, A12-A15 on P7*/
+        if(channels[i % channelCount] < 8){
+            P6SEL      |= 1 << channels[i % channelCount];
+        }else if(channels[i % channelCount] >= 12){
+            P7SEL      |= 1 << (channels[i % channelCount] - 12);
+        }
+    }
+    memoryControl[usSequenceLength - 1] |= ADC12EOS;
+
+    ADC12CTL0           = ADC12SHT0_2 + ADC12ON;                        // Sampling time, ADC12 on, one conversion per trigger
+    ADC12CTL1           = ADC12SHS_3 + ADC12SHP + ADC12CONSEQ_3;         // Trigger from TB0.1, repeat-sequence
+    ADC12IE             = 0;                                            // Results are moved by DMA
+
+    DMACTL0             = DMA0TSEL_24;                                  // DMA0 trigger is end of ADC12 sequence
+    DMA0CTL             = DMADT_1 + DMASRCINCR_3 + DMADSTINCR_3 + DMAIE; // Block transfer of words
+    __data16_write_addr((unsigned short)&DMA0SA, (unsigned long)&ADC12MEM0);
+    return 0;
+}
+
+uint8_t vHALADCStart(uint32_t smclkHz, uint32_t frameRate, TaskHandle_t consumer){
+    uint32_t    period;
+    uint8_t     shift = 0;
+
+    if(ucChannelCount == 0 || frameRate == 0) return 1;
+    /*One conversion per period, SMCLK is divided until the period fits*/
+    period = smclkHz / ucChannelCount / frameRate;
+    while((period >> shift) > prvMAX_PERIOD && shift < prvMAX_DIVIDER_SHIFT){
+        shift++;
+    }
+    period >>= shift;
+    /*Up mode needs TB0CCR0 above TB0CCR1 above 0*/
+    if(period < 2 || period > prvMAX_PERIOD) return 1;
+
+    xConsumer           = consumer;
+    ucFillBuffer        = 0;
+    usFillOffset        = 0;
+    usOverruns          = 0;
+    prvArmDMA();
+    ADC12CTL0          |= ADC12ENC;
+
+    /*Rising edge of TB0.1 in the middle of every period triggers one conversion*/
+    TB0CCR0             = (uint16_t)(period - 1);
+    TB0CCR1             = (uint16_t)(period / 2);
+    TB0CCTL1            = OUTMOD_3;                                     // Set/reset
+    /*Divider is 2^shift, ID_x takes up to 8 and TBIDEX_x the rest*/
+    TB0EX0              = (1 << (shift > 3 ? shift - 3 : 0)) - 1;
+    TB0CTL              = TBSSEL_2 + MC_1 + TBCLR + usInputDivider[shift > 3 ? 3 : shift];    // SMCLK / 2^shift, up mode
+    return 0;
+}
+
+void vHALADCStop(){
+    TB0CTL              = MC_0;
+    ADC12CTL0          &= ~ADC12ENC;
+    DMA0CTL            &= ~DMAEN;
+}
+
+uint16_t* pusHALADCWaitBuffer(TickType_t timeout){
+    uint32_t buffer;
+    if(xTaskNotifyWaitIndexed(HAL_ADC_NOTIFY_INDEX, 0, 0xFFFFFFFF, &buffer, timeout) != pdTRUE){
+        return NULL;
+    }
+    /*Notification value is the buffer index plus one*/
+    return pusBuffers + (buffer - 1) * usBufferLength;
+}
+
+uint8_t vHALADCWaitFrames(ADCFrames_t* frames, TickType_t timeout){
+    uint16_t* buffer = pusHALADCWaitBuffer(timeout);
+    if(buffer == NULL) return 1;
+    frames->pusSamples      = buffer;
+    frames->usFrameCount    = usFramesPerBuffer;
+    frames->ucChannelCount  = ucChannelCount;
+    return 0;
+}
+
+uint16_t usHALADCGetOverruns(){
+    return usOverruns;
+}
+
+void __attribute__ ( ( interrupt( DMA_VECTOR ) ) ) vHALADCDMAISR( void )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    switch(__even_in_range(DMAIV,16))
+    {
+        case  0: break;                           // Vector  0:  No interrupt
+        case  2:                                  // Vector  2:  DMA0IFG, one sequence transferred
+            usFillOffset += usSequenceLength;
+            if(usFillOffset >= usBufferLength){
+                /*Buffer is full, hand it over and continue in the other one*/
+                if(xTaskNotifyIndexedFromISR(xConsumer, HAL_ADC_NOTIFY_INDEX, ucFillBuffer + 1, eSetValueWithoutOverwrite, &xHigherPriorityTaskWoken) != pdPASS){
+                    /*Previous buffer was not taken, consumer gets the newest one*/
+                    usOverruns++;
+                    xTaskNotifyIndexedFromISR(xConsumer, HAL_ADC_NOTIFY_INDEX, ucFillBuffer + 1, eSetValueWithOverwrite, &xHigherPriorityTaskWoken);
+                }
+                ucFillBuffer ^= 1;
+                usFillOffset  = 0;
+            }
+            prvArmDMA();
+            break;
+        default: break;
+    }
+    /* trigger scheduler if higher priority task is woken */
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
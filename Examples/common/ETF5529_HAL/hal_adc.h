@@ -0,0 +1,79 @@
+/**
+ * @file    hal_adc.h
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   ADC API
+ *
+ * Timer triggered ADC12 sampling with DMA transfer into two buffers.
+ *
+ * Timer B0 output 1 triggers one conversion per period and ADC12 converts
+ * the channel list in repeat-sequence mode. At the end of every sequence
+ * DMA channel 0 copies the results into the buffer being filled, so the CPU
+ * only re-arms the DMA once per sequence. When a buffer is full the
+ * consumer task is notified and filling continues in the other buffer.
+ *
+ * Buffer holds framesPerBuffer frames, one frame is one sample of every
+ * channel in channel list order. Buffer returned by pusHALADCWaitBuffer
+ * stays valid while the other buffer is filled. Consumer task's
+ * notification at HAL_ADC_NOTIFY_INDEX is used by this module. With at least
+ * three configTASK_NOTIFICATION_ARRAY_ENTRIES it is the one before the last,
+ * which hal_button uses, otherwise the last, so with more than one entry the
+ * application keeps the default notification for itself. With more than one
+ * entry it must differ from HAL_BUTTON_NOTIFY_INDEX (see hal_button.h).
+ *
+ * Channel list is written to conversion memory once in vHALADCInit, so all
+ * channels are sampled in every frame and switching between them costs no
+ * reconfiguration. vHALADCWaitFrames hands a buffer over as ADCFrames_t,
+ * frames can then be read as structures with one uint16_t member per
+ * channel using HAL_ADC_FRAME.
+ */
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#ifndef HAL_ADC_H_
+#define HAL_ADC_H_
+
+/*Notification of consumer task used to hand over buffers*/
+#ifndef HAL_ADC_NOTIFY_INDEX
+#if configTASK_NOTIFICATION_ARRAY_ENTRIES >= 3
+#define HAL_ADC_NOTIFY_INDEX            (configTASK_NOTIFICATION_ARRAY_ENTRIES - 2)
+#else
+#define HAL_ADC_NOTIFY_INDEX            (configTASK_NOTIFICATION_ARRAY_ENTRIES - 1)
+#endif
+#endif
+#if (configTASK_NOTIFICATION_ARRAY_ENTRIES > 1) && defined(HAL_BUTTON_NOTIFY_INDEX) && (HAL_ADC_NOTIFY_INDEX == HAL_BUTTON_NOTIFY_INDEX)
+#error HAL_ADC_NOTIFY_INDEX and HAL_BUTTON_NOTIFY_INDEX are the same, set configTASK_NOTIFICATION_ARRAY_ENTRIES to 3 or define one of them
+#endif
+
+/*Number of ADC12 conversion memory registers*/
+#define HAL_ADC_MEMORY_COUNT            16
+/*Frames converted by one sequence for given number of channels*/
+#define HAL_ADC_FRAMES_PER_SEQUENCE(channelCount)   (HAL_ADC_MEMORY_COUNT / (channelCount))
+/*Words needed for both buffers*/
+#define HAL_ADC_BUFFERS_SIZE(channelCount, framesPerBuffer) (2 * (channelCount) * (framesPerBuffer))
+/*Frame with given index as structure type with one uint16_t member per channel*/
+#define HAL_ADC_FRAME(frames, type, index)  (((const type*)(frames)->pusSamples)[index])
+
+/*Full buffer handed over to consumer*/
+typedef struct{
+    const uint16_t* pusSamples;     /*Frames one after another, samples in channel list order*/
+    uint16_t        usFrameCount;
+    uint8_t         ucChannelCount;
+}ADCFrames_t;
+
+/*Init ADC12, DMA and Timer B0, framesPerBuffer must be multiple of frames per sequence, returns 1 if configuration is invalid*/
+uint8_t     vHALADCInit(const uint8_t* channels, uint8_t channelCount, uint16_t framesPerBuffer, uint16_t* buffers);
+/*Start sampling with frameRate frames per second, consumer is notified when buffer is full, returns 1 if
+  ADC is not initialized or frameRate is 0 or out of Timer B0 range (SMCLK / 64 / 65536 up to SMCLK / 2 conversions per second)*/
+uint8_t     vHALADCStart(uint32_t smclkHz, uint32_t frameRate, TaskHandle_t consumer);
+/*Stop sampling*/
+void        vHALADCStop();
+/*Wait for next full buffer, returns NULL on timeout*/
+uint16_t*   pusHALADCWaitBuffer(TickType_t timeout);
+/*Wait for next full buffer as frames, returns 1 on timeout*/
+uint8_t     vHALADCWaitFrames(ADCFrames_t* frames, TickType_t timeout);
+/*Number of full buffers the consumer did not take before the next one was full*/
+uint16_t    usHALADCGetOverruns();
+
+#endif /* HAL_ADC_H_ */
@@ -69,6 +69,7 @@ void hal430SetSystemClock(unsigned long req_clock_rate, unsigned long ref_clock_
       PMM_setVCore(PMMCOREV_3);
   }
 
-  //Set the DCO
-  UCS_initFLLSettle( ( unsigned short )ulCPU_Clock_KHz, req_clock_rate / ref_clock_rate );
+  //Set the DCO, calibration is restored from information memory if present
+  vHALFLLInit( ( unsigned short )ulCPU_Clock_KHz, req_clock_rate / ref_clock_rate );
+  vHALFLLSettle();
 }
@@ -0,0 +1,118 @@
+/**
+ * @file    hal_button.c
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   BUTTON API
+ *
+ * Debounced buttons S2, S3 and S4 on port 1
+ */
+
+#include "hal_button.h"
+#include "msp430.h"
+#include "timers.h"
+
+#define prvLONG_SAMPLES                 (HAL_BUTTON_LONG_MS / HAL_BUTTON_SAMPLE_MS)
+#define prvREPEAT_SAMPLES               (HAL_BUTTON_REPEAT_MS / HAL_BUTTON_SAMPLE_MS)
+
+typedef struct{
+    uint8_t     ucIntegrator;           /*0 released, HAL_BUTTON_DEBOUNCE_SAMPLES pressed*/
+    uint8_t     ucPressed;
+    uint16_t    usHeld;                 /*Samples since press*/
+}hal_button_t;
+
+typedef struct{
+    TaskHandle_t    xTask;
+    uint32_t        ulEvents;
+}hal_button_subscriber_t;
+
+static const uint8_t            ucButtonMask[HAL_BUTTON_COUNT] = {HAL_BUTTON_S2_MASK, HAL_BUTTON_S3_MASK, HAL_BUTTON_S4_MASK};
+static hal_button_t             xButtons[HAL_BUTTON_COUNT];
+static hal_button_subscriber_t  xSubscribers[HAL_BUTTON_MAX_SUBSCRIBERS];
+static uint8_t                  ucSubscriberCount;
+static TimerHandle_t            xDebounceTimer;
+
+static void prvDebounceTimerCallback(TimerHandle_t xTimer){
+    uint8_t         input   = P1IN;
+    uint8_t         idle    = 1;
+    uint32_t        events  = 0;
+    uint8_t         i;
+    hal_button_t*   button;
+
+    for(i = 0; i < HAL_BUTTON_COUNT; i++){
+        button = &xButtons[i];
+        /*Buttons are active low*/
+        if((input & ucButtonMask[i]) == 0){
+            if(button->ucIntegrator < HAL_BUTTON_DEBOUNCE_SAMPLES) button->ucIntegrator++;
+        }else{
+            if(button->ucIntegrator > 0) button->ucIntegrator--;
+        }
+        if(!button->ucPressed && button->ucIntegrator == HAL_BUTTON_DEBOUNCE_SAMPLES){
+            button->ucPressed   = 1;
+            button->usHeld      = 0;
+            events             |= HAL_BUTTON_BIT(i, HAL_BUTTON_EVENT_PRESS);
+        }else if(button->ucPressed && button->ucIntegrator == 0){
+            button->ucPressed   = 0;
+            events             |= HAL_BUTTON_BIT(i, HAL_BUTTON_EVENT_RELEASE);
+        }else if(button->ucPressed){
+            button->usHeld++;
+            if(button->usHeld == prvLONG_SAMPLES){
+                events         |= HAL_BUTTON_BIT(i, HAL_BUTTON_EVENT_LONG);
+            }else if(button->usHeld == prvLONG_SAMPLES + prvREPEAT_SAMPLES){
+                /*Counter stays bounded while button is held*/
+                button->usHeld  = prvLONG_SAMPLES;
+                events         |= HAL_BUTTON_BIT(i, HAL_BUTTON_EVENT_REPEAT);
+            }
+        }
+        if(button->ucIntegrator != 0) idle = 0;
+    }
+
+    for(i = 0; i < ucSubscriberCount; i++){
+        if((events & xSubscribers[i].ulEvents) != 0){
+            xTaskNotifyIndexed(xSubscribers[i].xTask, HAL_BUTTON_NOTIFY_INDEX, events & xSubscribers[i].ulEvents, eSetBits);
+        }
+    }
+
+    if(idle){
+        /*Edges that came meanwhile are still pending and restart debouncing*/
+        xTimerStop(xTimer, 0);
+        P1IE   |= HAL_BUTTON_ALL_MASK;
+    }
+}
+
+uint8_t vHALButtonInit(){
+    xDebounceTimer = xTimerCreate("Button", pdMS_TO_TICKS(HAL_BUTTON_SAMPLE_MS), pdTRUE, NULL, prvDebounceTimerCallback);
+    if(xDebounceTimer == NULL) return 1;
+    /*Inputs with pull-up, interrupt on high to low transition*/
+    P1DIR  &= ~HAL_BUTTON_ALL_MASK;
+    P1REN  |= HAL_BUTTON_ALL_MASK;
+    P1OUT  |= HAL_BUTTON_ALL_MASK;
+    P1IES  |= HAL_BUTTON_ALL_MASK;
+    P1IFG  &= ~HAL_BUTTON_ALL_MASK;
+    P1IE   |= HAL_BUTTON_ALL_MASK;
+    return 0;
+}
+
+uint8_t vHALButtonSubscribe(TaskHandle_t task, uint32_t events){
+    uint8_t status = 1;
+    taskENTER_CRITICAL();
+    if(ucSubscriberCount < HAL_BUTTON_MAX_SUBSCRIBERS){
+        xSubscribers[ucSubscriberCount].xTask       = task;
+        xSubscribers[ucSubscriberCount].ulEvents    = events;
+        ucSubscriberCount++;
+        status = 0;
+    }
+    taskEXIT_CRITICAL();
+    return status;
+}
+
+void vHALButtonISR(BaseType_t* pxHigherPriorityTaskWoken){
+    if((P1IFG & P1IE & HAL_BUTTON_ALL_MASK) != 0){
+        /*Bounces are ignored until all buttons settle*/
+        P1IE   &= ~HAL_BUTTON_ALL_MASK;
+        P1IFG  &= ~HAL_BUTTON_ALL_MASK;
+        if(xTimerStartFromISR(xDebounceTimer, pxHigherPriorityTaskWoken) != pdPASS){
+            /*Timer command queue is full, wait for next edge*/
+            P1IE   |= HAL_BUTTON_ALL_MASK;
+        }
+    }
+}
@@ -0,0 +1,76 @@
+/**
+ * @file    hal_button.h
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   BUTTON API
+ *
+ * Debounced buttons S2, S3 and S4 on port 1.
+ *
+ * First edge on any button disables button interrupts and starts a
+ * software timer that samples the buttons every HAL_BUTTON_SAMPLE_MS.
+ * Every button has an integrator that counts up while the button is low
+ * and down while it is high, state changes when integrator reaches one of
+ * its ends. When all buttons are released and settled, timer stops and
+ * interrupts are enabled again, so idle buttons cost nothing.
+ *
+ * Events are sent to subscribed tasks as notification bits (eSetBits) of
+ * notification HAL_BUTTON_NOTIFY_INDEX, HAL_BUTTON_BIT gives the bit of an
+ * event of a button. Subscriber waits with xTaskNotifyWaitIndexed on that
+ * index. Default index is the last of configTASK_NOTIFICATION_ARRAY_ENTRIES
+ * and hal_adc takes the one before it, so with three entries index 0 stays
+ * with the application and every driver has its own. With more than one
+ * entry the two indices must differ, otherwise a task that consumes both
+ * would lose events, so two entries do not compile unless one index is
+ * defined. With one entry everything shares the default notification.
+ * Application's PORT1 interrupt has to call vHALButtonISR.
+ */
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#ifndef HAL_BUTTON_H_
+#define HAL_BUTTON_H_
+
+/*Notification of subscribed tasks that receives events*/
+#ifndef HAL_BUTTON_NOTIFY_INDEX
+#define HAL_BUTTON_NOTIFY_INDEX         (configTASK_NOTIFICATION_ARRAY_ENTRIES - 1)
+#endif
+#if (configTASK_NOTIFICATION_ARRAY_ENTRIES > 1) && defined(HAL_ADC_NOTIFY_INDEX) && (HAL_ADC_NOTIFY_INDEX == HAL_BUTTON_NOTIFY_INDEX)
+#error HAL_BUTTON_NOTIFY_INDEX and HAL_ADC_NOTIFY_INDEX are the same, set configTASK_NOTIFICATION_ARRAY_ENTRIES to 3 or define one of them
+#endif
+
+/*Buttons*/
+#define HAL_BUTTON_S2                   0
+#define HAL_BUTTON_S3                   1
+#define HAL_BUTTON_S4                   2
+#define HAL_BUTTON_COUNT                3
+/*Buttons position inside of port 1 registers*/
+#define HAL_BUTTON_S2_MASK              0x02
+#define HAL_BUTTON_S3_MASK              0x10
+#define HAL_BUTTON_S4_MASK              0x20
+#define HAL_BUTTON_ALL_MASK             (HAL_BUTTON_S2_MASK | HAL_BUTTON_S3_MASK | HAL_BUTTON_S4_MASK)
+
+/*Events*/
+#define HAL_BUTTON_EVENT_PRESS          0x01
+#define HAL_BUTTON_EVENT_RELEASE        0x02
+#define HAL_BUTTON_EVENT_LONG           0x04    /*Button held for HAL_BUTTON_LONG_MS*/
+#define HAL_BUTTON_EVENT_REPEAT         0x08    /*Every HAL_BUTTON_REPEAT_MS after long press*/
+/*Notification bit of event of button*/
+#define HAL_BUTTON_BIT(button, event)   ((uint32_t)(event) << ((button) * 4))
+
+/*Timing*/
+#define HAL_BUTTON_SAMPLE_MS            5
+#define HAL_BUTTON_DEBOUNCE_SAMPLES     4
+#define HAL_BUTTON_LONG_MS              1000
+#define HAL_BUTTON_REPEAT_MS            200
+
+#define HAL_BUTTON_MAX_SUBSCRIBERS      4
+
+/*Init buttons and debounce timer, returns 1 if timer can not be created*/
+uint8_t     vHALButtonInit();
+/*Send events selected by mask of HAL_BUTTON_BIT values to task, returns 1 if there is no free slot*/
+uint8_t     vHALButtonSubscribe(TaskHandle_t task, uint32_t events);
+/*Call from PORT1 interrupt*/
+void        vHALButtonISR(BaseType_t* pxHigherPriorityTaskWoken);
+
+#endif /* HAL_BUTTON_H_ */
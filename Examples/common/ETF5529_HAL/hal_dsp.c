@@ -0,0 +1,181 @@
+/**
+ * @file    hal_dsp.c
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   DSP API
+ *
+ * Fixed-point (Q15) filters for blocks of ADC samples
+ */
+
+#include "hal_dsp.h"
+#include "msp430.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+void vHALDSPFromADC(const uint16_t* in, q15_t* out, uint16_t count, uint8_t stride){
+    uint16_t i;
+    for(i = 0; i < count; i++){
+        out[i] = HAL_DSP_ADC_TO_Q15(in[i * stride]);
+    }
+}
+
+uint8_t vHALDSPMovingAverageInit(DSPMovingAverage_t* filter, q15_t* history, uint8_t length){
+    uint8_t i;
+    if(length == 0) return 1;
+    for(i = 0; i < length; i++){
+        history[i] = 0;
+    }
+    filter->pxHistory   = history;
+    filter->lSum        = 0;
+    filter->xScale      = length == 1 ? 32767 : (q15_t)(32768UL / length);
+    filter->ucLength    = length;
+    filter->ucIndex     = 0;
+    return 0;
+}
+
+void vHALDSPMovingAverage(DSPMovingAverage_t* filter, const q15_t* in, q15_t* out, uint16_t count){
+    uint16_t    i;
+    int32_t     sum     = filter->lSum;
+    uint8_t     index   = filter->ucIndex;
+    q15_t       sample;
+
+    taskENTER_CRITICAL();
+    for(i = 0; i < count; i++){
+        sample                      = in[i];
+        sum                        += sample - filter->pxHistory[index];
+        filter->pxHistory[index]    = sample;
+        if(++index == filter->ucLength) index = 0;
+        /*32x16 signed multiply, Q15 result is bits 15..30 of the product*/
+        MPYS32L = (uint16_t)sum;
+        MPYS32H = (uint16_t)(sum >> 16);
+        OP2     = filter->xScale;
+        out[i]  = (q15_t)((RES1 << 1) | (RES0 >> 15));
+    }
+    taskEXIT_CRITICAL();
+
+    filter->lSum    = sum;
+    filter->ucIndex = index;
+}
+
+uint8_t vHALDSPIIRInit(DSPIIR_t* filter, q15_t alpha){
+    if(alpha <= 0) return 1;
+    filter->xAlpha      = alpha;
+    filter->xBeta       = (q15_t)(32768L - alpha);
+    filter->xOutput     = 0;
+    filter->usRemainder = 0x4000;
+    return 0;
+}
+
+void vHALDSPIIR(DSPIIR_t* filter, const q15_t* in, q15_t* out, uint16_t count){
+    uint16_t    i;
+    q15_t       y           = filter->xOutput;
+    uint16_t    remainder   = filter->usRemainder;
+
+    taskENTER_CRITICAL();
+    for(i = 0; i < count; i++){
+        /*Accumulate alpha * x + beta * y on top of truncated bits of previous
+         *output, so small steps are not lost and output reaches the input*/
+        RESLO       = remainder;
+        RESHI       = 0;
+        MACS        = filter->xAlpha;
+        OP2         = in[i];
+        MACS        = filter->xBeta;
+        OP2         = y;
+        remainder   = RESLO;
+        y           = (q15_t)((RESHI << 1) | (remainder >> 15));
+        remainder  &= 0x7FFF;
+        out[i]      = y;
+    }
+    taskEXIT_CRITICAL();
+
+    filter->xOutput     = y;
+    filter->usRemainder = remainder;
+}
+
+uint8_t vHALDSPCICInit(DSPCIC_t* filter, uint8_t order, uint8_t rateLog2){
+    uint8_t i;
+    /*Integrators grow by order * rateLog2 bits over 16 bit input*/
+    if(order == 0 || order > HAL_DSP_CIC_MAX_ORDER || order * rateLog2 > 16) return 1;
+    for(i = 0; i < HAL_DSP_CIC_MAX_ORDER; i++){
+        filter->ulIntegrator[i] = 0;
+        filter->ulCombDelay[i]  = 0;
+    }
+    filter->ucOrder     = order;
+    filter->ucRateLog2  = rateLog2;
+    filter->ucShift     = order * rateLog2;
+    filter->usPhase     = 0;
+    return 0;
+}
+
+uint16_t usHALDSPCIC(DSPCIC_t* filter, const q15_t* in, q15_t* out, uint16_t count){
+    uint16_t    i;
+    uint16_t    written = 0;
+    uint16_t    mask    = (1 << filter->ucRateLog2) - 1;
+    uint8_t     stage;
+    uint32_t    value;
+    uint32_t    delayed;
+
+    for(i = 0; i < count; i++){
+        /*Integrators run at input rate, wrap around is cancelled by combs*/
+        value = (uint32_t)(int32_t)in[i];
+        for(stage = 0; stage < filter->ucOrder; stage++){
+            filter->ulIntegrator[stage] += value;
+            value                        = filter->ulIntegrator[stage];
+        }
+        filter->usPhase = (filter->usPhase + 1) & mask;
+        if(filter->usPhase != 0) continue;
+        /*Combs run at output rate*/
+        for(stage = 0; stage < filter->ucOrder; stage++){
+            delayed                     = filter->ulCombDelay[stage];
+            filter->ulCombDelay[stage]  = value;
+            value                      -= delayed;
+        }
+        out[written++] = (q15_t)((int32_t)value >> filter->ucShift);
+    }
+    return written;
+}
+
+uint8_t vHALDSPMedianInit(DSPMedian_t* filter, q15_t* history, q15_t* sorted, uint8_t length){
+    uint8_t i;
+    if((length & 1) == 0) return 1;
+    for(i = 0; i < length; i++){
+        history[i]  = 0;
+        sorted[i]   = 0;
+    }
+    filter->pxHistory   = history;
+    filter->pxSorted    = sorted;
+    filter->ucLength    = length;
+    filter->ucIndex     = 0;
+    return 0;
+}
+
+void vHALDSPMedian(DSPMedian_t* filter, const q15_t* in, q15_t* out, uint16_t count){
+    uint16_t    i;
+    uint8_t     position;
+    q15_t       oldest;
+    q15_t       sample;
+    q15_t*      sorted  = filter->pxSorted;
+    uint8_t     last    = filter->ucLength - 1;
+
+    for(i = 0; i < count; i++){
+        sample                              = in[i];
+        oldest                              = filter->pxHistory[filter->ucIndex];
+        filter->pxHistory[filter->ucIndex]  = sample;
+        if(++filter->ucIndex == filter->ucLength) filter->ucIndex = 0;
+
+        /*Find oldest sample in sorted array*/
+        position = 0;
+        while(sorted[position] != oldest) position++;
+        /*Replace it with new sample and move it to keep array sorted*/
+        while(position > 0 && sorted[position - 1] > sample){
+            sorted[position] = sorted[position - 1];
+            position--;
+        }
+        while(position < last && sorted[position + 1] < sample){
+            sorted[position] = sorted[position + 1];
+            position++;
+        }
+        sorted[position] = sample;
+        out[i] = sorted[last / 2];
+    }
+}
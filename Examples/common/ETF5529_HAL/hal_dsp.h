@@ -0,0 +1,94 @@
+/**
+ * @file    hal_dsp.h
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   DSP API
+ *
+ * Fixed-point (Q15) filters for blocks of ADC samples.
+ *
+ * Every filter keeps its state in a structure initialized once and then
+ * processes whole blocks, so it can be called on buffers returned by
+ * hal_adc. Multiplications are done on the hardware multiplier (MPY32).
+ * Multiplier registers are not part of task context so filters that use
+ * it run a block with interrupts disabled; keep blocks short if interrupt
+ * latency matters.
+ *
+ * In place processing (in == out) is allowed for every filter.
+ */
+
+#include <stdint.h>
+#ifndef HAL_DSP_H_
+#define HAL_DSP_H_
+
+/*Signed fractional number in range [-1, 1)*/
+typedef int16_t     q15_t;
+
+/*Q15 constant from number in range [-1, 1]*/
+#define HAL_DSP_Q15(x)                  ((q15_t)((x) >= 1.0 ? 32767 : (x) * 32768.0))
+/*12-bit ADC12 result to Q15, mid scale is 0*/
+#define HAL_DSP_ADC_TO_Q15(sample)      ((q15_t)(((int16_t)(sample) - 2048) << 4))
+/*Q15 back to 12-bit ADC12 scale*/
+#define HAL_DSP_Q15_TO_ADC(value)       ((uint16_t)(((value) >> 4) + 2048))
+
+/*Maximal CIC order*/
+#define HAL_DSP_CIC_MAX_ORDER           4
+
+/*Moving average of last N samples*/
+typedef struct{
+    q15_t*      pxHistory;          /*Last N input samples*/
+    int32_t     lSum;               /*Sum of samples in history*/
+    q15_t       xScale;             /*1/N*/
+    uint8_t     ucLength;
+    uint8_t     ucIndex;
+}DSPMovingAverage_t;
+
+/*Single pole IIR, y = alpha * x + (1 - alpha) * y*/
+typedef struct{
+    q15_t       xAlpha;
+    q15_t       xBeta;              /*1 - alpha*/
+    q15_t       xOutput;
+    uint16_t    usRemainder;        /*Product bits below output LSB, carried to next sample*/
+}DSPIIR_t;
+
+/*Decimating CIC with differential delay of one*/
+typedef struct{
+    uint32_t    ulIntegrator[HAL_DSP_CIC_MAX_ORDER];
+    uint32_t    ulCombDelay[HAL_DSP_CIC_MAX_ORDER];
+    uint8_t     ucOrder;
+    uint8_t     ucRateLog2;         /*Decimation rate is 2^ucRateLog2*/
+    uint8_t     ucShift;            /*Gain of order * ucRateLog2 bits*/
+    uint16_t    usPhase;
+}DSPCIC_t;
+
+/*Median of last N samples, N odd*/
+typedef struct{
+    q15_t*      pxHistory;          /*Last N input samples in arrival order*/
+    q15_t*      pxSorted;           /*Same samples sorted*/
+    uint8_t     ucLength;
+    uint8_t     ucIndex;
+}DSPMedian_t;
+
+/*Convert every stride-th ADC12 result to Q15, stride is channel count for hal_adc frames*/
+void        vHALDSPFromADC(const uint16_t* in, q15_t* out, uint16_t count, uint8_t stride);
+
+/*Init moving average, history holds length samples, returns 1 if length is 0*/
+uint8_t     vHALDSPMovingAverageInit(DSPMovingAverage_t* filter, q15_t* history, uint8_t length);
+/*Filter count samples*/
+void        vHALDSPMovingAverage(DSPMovingAverage_t* filter, const q15_t* in, q15_t* out, uint16_t count);
+
+/*Init IIR, returns 1 if alpha is not positive*/
+uint8_t     vHALDSPIIRInit(DSPIIR_t* filter, q15_t alpha);
+/*Filter count samples*/
+void        vHALDSPIIR(DSPIIR_t* filter, const q15_t* in, q15_t* out, uint16_t count);
+
+/*Init CIC, returns 1 if order is too big or gain does not fit in 32 bits*/
+uint8_t     vHALDSPCICInit(DSPCIC_t* filter, uint8_t order, uint8_t rateLog2);
+/*Filter count samples, returns number of samples written to out*/
+uint16_t    usHALDSPCIC(DSPCIC_t* filter, const q15_t* in, q15_t* out, uint16_t count);
+
+/*Init median, history and sorted hold length samples, returns 1 if length is not odd*/
+uint8_t     vHALDSPMedianInit(DSPMedian_t* filter, q15_t* history, q15_t* sorted, uint8_t length);
+/*Filter count samples*/
+void        vHALDSPMedian(DSPMedian_t* filter, const q15_t* in, q15_t* out, uint16_t count);
+
+#endif /* HAL_DSP_H_ */
@@ -0,0 +1,138 @@
+/**
+ * @file    hal_dvfs.c
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   DVFS API
+ *
+ * Runtime core voltage and DCO frequency scaling
+ */
+
+#include "hal_dvfs.h"
+#include "hal_fll.h"
+#include "hal_uart.h"
+#include "msp430.h"
+#include "task.h"
+#include "../drivers/MSP430F5xx_6xx/pmm.h"
+
+typedef struct{
+    uint32_t    ulClockHz;
+    uint8_t     ucVCore;
+}hal_dvfs_point_t;
+
+/*Same VCore levels as hal430SetSystemClock uses*/
+static const hal_dvfs_point_t   xPoints[HAL_DVFS_POINT_COUNT] = {
+    {  1000000UL, PMMCOREV_0 },
+    {  8000000UL, PMMCOREV_0 },
+    { 12000000UL, PMMCOREV_1 },
+    { 25000000UL, PMMCOREV_3 }
+};
+
+static hal_dvfs_hook_t          xHook;
+static TaskHandle_t             xIdleTask;
+static volatile uint8_t         ucCurrentPoint;
+static volatile uint8_t         ucRequestedPoint;
+static volatile uint8_t         ucGovernor;
+static volatile uint8_t         ucLoad;
+static uint16_t                 usWindowTicks;
+static uint16_t                 usIdleTicks;
+
+/*Called with scheduler suspended so only one transition runs at a time*/
+static void prvApplyPoint(uint8_t point){
+    const hal_dvfs_point_t* next = &xPoints[point];
+    unsigned short          interruptState;
+
+    if(point == ucCurrentPoint) return;
+    /*Voltage goes up before frequency and down after it*/
+    if(next->ucVCore > (PMMCTL0 & PMMCOREV_3)){
+        PMM_setVCore(next->ucVCore);
+    }
+    interruptState = __get_interrupt_state();
+    __disable_interrupt();
+    vHALFLLInit((uint16_t)(next->ulClockHz / 1000), (uint16_t)(next->ulClockHz / configLFXT_CLOCK_HZ));
+    /*Tick from SMCLK has to keep its rate, ACLK tick is not affected*/
+    if((TA0CTL & TASSEL_3) == TASSEL_2){
+        TA0CCR0     = (uint16_t)((next->ulClockHz >> ((TA0CTL & ID_3) >> 6)) / configTICK_RATE_HZ);
+    }
+    ucCurrentPoint  = point;
+    __set_interrupt_state(interruptState);
+    vHALFLLSettle();
+    if(next->ucVCore < (PMMCTL0 & PMMCOREV_3)){
+        PMM_setVCore(next->ucVCore);
+    }
+    vHALUARTSetClock(next->ulClockHz);
+    if(xHook != NULL){
+        xHook(next->ulClockHz);
+    }
+}
+
+uint8_t vHALDVFSInit(uint8_t point, hal_dvfs_hook_t hook){
+    if(point >= HAL_DVFS_POINT_COUNT) return 1;
+    xHook               = hook;
+    /*Boot clock is not one of the points, force transition*/
+    ucCurrentPoint      = HAL_DVFS_POINT_COUNT;
+    prvApplyPoint(point);
+    ucRequestedPoint    = point;
+    usWindowTicks       = 0;
+    usIdleTicks         = 0;
+    ucGovernor          = 1;
+    return 0;
+}
+
+void vHALDVFSEnableGovernor(uint8_t enable){
+    ucRequestedPoint    = ucCurrentPoint;
+    ucGovernor          = enable;
+}
+
+uint8_t vHALDVFSSetPoint(uint8_t point){
+    if(point >= HAL_DVFS_POINT_COUNT) return 1;
+    vTaskSuspendAll();
+    prvApplyPoint(point);
+    ucRequestedPoint    = ucCurrentPoint;
+    xTaskResumeAll();
+    return 0;
+}
+
+uint32_t ulHALDVFSGetClock(){
+    return xPoints[ucCurrentPoint].ulClockHz;
+}
+
+uint8_t ucHALDVFSGetPoint(){
+    return ucCurrentPoint;
+}
+
+uint8_t ucHALDVFSGetLoad(){
+    return ucLoad;
+}
+
+void vHALDVFSTickHook(){
+    uint8_t point = ucCurrentPoint;
+
+    if(xIdleTask != NULL && xTaskGetCurrentTaskHandle() == xIdleTask){
+        usIdleTicks++;
+    }
+    if(++usWindowTicks < HAL_DVFS_WINDOW_TICKS) return;
+
+    ucLoad          = (uint8_t)(100 - (uint32_t)usIdleTicks * 100 / HAL_DVFS_WINDOW_TICKS);
+    usWindowTicks   = 0;
+    usIdleTicks     = 0;
+    /*Idle task is known after its first hook call*/
+    if(!ucGovernor || xIdleTask == NULL) return;
+    if(ucLoad > HAL_DVFS_UP_PERCENT && point < HAL_DVFS_POINT_COUNT - 1){
+        ucRequestedPoint = point + 1;
+    }else if(point > 0 &&
+             (uint32_t)ucLoad * (xPoints[point].ulClockHz / 1000) / (xPoints[point - 1].ulClockHz / 1000) < HAL_DVFS_DOWN_PERCENT){
+        /*Same work at lower frequency takes proportionally longer*/
+        ucRequestedPoint = point - 1;
+    }
+}
+
+void vHALDVFSIdleHook(){
+    if(xIdleTask == NULL){
+        xIdleTask = xTaskGetCurrentTaskHandle();
+    }
+    if(ucGovernor && ucRequestedPoint != ucCurrentPoint){
+        vTaskSuspendAll();
+        prvApplyPoint(ucRequestedPoint);
+        xTaskResumeAll();
+    }
+}
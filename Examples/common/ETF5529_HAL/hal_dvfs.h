@@ -0,0 +1,66 @@
+/**
+ * @file    hal_dvfs.h
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   DVFS API
+ *
+ * Runtime core voltage and DCO frequency scaling.
+ *
+ * Operating points are 1, 8, 12 and 25 MHz MCLK = SMCLK, each with the
+ * lowest VCore level that supports it. Load is sampled from the tick hook:
+ * a tick that interrupts the idle task counts as idle. After every window
+ * the governor moves one point up if load is above HAL_DVFS_UP_PERCENT,
+ * or one point down if the same work would still keep load below
+ * HAL_DVFS_DOWN_PERCENT at the lower point. The transition itself runs
+ * from the idle hook, when no task is ready.
+ *
+ * DCO is programmed through hal_fll, so a frequency that was calibrated
+ * before is restored from information memory instead of settling again.
+ * On every transition UART divider is recalculated, tick timer is
+ * retuned if it runs from SMCLK (ACLK tick needs nothing) and the
+ * application hook is called for other SMCLK users, for example ADC
+ * trigger timer.
+ *
+ * Usage: call vHALDVFSInit after hal430SetSystemClock, vHALDVFSTickHook
+ * from vApplicationTickHook and vHALDVFSIdleHook from vApplicationIdleHook
+ * before entering low power mode.
+ */
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#ifndef HAL_DVFS_H_
+#define HAL_DVFS_H_
+
+/*Operating points*/
+#define HAL_DVFS_POINT_1MHZ             0
+#define HAL_DVFS_POINT_8MHZ             1
+#define HAL_DVFS_POINT_12MHZ            2
+#define HAL_DVFS_POINT_25MHZ            3
+#define HAL_DVFS_POINT_COUNT            4
+
+/*Governor parameters*/
+#define HAL_DVFS_WINDOW_TICKS           500
+#define HAL_DVFS_UP_PERCENT             80
+#define HAL_DVFS_DOWN_PERCENT           50
+
+/*Called after every transition with new SMCLK frequency*/
+typedef void (*hal_dvfs_hook_t)(uint32_t smclkHz);
+
+/*Switch to given operating point and start governor, returns 1 if point does not exist*/
+uint8_t     vHALDVFSInit(uint8_t point, hal_dvfs_hook_t hook);
+/*Enable or disable governor, operating point stays as it is when disabled*/
+void        vHALDVFSEnableGovernor(uint8_t enable);
+/*Switch to given operating point from task context, returns 1 if point does not exist*/
+uint8_t     vHALDVFSSetPoint(uint8_t point);
+/*Current MCLK and SMCLK frequency*/
+uint32_t    ulHALDVFSGetClock();
+/*Current operating point*/
+uint8_t     ucHALDVFSGetPoint();
+/*Load in percent measured in last window*/
+uint8_t     ucHALDVFSGetLoad();
+/*Call from vApplicationTickHook*/
+void        vHALDVFSTickHook();
+/*Call from vApplicationIdleHook*/
+void        vHALDVFSIdleHook();
+
+#endif /* HAL_DVFS_H_ */
@@ -0,0 +1,185 @@
+/**
+ * @file    hal_fll.c
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   FLL API
+ *
+ * DCO start-up with FLL calibration cached in information memory
+ */
+
+#include <stddef.h>
+#include "hal_fll.h"
+#include "msp430.h"
+#include "../drivers/MSP430F5xx_6xx/ucs.h"
+
+#define prvDCO_TAP(ctl0)                (((ctl0) >> 8) & 0x1F)
+
+typedef struct{
+    uint16_t    usKHz;
+    uint16_t    usRatio;
+    uint16_t    usCTL0;                 /*DCO tap and modulation*/
+    uint16_t    usCTL1;                 /*DCO range*/
+    uint16_t    usCTL2;                 /*FLL divider and multiplier*/
+    uint16_t    usCheck;                /*Written last, torn entries never match*/
+}hal_fll_entry_t;
+
+#define prvENTRY_COUNT                  ((HAL_FLL_CACHE_SIZE - sizeof(uint16_t)) / sizeof(hal_fll_entry_t))
+
+typedef struct{
+    uint16_t        usMagic;
+    hal_fll_entry_t xEntries[prvENTRY_COUNT];
+}hal_fll_cache_t;
+
+static volatile hal_fll_cache_t* const  pxCache = (volatile hal_fll_cache_t*)HAL_FLL_CACHE_ADDRESS;
+static volatile hal_fll_entry_t*        pxRestored;
+static uint16_t                         usPendingKHz;
+static uint16_t                         usPendingRatio;
+
+#if HAL_FLL_USE_CACHE
+static uint16_t prvCheck(uint16_t kHz, uint16_t ratio, uint16_t ctl0, uint16_t ctl1, uint16_t ctl2){
+    return HAL_FLL_CACHE_MAGIC ^ kHz ^ ratio ^ ctl0 ^ ctl1 ^ ctl2;
+}
+
+/*Last stored entry wins, older ones are from other temperature or supply*/
+static volatile hal_fll_entry_t* prvFind(uint16_t kHz, uint16_t ratio){
+    volatile hal_fll_entry_t*   found = NULL;
+    volatile hal_fll_entry_t*   entry;
+    uint8_t                     i;
+
+    if(pxCache->usMagic != HAL_FLL_CACHE_MAGIC) return NULL;
+    for(i = 0; i < prvENTRY_COUNT; i++){
+        entry = &pxCache->xEntries[i];
+        if(entry->usKHz != kHz || entry->usRatio != ratio) continue;
+        if(entry->usCheck != prvCheck(kHz, ratio, entry->usCTL0, entry->usCTL1, entry->usCTL2)) continue;
+        found = entry;
+    }
+    return found;
+}
+
+static volatile hal_fll_entry_t* prvFreeSlot(){
+    volatile hal_fll_entry_t*   entry;
+    uint8_t                     i;
+
+    if(pxCache->usMagic != HAL_FLL_CACHE_MAGIC) return NULL;
+    for(i = 0; i < prvENTRY_COUNT; i++){
+        entry = &pxCache->xEntries[i];
+        if(entry->usKHz == 0xFFFF && entry->usRatio == 0xFFFF && entry->usCTL0 == 0xFFFF &&
+           entry->usCTL1 == 0xFFFF && entry->usCTL2 == 0xFFFF && entry->usCheck == 0xFFFF){
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void prvFlashWrite(volatile uint16_t* address, uint16_t value){
+    *address = value;
+    while(FCTL3 & BUSY);
+}
+
+static void prvStore(){
+    volatile hal_fll_entry_t*   entry   = prvFreeSlot();
+    uint16_t                    ctl0    = UCSCTL0;
+    uint16_t                    ctl1    = UCSCTL1;
+    uint16_t                    ctl2    = UCSCTL2;
+    unsigned short              interruptState;
+
+    /*Interrupts would run from flash while it is being erased or written*/
+    interruptState = __get_interrupt_state();
+    __disable_interrupt();
+    FCTL3 = FWKEY;                                      // Clear LOCK
+    if(entry == NULL){
+        FCTL1 = FWKEY + ERASE;
+        pxCache->usMagic = 0;                           // Dummy write starts segment erase
+        while(FCTL3 & BUSY);
+        FCTL1 = FWKEY + WRT;
+        prvFlashWrite(&pxCache->usMagic, HAL_FLL_CACHE_MAGIC);
+        entry = &pxCache->xEntries[0];
+    }else{
+        FCTL1 = FWKEY + WRT;
+    }
+    prvFlashWrite(&entry->usKHz, usPendingKHz);
+    prvFlashWrite(&entry->usRatio, usPendingRatio);
+    prvFlashWrite(&entry->usCTL0, ctl0);
+    prvFlashWrite(&entry->usCTL1, ctl1);
+    prvFlashWrite(&entry->usCTL2, ctl2);
+    prvFlashWrite(&entry->usCheck, prvCheck(usPendingKHz, usPendingRatio, ctl0, ctl1, ctl2));
+    FCTL1 = FWKEY;
+    FCTL3 = FWKEY + LOCK;
+    __set_interrupt_state(interruptState);
+}
+#endif
+
+uint8_t vHALFLLInit(uint16_t fsystem, uint16_t ratio){
+    uint16_t srRegisterState;
+
+    usPendingKHz    = fsystem;
+    usPendingRatio  = ratio;
+#if HAL_FLL_USE_CACHE
+    pxRestored      = prvFind(fsystem, ratio);
+#endif
+    if(pxRestored == NULL){
+        UCS_initFLL(fsystem, ratio);
+        return 1;
+    }
+
+    /*Same sequence as UCS_initFLL, with stored values instead of lowest tap*/
+    srRegisterState = __get_SR_register() & SCG0;
+    __bis_SR_register(SCG0);
+    UCSCTL1         = pxRestored->usCTL1;
+    UCSCTL2         = pxRestored->usCTL2;
+    UCSCTL0         = pxRestored->usCTL0;
+    __bic_SR_register(SCG0);
+    while(UCSCTL7 & DCOFFG){
+        UCSCTL7    &= ~DCOFFG;
+        SFRIFG1    &= ~OFIFG;
+    }
+    __bis_SR_register(srRegisterState);
+    UCSCTL4        &= ~(SELM_7 + SELS_7);
+    if(fsystem > 16000){
+        UCSCTL4    |= SELM__DCOCLK + SELS__DCOCLK;
+    }else{
+        UCSCTL4    |= SELM__DCOCLKDIV + SELS__DCOCLKDIV;
+    }
+    return 0;
+}
+
+uint8_t vHALFLLSettle(){
+    volatile uint16_t x;
+
+    if(pxRestored != NULL){
+        /*One reference period is about ratio MCLK cycles*/
+        x = usPendingRatio;
+        while(x--){
+            __delay_cycles(32);
+        }
+        if(!(UCSCTL7 & DCOFFG) &&
+           prvDCO_TAP(UCSCTL0) + 1 >= prvDCO_TAP(pxRestored->usCTL0) &&
+           prvDCO_TAP(UCSCTL0) <= prvDCO_TAP(pxRestored->usCTL0) + 1){
+            return 0;
+        }
+    }
+    /*Same wait as UCS_initFLLSettle*/
+    x = usPendingRatio * 32;
+    while(x--){
+        __delay_cycles(30);
+    }
+#if HAL_FLL_USE_CACHE
+    prvStore();
+#endif
+    return 1;
+}
+
+void vHALFLLInvalidateCache(){
+    unsigned short interruptState;
+
+    interruptState = __get_interrupt_state();
+    __disable_interrupt();
+    FCTL3 = FWKEY;
+    FCTL1 = FWKEY + ERASE;
+    pxCache->usMagic = 0;
+    while(FCTL3 & BUSY);
+    FCTL1 = FWKEY;
+    FCTL3 = FWKEY + LOCK;
+    __set_interrupt_state(interruptState);
+    pxRestored = NULL;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file    hal_fll.h
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   FLL API
+ *
+ * DCO start-up with FLL calibration cached in information memory.
+ *
+ * UCS_initFLLSettle starts DCO from its lowest tap and waits
+ * 32 * ratio * 30 cycles for FLL to lock, on every boot and every clock
+ * change. With the cache, converged UCSCTL0 (DCO tap and modulation),
+ * UCSCTL1 (DCO range) and UCSCTL2 (FLL divider and multiplier) are stored
+ * in information memory segment D for every frequency and ratio pair
+ * after the first full settle. Next time the registers are restored
+ * directly and FLL only has to confirm lock for 32 reference periods: DCO
+ * tap must stay within one step of the stored one. If it does not, for
+ * example because temperature or supply changed, the full settle follows
+ * and the new values are stored.
+ *
+ * Entries are appended to erased slots, segment is erased (up to 35 ms
+ * with CPU held) only when it is full or does not hold a cache yet.
+ * Erase and writes run with interrupts masked, so a full settle that
+ * stores an entry from vHALDVFS at run time can delay the tick and every
+ * other interrupt by that much. The cache is therefore off by default
+ * (plain UCS_initFLL behavior), set HAL_FLL_USE_CACHE to 1 where boot or
+ * clock change time matters more than interrupt latency.
+ *
+ * Usage: vHALFLLInit can be called with interrupts disabled, it only
+ * programs the registers. vHALFLLSettle waits for lock and stores the
+ * calibration, call it after interrupts are enabled again.
+ */
+
+#include <stdint.h>
+#ifndef HAL_FLL_H_
+#define HAL_FLL_H_
+
+#ifndef HAL_FLL_USE_CACHE
+#define HAL_FLL_USE_CACHE               0
+#endif
+
+/*Information memory segment D*/
+#define HAL_FLL_CACHE_ADDRESS           0x1800
+#define HAL_FLL_CACHE_SIZE              128
+#define HAL_FLL_CACHE_MAGIC             0xF11C
+
+/*Program DCO for fsystem kHz from FLL reference times ratio, returns 1 if there is no cached calibration*/
+uint8_t     vHALFLLInit(uint16_t fsystem, uint16_t ratio);
+/*Wait for lock after vHALFLLInit, returns 1 if full settle was needed*/
+uint8_t     vHALFLLSettle();
+/*Erase all cached calibrations*/
+void        vHALFLLInvalidateCache();
+
+#endif /* HAL_FLL_H_ */
@@ -0,0 +1,116 @@
+/**
+ * @file    hal_lpm.c
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   LPM API
+ *
+ * Idle governor that enters the deepest low power mode that is safe
+ */
+
+#include "hal_lpm.h"
+#include "msp430.h"
+#include "task.h"
+
+#define prvTIMER_RUNNING(ctl)           (((ctl) & MC_3) != 0)
+#define prvTIMER_CLOCK(ctl)             ((ctl) & TASSEL_3)
+
+static const uint16_t           usModeBits[HAL_LPM_MODE_COUNT] = {LPM0_bits, LPM3_bits, LPM4_bits};
+static TaskHandle_t             xIdleTask;
+static volatile uint8_t         ucDeepestMode = HAL_LPM_MODE_LPM3;
+static volatile uint8_t         ucLastMode;
+static volatile uint8_t         ucSleeping;
+static hal_lpm_residency_t      xResidency[HAL_LPM_MODE_COUNT];
+
+/*Peripherals that need SMCLK, DCO has to keep running*/
+static uint8_t prvSMCLKInUse(){
+    if(prvTIMER_RUNNING(TA0CTL) && prvTIMER_CLOCK(TA0CTL) == TASSEL_2) return 1;
+    if(prvTIMER_RUNNING(TA1CTL) && prvTIMER_CLOCK(TA1CTL) == TASSEL_2) return 1;
+    if(prvTIMER_RUNNING(TA2CTL) && prvTIMER_CLOCK(TA2CTL) == TASSEL_2) return 1;
+    if(prvTIMER_RUNNING(TB0CTL) && (TB0CTL & TBSSEL_3) == TBSSEL_2) return 1;
+    /*ADC12SSEL_2 is MCLK, ADC12SSEL_3 is SMCLK*/
+    if((ADC12CTL0 & ADC12ENC) && (ADC12CTL1 & ADC12SSEL_2)) return 1;
+    if(!(UCA1CTL1 & UCSWRST) && (UCA1CTL1 & UCSSEL_3) >= UCSSEL_2){
+        /*Start bit has to be sampled by a running clock*/
+        if((UCA1STAT & UCBUSY) || (UCA1IE & UCRXIE)) return 1;
+    }
+    return 0;
+}
+
+#if ( INCLUDE_xTaskGetTicksToNextUnblock == 1 )
+/*Peripherals other than the tick that need ACLK*/
+static uint8_t prvACLKInUse(){
+    if(prvTIMER_RUNNING(TA1CTL) && prvTIMER_CLOCK(TA1CTL) == TASSEL_1) return 1;
+    if(prvTIMER_RUNNING(TA2CTL) && prvTIMER_CLOCK(TA2CTL) == TASSEL_1) return 1;
+    if(prvTIMER_RUNNING(TB0CTL) && (TB0CTL & TBSSEL_3) == TBSSEL_1) return 1;
+    if((ADC12CTL0 & ADC12ENC) && (ADC12CTL1 & ADC12SSEL_3) == ADC12SSEL_1) return 1;
+    if(!(UCA1CTL1 & UCSWRST) && (UCA1CTL1 & UCSSEL_3) == UCSSEL_1) return 1;
+    return 0;
+}
+#endif
+
+static uint8_t prvChooseMode(){
+    uint8_t     mode = HAL_LPM_MODE_LPM3;
+#if ( INCLUDE_xTaskGetTicksToNextUnblock == 1 )
+    TickType_t  ticks = xTaskGetTicksToNextUnblock();
+
+    if(ticks < HAL_LPM_LPM3_MIN_TICKS) return HAL_LPM_MODE_LPM0;
+    /*Without the tick only an interrupt can wake a task*/
+    if(ticks == portMAX_DELAY && !prvACLKInUse()) mode = HAL_LPM_MODE_LPM4;
+#endif
+    if(prvSMCLKInUse()) return HAL_LPM_MODE_LPM0;
+    return mode < ucDeepestMode ? mode : ucDeepestMode;
+}
+
+uint8_t vHALLPMSetDeepestMode(uint8_t mode){
+    if(mode >= HAL_LPM_MODE_COUNT) return 1;
+    ucDeepestMode = mode;
+    return 0;
+}
+
+uint8_t ucHALLPMGetLastMode(){
+    return ucLastMode;
+}
+
+uint8_t vHALLPMGetResidency(uint8_t mode, hal_lpm_residency_t* residency){
+    if(mode >= HAL_LPM_MODE_COUNT) return 1;
+    taskENTER_CRITICAL();
+    *residency = xResidency[mode];
+    taskEXIT_CRITICAL();
+    return 0;
+}
+
+void vHALLPMResetResidency(){
+    uint8_t i;
+    taskENTER_CRITICAL();
+    for(i = 0; i < HAL_LPM_MODE_COUNT; i++){
+        xResidency[i].ulEntries = 0;
+        xResidency[i].ulTicks   = 0;
+    }
+    taskEXIT_CRITICAL();
+}
+
+void vHALLPMTickHook(){
+    /*Idle task that was switched out by an interrupt still has its flag set*/
+    if(ucSleeping && xIdleTask != NULL && xTaskGetCurrentTaskHandle() == xIdleTask){
+        xResidency[ucLastMode].ulTicks++;
+    }
+}
+
+void vHALLPMIdleHook(){
+    uint8_t mode;
+
+    if(xIdleTask == NULL){
+        xIdleTask = xTaskGetCurrentTaskHandle();
+    }
+    /*Interrupts stay disabled from the choice until the SR write that enters
+      the mode, so an interrupt can not make a task ready or start a peripheral
+      in between. Not a critical section, the nesting count stays 0 while idle
+      task sleeps and interrupts switch it out*/
+    __disable_interrupt();
+    mode        = prvChooseMode();
+    ucLastMode  = mode;
+    ucSleeping  = 1;
+    xResidency[mode].ulEntries++;
+    __bis_SR_register(usModeBits[mode] + GIE);
+    ucSleeping  = 0;
+}
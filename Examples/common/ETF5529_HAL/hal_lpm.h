@@ -0,0 +1,73 @@
+/**
+ * @file    hal_lpm.h
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   LPM API
+ *
+ * Idle governor that enters the deepest low power mode that is safe.
+ *
+ * LPM0 is used while something needs SMCLK: a timer that counts SMCLK
+ * (including ADC trigger timer), ADC12 clocked from SMCLK or MCLK, UART
+ * that is transmitting or has receive interrupt enabled, or when the next
+ * task wakes up in less than HAL_LPM_LPM3_MIN_TICKS ticks, because DCO
+ * restart and FLL relock are not worth it for short sleeps.
+ * LPM3 stops DCO, SMCLK and FLL, ACLK keeps the tick running.
+ * LPM4 stops ACLK too and with it the tick, so it is used only when no task
+ * is blocked with a timeout (see xTaskGetTicksToNextUnblock) and no other
+ * ACLK user is running. LPM4 is disabled by default, enable it with
+ * vHALLPMSetDeepestMode only if every interrupt that can make a task ready
+ * either ends with portYIELD_FROM_ISR or leaves with
+ * __bic_SR_register_on_exit, since the tick will not come to wake idle task
+ * up. portYIELD_FROM_ISR clears the low power bits of the interrupted idle
+ * task before it switches context, otherwise idle task would go back to sleep
+ * in the old mode when it runs again. Tick count does not advance while in
+ * LPM4. Co-routine delays are not seen by the governor, do not enable LPM4
+ * while a co-routine waits for a timeout.
+ *
+ * Mode is chosen with interrupts disabled and again on every tick, because
+ * tick interrupt always returns to active mode. Interrupts are disabled
+ * directly, not with a critical section, so the sleep is not traced by
+ * configUSE_CRITICAL_TRACE. Residency is sampled by the tick: a tick that
+ * interrupts the sleeping idle task adds one tick to the current mode.
+ * Time spent in LPM4 can not be measured, only its entries are counted.
+ *
+ * Usage: call vHALLPMIdleHook from vApplicationIdleHook instead of
+ * __bis_SR_register( LPM0_bits + GIE ) and vHALLPMTickHook from
+ * vApplicationTickHook. Set INCLUDE_xTaskGetTicksToNextUnblock to 1 in
+ * FreeRTOSConfig.h, otherwise LPM3 is used regardless of next wake up and
+ * LPM4 is never used.
+ */
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#ifndef HAL_LPM_H_
+#define HAL_LPM_H_
+
+/*Modes*/
+#define HAL_LPM_MODE_LPM0               0
+#define HAL_LPM_MODE_LPM3               1
+#define HAL_LPM_MODE_LPM4               2
+#define HAL_LPM_MODE_COUNT              3
+
+/*Shortest sleep in ticks for which LPM3 is used*/
+#define HAL_LPM_LPM3_MIN_TICKS          2
+
+typedef struct{
+    uint32_t    ulEntries;              /*Number of times mode was entered*/
+    uint32_t    ulTicks;                /*Ticks spent in mode, always 0 for LPM4*/
+}hal_lpm_residency_t;
+
+/*Limit the deepest mode governor can choose, returns 1 if mode does not exist*/
+uint8_t     vHALLPMSetDeepestMode(uint8_t mode);
+/*Mode chosen last time idle task went to sleep*/
+uint8_t     ucHALLPMGetLastMode();
+/*Copy residency of a mode, returns 1 if mode does not exist*/
+uint8_t     vHALLPMGetResidency(uint8_t mode, hal_lpm_residency_t* residency);
+/*Clear residency of all modes*/
+void        vHALLPMResetResidency();
+/*Call from vApplicationTickHook*/
+void        vHALLPMTickHook();
+/*Call from vApplicationIdleHook, returns after the CPU is woken up*/
+void        vHALLPMIdleHook();
+
+#endif /* HAL_LPM_H_ */
@@ -0,0 +1,73 @@
+/**
+ * @file    hal_uart.c
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   UART API
+ *
+ * Helper functions for polled UART output on USCI_A1
+ */
+
+#include "hal_uart.h"
+#include "msp430.h"
+
+/*Baud rate set by vHALUARTInit, 0 while UART is not used*/
+static uint32_t ulBaudRate;
+
+void vHALUARTInit(uint32_t smclkHz, uint32_t baudRate){
+    ulBaudRate       = baudRate;
+    HAL_UART_SEL    |= HAL_UART_TXD_MASK + HAL_UART_RXD_MASK;
+    vHALUARTSetClock(smclkHz);
+}
+
+void vHALUARTSetClock(uint32_t smclkHz){
+    /*Divider in 1/8 steps, integer part goes to UCBRx and fraction to UCBRSx*/
+    uint32_t divider8;
+    uint8_t  interruptEnable;
+
+    if(ulBaudRate == 0) return;
+    divider8         = (smclkHz * 8 + ulBaudRate / 2) / ulBaudRate;
+    /*Let character in progress finish*/
+    while(UCA1STAT & UCBUSY);
+    /*Reset clears interrupt enable bits*/
+    interruptEnable  = UCA1IE;
+    UCA1CTL1        |= UCSWRST;                         // Put state machine in reset
+    UCA1CTL1        |= UCSSEL_2;                        // SMCLK
+    UCA1BRW          = (uint16_t)(divider8 >> 3);
+    UCA1MCTL         = (uint8_t)((divider8 & 0x07) << 1);  // UCBRSx, UCBRFx = 0, UCOS16 = 0
+    UCA1CTL1        &= ~UCSWRST;                        // Initialize USCI state machine
+    UCA1IE           = interruptEnable;
+}
+
+void vHALUARTPutChar(char character){
+    while(!(UCA1IFG & UCTXIFG));
+    UCA1TXBUF = character;
+}
+
+void vHALUARTPutString(const char* string){
+    while(*string != 0){
+        vHALUARTPutChar(*string);
+        string += 1;
+    }
+}
+
+void vHALUARTPutHex(uint32_t value, uint8_t digits){
+    uint8_t nibble;
+    while(digits > 0){
+        digits -= 1;
+        nibble = (value >> (digits * 4)) & 0x0F;
+        vHALUARTPutChar(nibble < 10 ? '0' + nibble : 'A' + nibble - 10);
+    }
+}
+
+void vHALUARTPutDec(uint32_t value){
+    /*uint32_t has at most 10 decimal digits*/
+    char    digits[10];
+    uint8_t count = 0;
+    do{
+        digits[count++] = '0' + value % 10;
+        value /= 10;
+    }while(value != 0);
+    while(count > 0){
+        vHALUARTPutChar(digits[--count]);
+    }
+}
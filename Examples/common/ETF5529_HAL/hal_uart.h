@@ -0,0 +1,34 @@
+/**
+ * @file    hal_uart.h
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   UART API
+ *
+ * Helper functions for polled UART output on USCI_A1 (P4.4 TXD, P4.5 RXD)
+ */
+
+#include <stdint.h>
+#ifndef HAL_UART_H_
+#define HAL_UART_H_
+
+/*UART pins position inside of register*/
+#define HAL_UART_TXD_MASK               0x10
+#define HAL_UART_RXD_MASK               0x20
+/*UART pins function select register*/
+#define HAL_UART_SEL                    P4SEL
+
+/*Init USCI_A1 as 8N1 UART clocked from SMCLK*/
+void        vHALUARTInit(uint32_t smclkHz, uint32_t baudRate);
+/*Recalculate baud rate divider after SMCLK change, does nothing if UART is not initialized*/
+void        vHALUARTSetClock(uint32_t smclkHz);
+/*Send one character, waits until transmit buffer is free*/
+void        vHALUARTPutChar(char character);
+/*Send zero terminated string*/
+void        vHALUARTPutString(const char* string);
+/*Send value as hexadecimal number with given number of digits*/
+void        vHALUARTPutHex(uint32_t value, uint8_t digits);
+/*Send value as unsigned decimal number*/
+void        vHALUARTPutDec(uint32_t value);
+
+
+#endif /* HAL_UART_H_ */
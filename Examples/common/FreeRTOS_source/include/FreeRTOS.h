@@ -152,6 +152,10 @@ extern "C" {
 	#define INCLUDE_xTaskGetHandle 0
 #endif
 
+#ifndef INCLUDE_xTaskGetTicksToNextUnblock
+	#define INCLUDE_xTaskGetTicksToNextUnblock 0
+#endif
+
 #ifndef INCLUDE_uxTaskGetStackHighWaterMark
 	#define INCLUDE_uxTaskGetStackHighWaterMark 0
 #endif
@@ -234,6 +238,48 @@ extern "C" {
 	#error configMAX_TASK_NAME_LEN must be set to a minimum of 1 in FreeRTOSConfig.h
 #endif
 
+#ifndef configDELAYED_LIST_BUCKETS
+	#define configDELAYED_LIST_BUCKETS 1
+#endif
+
+#if( ( configDELAYED_LIST_BUCKETS < 1 ) || ( ( configDELAYED_LIST_BUCKETS & ( configDELAYED_LIST_BUCKETS - 1 ) ) != 0 ) )
+	#error configDELAYED_LIST_BUCKETS must be a power of 2 in FreeRTOSConfig.h
+#endif
+
+#ifndef configUSE_EDF_SCHEDULING
+	#define configUSE_EDF_SCHEDULING 0
+#endif
+
+#ifndef configUSE_PERIODIC_TASKS
+	#define configUSE_PERIODIC_TASKS 0
+#endif
+
+#ifndef configUSE_BATCHED_WAKEUPS
+	#define configUSE_BATCHED_WAKEUPS 0
+#endif
+
+/* Time base of the periodic task statistics, only expanded inside tasks.c.
+Ticks by default, define it as a free running 32 bit counter, for example
+portGET_RUN_TIME_COUNTER_VALUE(), to measure jitter and response time below
+one tick.  configPERIODIC_STATS_TIME_PER_TICK then has to give the number of
+counts per tick.  Elapsed times are taken with configPERIODIC_STATS_ELAPSED(),
+which for the tick count wraps at the width of TickType_t, so 16 bit ticks do
+not give huge times across the wrap.  A narrower counter has to define it
+too. */
+#ifndef configPERIODIC_STATS_TIME
+	#define configPERIODIC_STATS_TIME() ( ( uint32_t ) xTickCount )
+	#define configPERIODIC_STATS_TIME_PER_TICK 1
+	#define configPERIODIC_STATS_ELAPSED( ulNow, ulThen ) ( ( uint32_t ) ( TickType_t ) ( ( ulNow ) - ( ulThen ) ) )
+#endif
+
+#ifndef configPERIODIC_STATS_ELAPSED
+	#define configPERIODIC_STATS_ELAPSED( ulNow, ulThen ) ( ( uint32_t ) ( ( ulNow ) - ( ulThen ) ) )
+#endif
+
+#if( ( configUSE_PERIODIC_TASKS == 1 ) && !defined( configPERIODIC_STATS_TIME_PER_TICK ) )
+	#error configPERIODIC_STATS_TIME_PER_TICK must be defined in FreeRTOSConfig.h when configPERIODIC_STATS_TIME is defined.
+#endif
+
 #ifndef configASSERT
 	#define configASSERT( x )
 	#define configASSERT_DEFINED 0
@@ -504,6 +550,10 @@ extern "C" {
 	#define traceTASK_DELAY_UNTIL( x )
 #endif
 
+#ifndef traceTASK_DEADLINE_MISSED
+	#define traceTASK_DEADLINE_MISSED( pxTCB )
+#endif
+
 #ifndef traceTASK_DELAY
 	#define traceTASK_DELAY()
 #endif
@@ -758,6 +808,10 @@ extern "C" {
 	#define configUSE_QUEUE_SETS 0
 #endif
 
+#ifndef configUSE_QUEUE_STATISTICS
+	#define configUSE_QUEUE_STATISTICS 0
+#endif
+
 #ifndef portTASK_USES_FLOATING_POINT
 	#define portTASK_USES_FLOATING_POINT()
 #endif
@@ -814,6 +868,14 @@ extern "C" {
 	#define configUSE_TASK_NOTIFICATIONS 1
 #endif
 
+#ifndef configTASK_NOTIFICATION_ARRAY_ENTRIES
+	#define configTASK_NOTIFICATION_ARRAY_ENTRIES 1
+#endif
+
+#if configTASK_NOTIFICATION_ARRAY_ENTRIES < 1
+	#error configTASK_NOTIFICATION_ARRAY_ENTRIES must be set to a minimum of 1 in FreeRTOSConfig.h
+#endif
+
 #ifndef configUSE_POSIX_ERRNO
 	#define configUSE_POSIX_ERRNO 0
 #endif
@@ -1123,8 +1185,8 @@ typedef struct xSTATIC_TCB
 		struct	_reent	xDummy17;
 	#endif
 	#if ( configUSE_TASK_NOTIFICATIONS == 1 )
-		uint32_t 		ulDummy18;
-		uint8_t 		ucDummy19;
+		uint32_t 		ulDummy18[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
+		uint8_t 		ucDummy19[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
 	#endif
 	#if ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 )
 		uint8_t			uxDummy20;
@@ -1136,6 +1198,19 @@ typedef struct xSTATIC_TCB
 	#if ( configUSE_POSIX_ERRNO == 1 )
 		int				iDummy22;
 	#endif
+	#if ( configUSE_EDF_SCHEDULING == 1 )
+		TickType_t		xDummy23[ 2 ];
+		UBaseType_t		uxDummy24;
+		uint8_t			ucDummy25[ 2 ];
+	#endif
+	#if ( configUSE_PERIODIC_TASKS == 1 )
+		TickType_t		xDummy26;
+		uint32_t		ulDummy27[ 5 ];
+		uint8_t			ucDummy28;
+	#endif
+	#if ( configUSE_BATCHED_WAKEUPS == 1 )
+		UBaseType_t		uxDummy29;
+	#endif
 } StaticTask_t;
 
 /*
@@ -1179,6 +1254,14 @@ typedef struct xSTATIC_QUEUE
 		uint8_t ucDummy9;
 	#endif
 
+	#if ( configUSE_QUEUE_STATISTICS == 1 )
+		struct
+		{
+			UBaseType_t uxDummy10;
+			uint32_t ulDummy11[ 4 ];
+		} xDummy12;
+	#endif
+
 } StaticQueue_t;
 typedef StaticQueue_t StaticSemaphore_t;
 
@@ -54,6 +54,8 @@ typedef struct corCoRoutineControlBlock
 	UBaseType_t 		uxPriority;			/*< The priority of the co-routine in relation to other co-routines. */
 	UBaseType_t 		uxIndex;			/*< Used to distinguish between co-routines when multiple co-routines use the same co-routine function. */
 	uint16_t 			uxState;			/*< Used internally by the co-routine implementation. */
+	volatile uint32_t	ulNotifiedValue;	/*< Count given by xCoRoutineNotifyGive() and taken by crNOTIFY_TAKE(). */
+	volatile uint8_t	ucNotifyState;		/*< Set while the co-routine is blocked in crNOTIFY_TAKE(). */
 } CRCB_t; /* Co-routine control block.  Note must be identical in size down to uxPriority with TCB_t. */
 
 /**
@@ -693,6 +695,106 @@ void vCoRoutineSchedule( void );
  */
 #define crQUEUE_RECEIVE_FROM_ISR( pxQueue, pvBuffer, pxCoRoutineWoken ) xQueueCRReceiveFromISR( ( pxQueue ), ( pvBuffer ), ( pxCoRoutineWoken ) )
 
+/**
+ * croutine. h
+ * <pre>
+  crNOTIFY_TAKE(
+                   CoRoutineHandle_t xHandle,
+                   TickType_t xTicksToWait,
+                   BaseType_t *pxResult
+               )</pre>
+ *
+ * The co-routine equivalent of ulTaskNotifyTake( pdTRUE, xTicksToWait ).
+ * Every co-routine has a notification count that tasks, software timer
+ * callbacks and interrupts increment with xCoRoutineNotifyGive() and
+ * xCoRoutineNotifyGiveFromISR().  crNOTIFY_TAKE() blocks the co-routine until
+ * the count is not zero, then clears it.  Unlike crQUEUE_SEND() and
+ * crQUEUE_RECEIVE() no queue is needed, so a task or an interrupt can wake a
+ * co-routine without a kernel object.
+ *
+ * crNOTIFY_TAKE can only be called from the co-routine function itself - not
+ * from within a function called by the co-routine function.
+ *
+ * Co-routines run from the idle task, so a co-routine readied by a task runs
+ * when no task is ready, and one readied by an interrupt runs when the idle
+ * task next calls vCoRoutineSchedule().
+ *
+ * @param xHandle The handle of the calling co-routine.  This is the xHandle
+ * parameter of the co-routine function.
+ *
+ * @param xTicksToWait The number of ticks that the co-routine should block to
+ * wait for the notification if the count is zero.
+ *
+ * @param pxResult The variable pointed to by pxResult will be set to pdPASS if
+ * the notification was taken, otherwise it will be set to pdFAIL.
+ *
+ * Example usage:
+ <pre>
+ // Task that runs the display gives the notification every time it is
+ // updated, the co-routine blinks an LED in response.
+ static void prvBlinkCoRoutine( CoRoutineHandle_t xHandle, UBaseType_t uxIndex )
+ {
+ static BaseType_t xResult;
+
+    crSTART( xHandle );
+
+    for( ;; )
+    {
+        crNOTIFY_TAKE( xHandle, portMAX_DELAY, &xResult );
+
+        if( xResult == pdPASS )
+        {
+            vParTestToggleLED( 0 );
+        }
+    }
+
+    crEND();
+ }</pre>
+ * \defgroup crNOTIFY_TAKE crNOTIFY_TAKE
+ * \ingroup Tasks
+ */
+#define crNOTIFY_TAKE( xHandle, xTicksToWait, pxResult )								\
+{																						\
+	*( pxResult ) = xCoRoutineNotifyTake( ( xTicksToWait ) );							\
+	if( *( pxResult ) == errQUEUE_BLOCKED )												\
+	{																					\
+		crSET_STATE0( ( xHandle ) );													\
+		*( pxResult ) = xCoRoutineNotifyTake( 0 );										\
+	}																					\
+}
+
+/**
+ * croutine. h
+ * <pre>
+ BaseType_t xCoRoutineNotifyGive( CoRoutineHandle_t xCoRoutine );
+ BaseType_t xCoRoutineNotifyGiveFromISR( CoRoutineHandle_t xCoRoutine );</pre>
+ *
+ * Increment the notification count of a co-routine and ready it if it is
+ * blocked in crNOTIFY_TAKE().  xCoRoutineNotifyGive() is called from tasks
+ * and software timer callbacks, xCoRoutineNotifyGiveFromISR() from interrupts.
+ * The co-routine handle is the xHandle parameter of the co-routine function,
+ * a co-routine can store it for others to use.
+ *
+ * @return pdTRUE if the co-routine was blocked waiting for the notification,
+ * otherwise pdFALSE.
+ *
+ * \defgroup xCoRoutineNotifyGive xCoRoutineNotifyGive
+ * \ingroup Tasks
+ */
+BaseType_t xCoRoutineNotifyGive( CoRoutineHandle_t xCoRoutine );
+BaseType_t xCoRoutineNotifyGiveFromISR( CoRoutineHandle_t xCoRoutine );
+
+/*
+ * This function is intended for internal use by the co-routine macros only.
+ * The macro nature of the co-routine implementation requires that the
+ * prototype appears here.  The function should not be used by application
+ * writers.
+ *
+ * Takes the notification of the current co-routine, or blocks it if
+ * xTicksToWait is not zero and the count is zero.
+ */
+BaseType_t xCoRoutineNotifyTake( TickType_t xTicksToWait );
+
 /*
  * This function is intended for internal use by the co-routine macros only.
  * The macro nature of the co-routine implementation requires that the
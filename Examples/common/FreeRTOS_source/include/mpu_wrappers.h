@@ -54,6 +54,11 @@ only for ports that are using the MPU. */
 		#define vTaskDelay								MPU_vTaskDelay
 		#define vTaskDelayUntil							MPU_vTaskDelayUntil
 		#define xTaskAbortDelay							MPU_xTaskAbortDelay
+		#define xTaskWaitForNextRelease					MPU_xTaskWaitForNextRelease
+		#define vTaskSetDeadline						MPU_vTaskSetDeadline
+		#define uxTaskGetDeadlineMisses					MPU_uxTaskGetDeadlineMisses
+		#define vTaskGetPeriodicStats					MPU_vTaskGetPeriodicStats
+		#define vTaskResetPeriodicStats					MPU_vTaskResetPeriodicStats
 		#define uxTaskPriorityGet						MPU_uxTaskPriorityGet
 		#define eTaskGetState							MPU_eTaskGetState
 		#define vTaskGetInfo							MPU_vTaskGetInfo
@@ -79,9 +84,9 @@ only for ports that are using the MPU. */
 		#define vTaskGetRunTimeStats					MPU_vTaskGetRunTimeStats
 		#define xTaskGetIdleRunTimeCounter				MPU_xTaskGetIdleRunTimeCounter
 		#define xTaskGenericNotify						MPU_xTaskGenericNotify
-		#define xTaskNotifyWait							MPU_xTaskNotifyWait
-		#define ulTaskNotifyTake						MPU_ulTaskNotifyTake
-		#define xTaskNotifyStateClear					MPU_xTaskNotifyStateClear
+		#define xTaskGenericNotifyWait					MPU_xTaskGenericNotifyWait
+		#define ulTaskGenericNotifyTake					MPU_ulTaskGenericNotifyTake
+		#define xTaskGenericNotifyStateClear			MPU_xTaskGenericNotifyStateClear
 
 		#define xTaskGetCurrentTaskHandle				MPU_xTaskGetCurrentTaskHandle
 		#define vTaskSetTimeOutState					MPU_vTaskSetTimeOutState
@@ -1487,6 +1487,68 @@ BaseType_t xQueueGiveMutexRecursive( QueueHandle_t xMutex ) PRIVILEGED_FUNCTION;
 	const char *pcQueueGetName( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
 #endif
 
+/*
+ * Occupancy and contention counters kept for each queue, semaphore and mutex
+ * when configUSE_QUEUE_STATISTICS is set to 1 in FreeRTOSConfig.h.  Blocked
+ * times are in ticks and are measured from the moment a call first found it
+ * had to block until the call returned.
+ */
+#if( configUSE_QUEUE_STATISTICS == 1 )
+	typedef struct xQUEUE_STATS
+	{
+		UBaseType_t uxPeakMessagesWaiting;	/*< The highest number of items the queue has held. */
+		uint32_t ulSendFailures;			/*< Number of sends (or gives) that returned errQUEUE_FULL, from tasks and interrupts. */
+		uint32_t ulSendBlockedTicks;		/*< Total time tasks spent blocked waiting for space. */
+		uint32_t ulReceiveBlockedTicks;		/*< Total time tasks spent blocked waiting for data (receive, peek or take). */
+		uint32_t ulWakeups;					/*< Number of tasks the queue removed from its waiting lists. */
+	} QueueStats_t;
+
+	/* Used with uxQueueGetRegistryStatistics(). */
+	typedef struct xQUEUE_REGISTRY_STATS
+	{
+		const char *pcQueueName; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+		QueueHandle_t xHandle;
+		UBaseType_t uxLength;
+		QueueStats_t xStats;
+	} QueueRegistryStats_t;
+#endif
+
+/*
+ * Copy the statistics of a queue, semaphore or mutex into *pxStats.
+ * configUSE_QUEUE_STATISTICS must be set to 1 in FreeRTOSConfig.h.
+ *
+ * @param xQueue The handle of the queue to query.
+ *
+ * @param pxStats The structure the statistics are copied into.
+ */
+#if( configUSE_QUEUE_STATISTICS == 1 )
+	void vQueueGetStatistics( QueueHandle_t xQueue, QueueStats_t *pxStats ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Clear the statistics of a queue, semaphore or mutex.  The peak occupancy
+ * restarts from the number of items currently in the queue.
+ * configUSE_QUEUE_STATISTICS must be set to 1 in FreeRTOSConfig.h.
+ */
+#if( configUSE_QUEUE_STATISTICS == 1 )
+	void vQueueResetStatistics( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+#endif
+
+/*
+ * Fill pxArray with the name, length and statistics of every queue in the
+ * queue registry.  Both configUSE_QUEUE_STATISTICS and
+ * configQUEUE_REGISTRY_SIZE must be set in FreeRTOSConfig.h.
+ *
+ * @param pxArray Array the registry entries are written into.
+ *
+ * @param uxArraySize The number of entries pxArray can hold.
+ *
+ * @return The number of entries written to pxArray.
+ */
+#if( ( configUSE_QUEUE_STATISTICS == 1 ) && ( configQUEUE_REGISTRY_SIZE > 0 ) )
+	UBaseType_t uxQueueGetRegistryStatistics( QueueRegistryStats_t * const pxArray, const UBaseType_t uxArraySize ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Generic version of the function used to creaet a queue using dynamic memory
  * allocation.  This is called by other functions and macros that create other
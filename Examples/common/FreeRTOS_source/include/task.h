@@ -86,6 +86,10 @@ typedef enum
 	eInvalid		/* Used as an 'invalid state' value. */
 } eTaskState;
 
+/* Index of the notification used by the API functions that do not take an
+index, see configTASK_NOTIFICATION_ARRAY_ENTRIES. */
+#define tskDEFAULT_INDEX_TO_NOTIFY		( 0 )
+
 /* Actions that can be performed when vTaskNotify() is called. */
 typedef enum
 {
@@ -147,6 +151,18 @@ typedef struct xTASK_STATUS
 	configSTACK_DEPTH_TYPE usStackHighWaterMark;	/* The minimum amount of stack space that has remained for the task since the task was created.  The closer this value is to zero the closer the task has come to overflowing its stack. */
 } TaskStatus_t;
 
+/* Used with the vTaskGetPeriodicStats() function to return the statistics of a
+periodic task.  Times are in units of configPERIODIC_STATS_TIME(), which are
+ticks unless FreeRTOSConfig.h defines a finer time base. */
+typedef struct xPERIODIC_STATS
+{
+	TickType_t xPeriod;				/* The period passed to the last xTaskWaitForNextRelease() call, 0 if the task has not called it. */
+	uint32_t ulReleases;			/* Number of jobs released. */
+	uint32_t ulOverruns;			/* Number of jobs that were released before the previous job completed. */
+	uint32_t ulMaxReleaseJitter;	/* Longest time from the release of a job until the task ran. */
+	uint32_t ulMaxResponseTime;		/* Longest time from the release of a job until it completed. */
+} PeriodicStats_t;
+
 /* Possible return values for eTaskConfirmSleepModeStatus(). */
 typedef enum
 {
@@ -816,6 +832,156 @@ void vTaskDelay( const TickType_t xTicksToDelay ) PRIVILEGED_FUNCTION;
  */
 void vTaskDelayUntil( TickType_t * const pxPreviousWakeTime, const TickType_t xTimeIncrement ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ * <pre>BaseType_t xTaskWaitForNextRelease( TickType_t *pxPreviousReleaseTime, const TickType_t xPeriod );</pre>
+ *
+ * configUSE_EDF_SCHEDULING or configUSE_PERIODIC_TASKS must be defined as 1
+ * for this function to be available.
+ *
+ * Ends the current job of a periodic task and blocks it until its next
+ * release, at the absolute time *pxPreviousReleaseTime + xPeriod, in the same
+ * way as vTaskDelayUntil().  The absolute deadline of the next job is set to
+ * its release time plus the relative deadline given to vTaskSetDeadline().  If
+ * the next release time has already passed the task does not block, but still
+ * yields so that a task with an earlier deadline can run first.
+ *
+ * Once a task has called xTaskWaitForNextRelease() only this function releases
+ * its jobs, so a job that blocks on a queue, semaphore or notification keeps
+ * its deadline when it is unblocked.
+ *
+ * Releases follow each other by exactly xPeriod ticks however long the jobs
+ * take, so unlike a loop that ends with vTaskDelay() the schedule does not
+ * drift.  After an overrun the task catches up with its releases.  With
+ * configUSE_PERIODIC_TASKS set to 1 the kernel also records the release jitter,
+ * response time and overruns of the task, see vTaskGetPeriodicStats().
+ *
+ * With configUSE_EDF_SCHEDULING set to 1 the ready tasks of the same priority
+ * run in order of their absolute deadlines instead of round robin.  Tasks that
+ * should be scheduled by deadline are normally all given the same priority,
+ * while interrupt deferred work can still be placed above them.
+ *
+ * @param pxPreviousReleaseTime Pointer to a variable that holds the release
+ * time of the job that is ending.  It must be initialised with the current
+ * time (xTaskGetTickCount()) before the first use and is updated
+ * automatically.
+ *
+ * @param xPeriod The period of the task in ticks.
+ *
+ * @return pdTRUE if the job that is ending met its deadline, pdFALSE if it was
+ * still running after its deadline.  With configUSE_EDF_SCHEDULING set to 0 the
+ * deadline of a job is the release of the next one, so pdFALSE means the job
+ * overran its period.
+ *
+ * Example usage:
+   <pre>
+ void vTaskFunction( void * pvParameters )
+ {
+ TickType_t xLastRelease;
+ const TickType_t xPeriod = pdMS_TO_TICKS( 10 );
+
+	 vTaskSetDeadline( NULL, pdMS_TO_TICKS( 8 ) );
+	 xLastRelease = xTaskGetTickCount();
+
+	 for( ;; )
+	 {
+		 // Perform action here, it has to complete within 8 ms of every
+		 // release.
+		 xTaskWaitForNextRelease( &xLastRelease, xPeriod );
+	 }
+ }
+   </pre>
+ * \defgroup xTaskWaitForNextRelease xTaskWaitForNextRelease
+ * \ingroup TaskCtrl
+ */
+BaseType_t xTaskWaitForNextRelease( TickType_t * const pxPreviousReleaseTime, const TickType_t xPeriod ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>void vTaskSetDeadline( TaskHandle_t xTask, TickType_t xRelativeDeadline );</pre>
+ *
+ * configUSE_EDF_SCHEDULING must be defined as 1 for this function to be
+ * available.
+ *
+ * Sets the relative deadline of a task.  The jobs of a periodic task are
+ * released by xTaskWaitForNextRelease(), while any other task releases a new
+ * job every time it leaves the Blocked or Suspended state.  Each job has to
+ * complete within xRelativeDeadline ticks of its release.  A job that blocks again after its
+ * deadline, or a periodic job that calls xTaskWaitForNextRelease() after it,
+ * is counted as a miss (see uxTaskGetDeadlineMisses()).  The current job of
+ * the task is given the new deadline as if it was released at the time of the
+ * call.
+ *
+ * @param xTask Handle of the task, passing NULL sets the deadline of the
+ * calling task.
+ *
+ * @param xRelativeDeadline Deadline in ticks, 0 removes the deadline.  A task
+ * without a deadline only runs when no ready task of its priority has one.
+ *
+ * \defgroup vTaskSetDeadline vTaskSetDeadline
+ * \ingroup TaskCtrl
+ */
+void vTaskSetDeadline( TaskHandle_t xTask, TickType_t xRelativeDeadline ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>UBaseType_t uxTaskGetDeadlineMisses( TaskHandle_t xTask );</pre>
+ *
+ * configUSE_EDF_SCHEDULING must be defined as 1 for this function to be
+ * available.
+ *
+ * @param xTask Handle of the task, passing NULL queries the calling task.
+ *
+ * @return The number of jobs of the task that missed their deadline.
+ *
+ * \defgroup uxTaskGetDeadlineMisses uxTaskGetDeadlineMisses
+ * \ingroup TaskCtrl
+ */
+UBaseType_t uxTaskGetDeadlineMisses( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>void vTaskGetPeriodicStats( TaskHandle_t xTask, PeriodicStats_t *pxStats );</pre>
+ *
+ * configUSE_PERIODIC_TASKS must be defined as 1 for this function to be
+ * available.
+ *
+ * Reads the release jitter, overrun count and worst response time of a task
+ * that waits for its jobs with xTaskWaitForNextRelease().  A job is released
+ * at its nominal release time, normally by the tick that unblocks the task,
+ * and its release jitter is the time until the task first runs after that.
+ * Its response time ends when the task calls xTaskWaitForNextRelease() again,
+ * so it includes the jitter and any time the task was preempted or blocked;
+ * it is not the execution time of the job.  The worst response time, together
+ * with the period, tells how much a sampling or display loop can still be
+ * shortened or extended.
+ *
+ * @param xTask Handle of the task, passing NULL queries the calling task.
+ *
+ * @param pxStats Structure the statistics are copied to.
+ *
+ * \defgroup vTaskGetPeriodicStats vTaskGetPeriodicStats
+ * \ingroup TaskCtrl
+ */
+void vTaskGetPeriodicStats( TaskHandle_t xTask, PeriodicStats_t *pxStats ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>void vTaskResetPeriodicStats( TaskHandle_t xTask );</pre>
+ *
+ * configUSE_PERIODIC_TASKS must be defined as 1 for this function to be
+ * available.
+ *
+ * Clears the release, overrun, jitter and response time statistics of a
+ * periodic task without changing its schedule.
+ *
+ * @param xTask Handle of the task, passing NULL clears the calling task.
+ *
+ * \defgroup vTaskResetPeriodicStats vTaskResetPeriodicStats
+ * \ingroup TaskCtrl
+ */
+void vTaskResetPeriodicStats( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
 /**
  * task. h
  * <pre>BaseType_t xTaskAbortDelay( TaskHandle_t xTask );</pre>
@@ -1366,6 +1532,29 @@ TickType_t xTaskGetTickCount( void ) PRIVILEGED_FUNCTION;
  */
 TickType_t xTaskGetTickCountFromISR( void ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ * <PRE>TickType_t xTaskGetTicksToNextUnblock( void );</PRE>
+ *
+ * INCLUDE_xTaskGetTicksToNextUnblock must be defined as 1 in FreeRTOSConfig.h
+ * for this function to be available.
+ *
+ * @return The number of ticks until the next task that is blocked with a
+ * timeout (including the timer service task waiting for its next timer) will
+ * be unblocked by the tick.  portMAX_DELAY is returned if no task is blocked
+ * with a timeout, in which case only an interrupt can make a task ready.  Can
+ * be used from the idle hook to choose how deep a low power mode is safe.
+ *
+ * Must be called with interrupts disabled, the same way
+ * eTaskConfirmSleepModeStatus() is.  It does not enter a critical section
+ * itself, so interrupts are still disabled when it returns and the low power
+ * mode can be entered while the result is still valid.
+ *
+ * \defgroup xTaskGetTicksToNextUnblock xTaskGetTicksToNextUnblock
+ * \ingroup TaskUtils
+ */
+TickType_t xTaskGetTicksToNextUnblock( void ) PRIVILEGED_FUNCTION;
+
 /**
  * task. h
  * <PRE>uint16_t uxTaskGetNumberOfTasks( void );</PRE>
@@ -1799,6 +1988,15 @@ TickType_t xTaskGetIdleRunTimeCounter( void ) PRIVILEGED_FUNCTION;
  *
  * See http://www.FreeRTOS.org/RTOS-task-notifications.html for details.
  *
+ * Each task has configTASK_NOTIFICATION_ARRAY_ENTRIES notifications, every
+ * one with its own value and state.  The functions and macros without an index
+ * act on the notification at index tskDEFAULT_INDEX_TO_NOTIFY, their
+ * ...Indexed() variants, for example xTaskNotifyIndexed(), take the index as
+ * the second (for ulTaskNotifyTakeIndexed() and xTaskNotifyWaitIndexed() the
+ * first) parameter.  A task that waits on one index is not unblocked by a
+ * notification sent to another, so a driver can use its own index without
+ * colliding with the bits the application uses at index 0.
+ *
  * @param xTaskToNotify The handle of the task being notified.  The handle to a
  * task can be returned from the xTaskCreate() API function used to create the
  * task, and the handle of the currently running task can be obtained by calling
@@ -1845,9 +2043,11 @@ TickType_t xTaskGetIdleRunTimeCounter( void ) PRIVILEGED_FUNCTION;
  * \defgroup xTaskNotify xTaskNotify
  * \ingroup TaskNotifications
  */
-BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue ) PRIVILEGED_FUNCTION;
-#define xTaskNotify( xTaskToNotify, ulValue, eAction ) xTaskGenericNotify( ( xTaskToNotify ), ( ulValue ), ( eAction ), NULL )
-#define xTaskNotifyAndQuery( xTaskToNotify, ulValue, eAction, pulPreviousNotifyValue ) xTaskGenericNotify( ( xTaskToNotify ), ( ulValue ), ( eAction ), ( pulPreviousNotifyValue ) )
+BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue ) PRIVILEGED_FUNCTION;
+#define xTaskNotify( xTaskToNotify, ulValue, eAction ) xTaskGenericNotify( ( xTaskToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( ulValue ), ( eAction ), NULL )
+#define xTaskNotifyIndexed( xTaskToNotify, uxIndexToNotify, ulValue, eAction ) xTaskGenericNotify( ( xTaskToNotify ), ( uxIndexToNotify ), ( ulValue ), ( eAction ), NULL )
+#define xTaskNotifyAndQuery( xTaskToNotify, ulValue, eAction, pulPreviousNotifyValue ) xTaskGenericNotify( ( xTaskToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( ulValue ), ( eAction ), ( pulPreviousNotifyValue ) )
+#define xTaskNotifyAndQueryIndexed( xTaskToNotify, uxIndexToNotify, ulValue, eAction, pulPreviousNotifyValue ) xTaskGenericNotify( ( xTaskToNotify ), ( uxIndexToNotify ), ( ulValue ), ( eAction ), ( pulPreviousNotifyValue ) )
 
 /**
  * task. h
@@ -1936,9 +2136,11 @@ BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNo
  * \defgroup xTaskNotify xTaskNotify
  * \ingroup TaskNotifications
  */
-BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
-#define xTaskNotifyFromISR( xTaskToNotify, ulValue, eAction, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( ulValue ), ( eAction ), NULL, ( pxHigherPriorityTaskWoken ) )
-#define xTaskNotifyAndQueryFromISR( xTaskToNotify, ulValue, eAction, pulPreviousNotificationValue, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( ulValue ), ( eAction ), ( pulPreviousNotificationValue ), ( pxHigherPriorityTaskWoken ) )
+BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#define xTaskNotifyFromISR( xTaskToNotify, ulValue, eAction, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( ulValue ), ( eAction ), NULL, ( pxHigherPriorityTaskWoken ) )
+#define xTaskNotifyIndexedFromISR( xTaskToNotify, uxIndexToNotify, ulValue, eAction, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( uxIndexToNotify ), ( ulValue ), ( eAction ), NULL, ( pxHigherPriorityTaskWoken ) )
+#define xTaskNotifyAndQueryFromISR( xTaskToNotify, ulValue, eAction, pulPreviousNotificationValue, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( ulValue ), ( eAction ), ( pulPreviousNotificationValue ), ( pxHigherPriorityTaskWoken ) )
+#define xTaskNotifyAndQueryIndexedFromISR( xTaskToNotify, uxIndexToNotify, ulValue, eAction, pulPreviousNotificationValue, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( uxIndexToNotify ), ( ulValue ), ( eAction ), ( pulPreviousNotificationValue ), ( pxHigherPriorityTaskWoken ) )
 
 /**
  * task. h
@@ -2013,7 +2215,9 @@ BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulVal
  * \defgroup xTaskNotifyWait xTaskNotifyWait
  * \ingroup TaskNotifications
  */
-BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+BaseType_t xTaskGenericNotifyWait( UBaseType_t uxIndexToWait, uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#define xTaskNotifyWait( ulBitsToClearOnEntry, ulBitsToClearOnExit, pulNotificationValue, xTicksToWait ) xTaskGenericNotifyWait( ( tskDEFAULT_INDEX_TO_NOTIFY ), ( ulBitsToClearOnEntry ), ( ulBitsToClearOnExit ), ( pulNotificationValue ), ( xTicksToWait ) )
+#define xTaskNotifyWaitIndexed( uxIndexToWait, ulBitsToClearOnEntry, ulBitsToClearOnExit, pulNotificationValue, xTicksToWait ) xTaskGenericNotifyWait( ( uxIndexToWait ), ( ulBitsToClearOnEntry ), ( ulBitsToClearOnExit ), ( pulNotificationValue ), ( xTicksToWait ) )
 
 /**
  * task. h
@@ -2059,7 +2263,8 @@ BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClea
  * \defgroup xTaskNotifyGive xTaskNotifyGive
  * \ingroup TaskNotifications
  */
-#define xTaskNotifyGive( xTaskToNotify ) xTaskGenericNotify( ( xTaskToNotify ), ( 0 ), eIncrement, NULL )
+#define xTaskNotifyGive( xTaskToNotify ) xTaskGenericNotify( ( xTaskToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( 0 ), eIncrement, NULL )
+#define xTaskNotifyGiveIndexed( xTaskToNotify, uxIndexToNotify ) xTaskGenericNotify( ( xTaskToNotify ), ( uxIndexToNotify ), ( 0 ), eIncrement, NULL )
 
 /**
  * task. h
@@ -2114,7 +2319,9 @@ BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClea
  * \defgroup xTaskNotifyWait xTaskNotifyWait
  * \ingroup TaskNotifications
  */
-void vTaskNotifyGiveFromISR( TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+void vTaskGenericNotifyGiveFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#define vTaskNotifyGiveFromISR( xTaskToNotify, pxHigherPriorityTaskWoken ) vTaskGenericNotifyGiveFromISR( ( xTaskToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( pxHigherPriorityTaskWoken ) )
+#define vTaskNotifyGiveIndexedFromISR( xTaskToNotify, uxIndexToNotify, pxHigherPriorityTaskWoken ) vTaskGenericNotifyGiveFromISR( ( xTaskToNotify ), ( uxIndexToNotify ), ( pxHigherPriorityTaskWoken ) )
 
 /**
  * task. h
@@ -2183,7 +2390,9 @@ void vTaskNotifyGiveFromISR( TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPri
  * \defgroup ulTaskNotifyTake ulTaskNotifyTake
  * \ingroup TaskNotifications
  */
-uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+uint32_t ulTaskGenericNotifyTake( UBaseType_t uxIndexToWait, BaseType_t xClearCountOnExit, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#define ulTaskNotifyTake( xClearCountOnExit, xTicksToWait ) ulTaskGenericNotifyTake( ( tskDEFAULT_INDEX_TO_NOTIFY ), ( xClearCountOnExit ), ( xTicksToWait ) )
+#define ulTaskNotifyTakeIndexed( uxIndexToWait, xClearCountOnExit, xTicksToWait ) ulTaskGenericNotifyTake( ( uxIndexToWait ), ( xClearCountOnExit ), ( xTicksToWait ) )
 
 /**
  * task. h
@@ -2199,7 +2408,9 @@ uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait
  * \defgroup xTaskNotifyStateClear xTaskNotifyStateClear
  * \ingroup TaskNotifications
  */
-BaseType_t xTaskNotifyStateClear( TaskHandle_t xTask );
+BaseType_t xTaskGenericNotifyStateClear( TaskHandle_t xTask, UBaseType_t uxIndexToClear ) PRIVILEGED_FUNCTION;
+#define xTaskNotifyStateClear( xTask ) xTaskGenericNotifyStateClear( ( xTask ), ( tskDEFAULT_INDEX_TO_NOTIFY ) )
+#define xTaskNotifyStateClearIndexed( xTask, uxIndexToClear ) xTaskGenericNotifyStateClear( ( xTask ), ( uxIndexToClear ) )
 
 /*-----------------------------------------------------------
  * SCHEDULER INTERNALS AVAILABLE FOR PORTING PURPOSES
@@ -42,9 +42,36 @@
 	.if $DEFINED( __LARGE_CODE_MODEL__ )
 		.define "calla", call_x
 		.define "reta", ret_x
+		.define "bra", br_x
+		.define "mova", movc_x
 	.else
 		.define "call", call_x
 		.define "ret", ret_x
+		.define "br", br_x
+		.define "mov.w", movc_x
+	.endif
+
+	; configUSE_CRITICAL_TRACE is given as a project predefined symbol so it
+	; is seen here as well as by the C files, see portmacro.h.
+	.if $DEFINED( configUSE_CRITICAL_TRACE )
+		.if configUSE_CRITICAL_TRACE = 1
+portCRITICAL_TRACE	.set	1
+		.else
+portCRITICAL_TRACE	.set	0
+		.endif
+	.else
+portCRITICAL_TRACE	.set	0
+	.endif
+
+	; configUSE_MPY_CONTEXT is a project predefined symbol for the same reason.
+	.if $DEFINED( configUSE_MPY_CONTEXT )
+		.if configUSE_MPY_CONTEXT = 1
+portMPY_CONTEXT	.set	1
+		.else
+portMPY_CONTEXT	.set	0
+		.endif
+	.else
+portMPY_CONTEXT	.set	0
 	.endif
 
 
@@ -55,6 +55,58 @@ sequence. */
 volatile uint16_t usCriticalNesting = portINITIAL_CRITICAL_NESTING;
 /*-----------------------------------------------------------*/
 
+#if( configUSE_CRITICAL_TRACE == 1 )
+
+	/* The trace timer is a free running 16 bit timer.  By default timer A2 is
+	run from SMCLK divided by 8, which at 10MHz gives a resolution of 0.8us and
+	a range of 52ms.  Windows longer than the range wrap and are misreported. */
+	#ifndef configCRITICAL_TRACE_TIMER_SETUP
+		#define configCRITICAL_TRACE_TIMER_SETUP()								\
+		{																		\
+			TA2CTL = 0;															\
+			TA2EX0 = TAIDEX_0;													\
+			TA2CTL = TASSEL_2 | ID_3 | MC_2 | TACLR;							\
+		}
+		#define configCRITICAL_TRACE_TIMER_VALUE()		( TA2R )
+		#define configCRITICAL_TRACE_CYCLES_PER_COUNT	( 8UL )
+	#endif
+
+	/* Start of the window currently open, only valid while
+	xTraceWindowOpen is pdTRUE. */
+	static BaseType_t xTraceWindowOpen = pdFALSE;
+	static CriticalTraceRecord_t xTraceWindow;
+
+	/* The longest windows seen so far, longest first. */
+	static CriticalTraceRecord_t xTraceRecords[ configCRITICAL_TRACE_RECORDS ];
+
+	/* Called from portext.asm, so not static. */
+	void vPortTraceCriticalOpen( TaskFunction_t pxAddress );
+	void vPortTraceCriticalRestore( void );
+
+	static void prvTraceWriteHex( void ( *pxPutString )( const char *pcString ), uint32_t ulValue, UBaseType_t uxDigits );
+	static void prvTraceWriteDecimal( void ( *pxPutString )( const char *pcString ), uint32_t ulValue );
+
+#endif /* configUSE_CRITICAL_TRACE */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_MPY_CONTEXT == 1 )
+
+	/* Multiplier buffer of the running task, NULL if it has none.  Saved and
+	restored as part of the task context by portext.asm. */
+	MPYContext_t * volatile pxPortMPYContext = NULL;
+
+	/* Buffer of the task whose state the multiplier currently holds. */
+	static MPYContext_t *pxMPYOwner = NULL;
+
+	/* Called from portext.asm, so not static. */
+	void vPortMPYRestore( void );
+
+	static void prvMPYSave( MPYContext_t *pxContext );
+	static void prvMPYLoad( const MPYContext_t *pxContext );
+
+#endif /* configUSE_MPY_CONTEXT */
+/*-----------------------------------------------------------*/
+
 
 /*
  * Sets up the periodic ISR used for the RTOS tick.  This uses timer 0, but
@@ -63,6 +115,12 @@ volatile uint16_t usCriticalNesting = portINITIAL_CRITICAL_NESTING;
 void vPortSetupTimerInterrupt( void );
 /*-----------------------------------------------------------*/
 
+/*
+ * First code a new task runs, see portext.asm.
+ */
+extern void vPortTaskEntry( void );
+/*-----------------------------------------------------------*/
+
 /*
  * Initialise the stack of a task to look exactly as if a call to
  * portSAVE_CONTEXT had been called.
@@ -87,12 +145,16 @@ uint32_t *pulTopOfStack, ulTemp;
 	*/
 
 	/* Data types are need either 16 bits or 32 bits depending on the data 
-	and code model used. */
+	and code model used.  The task function goes first, vPortTaskEntry()
+	returns into it after moving the parameter from r4 to r12. */
 	if( sizeof( pxCode ) == sizeof( uint16_t ) )
 	{
 		pusTopOfStack = ( uint16_t * ) pxTopOfStack;
 		ulTemp = ( uint32_t ) pxCode;
 		*pusTopOfStack = ( uint16_t ) ulTemp;
+		pusTopOfStack--;
+		ulTemp = ( uint32_t ) vPortTaskEntry;
+		*pusTopOfStack = ( uint16_t ) ulTemp;
 	}
 	else
 	{
@@ -101,6 +163,9 @@ uint32_t *pulTopOfStack, ulTemp;
 		pusTopOfStack--;
 		pulTopOfStack = ( uint32_t * ) pusTopOfStack;
 		*pulTopOfStack = ( uint32_t ) pxCode;
+		pusTopOfStack -= 2;
+		pulTopOfStack = ( uint32_t * ) pusTopOfStack;
+		*pulTopOfStack = ( uint32_t ) vPortTaskEntry;
 	}
 
 	pusTopOfStack--;
@@ -110,36 +175,27 @@ uint32_t *pulTopOfStack, ulTemp;
 	/* From here on the size of stacked items depends on the memory model. */
 	pxTopOfStack = ( StackType_t * ) pusTopOfStack;
 
-	/* Next the general purpose registers. */
+	/* Next the general purpose registers r10 to r4, r11 to r15 are not part of
+	the context (see portext.asm). */
 	#ifdef PRELOAD_REGISTER_VALUES
-		*pxTopOfStack = ( StackType_t ) 0xffff;
-		pxTopOfStack--;
-		*pxTopOfStack = ( StackType_t ) 0xeeee;
-		pxTopOfStack--;
-		*pxTopOfStack = ( StackType_t ) 0xdddd;
-		pxTopOfStack--;
-		*pxTopOfStack = ( StackType_t ) pvParameters;
-		pxTopOfStack--;
-		*pxTopOfStack = ( StackType_t ) 0xbbbb;
-		pxTopOfStack--;
 		*pxTopOfStack = ( StackType_t ) 0xaaaa;
 		pxTopOfStack--;
 		*pxTopOfStack = ( StackType_t ) 0x9999;
 		pxTopOfStack--;
 		*pxTopOfStack = ( StackType_t ) 0x8888;
-		pxTopOfStack--;	
-		*pxTopOfStack = ( StackType_t ) 0x5555;
+		pxTopOfStack--;
+		*pxTopOfStack = ( StackType_t ) 0x7777;
 		pxTopOfStack--;
 		*pxTopOfStack = ( StackType_t ) 0x6666;
 		pxTopOfStack--;
 		*pxTopOfStack = ( StackType_t ) 0x5555;
 		pxTopOfStack--;
-		*pxTopOfStack = ( StackType_t ) 0x4444;
+		*pxTopOfStack = ( StackType_t ) pvParameters;
 		pxTopOfStack--;
 	#else
-		pxTopOfStack -= 3;
+		pxTopOfStack -= 6;
 		*pxTopOfStack = ( StackType_t ) pvParameters;
-		pxTopOfStack -= 9;
+		pxTopOfStack--;
 	#endif
 
 	/* A variable is used to keep track of the critical section nesting.
@@ -147,6 +203,14 @@ uint32_t *pulTopOfStack, ulTemp;
 	initially set to zero. */
 	*pxTopOfStack = ( StackType_t ) portNO_CRITICAL_SECTION_NESTING;	
 
+	#if( configUSE_MPY_CONTEXT == 1 )
+	{
+		/* A task starts without a multiplier buffer. */
+		pxTopOfStack--;
+		*pxTopOfStack = ( StackType_t ) NULL;
+	}
+	#endif
+
 	/* Return a pointer to the top of the stack we have generated so this can
 	be stored in the task control block for the task. */
 	return pxTopOfStack;
@@ -166,15 +230,289 @@ void vPortEndScheduler( void )
 void vPortSetupTimerInterrupt( void )
 {
 	vApplicationSetupTimerInterrupt();
+
+	#if( configUSE_CRITICAL_TRACE == 1 )
+	{
+		configCRITICAL_TRACE_TIMER_SETUP();
+	}
+	#endif
 }
 /*-----------------------------------------------------------*/
 
+#if( configUSE_CRITICAL_TRACE == 1 )
+
+	void vPortTraceCriticalOpen( TaskFunction_t pxAddress )
+	{
+		/* Interrupts are already masked.  A window might already be open if
+		a yield is performed from within a critical section, in which case the
+		window is attributed to whoever opened it first. */
+		if( xTraceWindowOpen == pdFALSE )
+		{
+			xTraceWindow.usDuration = configCRITICAL_TRACE_TIMER_VALUE();
+			xTraceWindow.ulAddress = ( uint32_t ) pxAddress;
+			xTraceWindow.xTickCount = xTaskGetTickCountFromISR();
+			xTraceWindowOpen = pdTRUE;
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortTraceCriticalClose( void )
+	{
+	UBaseType_t uxIndex;
+
+		if( xTraceWindowOpen != pdFALSE )
+		{
+			xTraceWindowOpen = pdFALSE;
+			xTraceWindow.usDuration = configCRITICAL_TRACE_TIMER_VALUE() - xTraceWindow.usDuration;
+
+			/* Insertion into the sorted table, the shortest record drops off
+			the end. */
+			if( xTraceWindow.usDuration > xTraceRecords[ configCRITICAL_TRACE_RECORDS - 1 ].usDuration )
+			{
+				uxIndex = configCRITICAL_TRACE_RECORDS - 1;
+
+				while( ( uxIndex > 0 ) && ( xTraceWindow.usDuration > xTraceRecords[ uxIndex - 1 ].usDuration ) )
+				{
+					xTraceRecords[ uxIndex ] = xTraceRecords[ uxIndex - 1 ];
+					uxIndex--;
+				}
+
+				xTraceRecords[ uxIndex ] = xTraceWindow;
+			}
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortTraceCriticalRestore( void )
+	{
+		/* Called by portRESTORE_CONTEXT after usCriticalNesting has been
+		loaded for the task that is about to run.  A task with no critical
+		nesting resumes with interrupts enabled, one that yielded from inside
+		a critical section resumes with them still masked. */
+		if( usCriticalNesting == portNO_CRITICAL_SECTION_NESTING )
+		{
+			vPortTraceCriticalClose();
+		}
+		else
+		{
+			vPortTraceCriticalOpen( NULL );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	UBaseType_t uxPortGetCriticalTrace( CriticalTraceRecord_t *pxRecords, UBaseType_t uxMaxRecords )
+	{
+	UBaseType_t uxIndex;
+
+		if( uxMaxRecords > configCRITICAL_TRACE_RECORDS )
+		{
+			uxMaxRecords = configCRITICAL_TRACE_RECORDS;
+		}
+
+		portENTER_CRITICAL();
+		{
+			for( uxIndex = 0; uxIndex < uxMaxRecords; uxIndex++ )
+			{
+				pxRecords[ uxIndex ] = xTraceRecords[ uxIndex ];
+			}
+		}
+		portEXIT_CRITICAL();
+
+		return uxMaxRecords;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortClearCriticalTrace( void )
+	{
+	UBaseType_t uxIndex;
+
+		portENTER_CRITICAL();
+		{
+			for( uxIndex = 0; uxIndex < configCRITICAL_TRACE_RECORDS; uxIndex++ )
+			{
+				xTraceRecords[ uxIndex ].ulAddress = 0UL;
+				xTraceRecords[ uxIndex ].usDuration = 0U;
+				xTraceRecords[ uxIndex ].xTickCount = 0U;
+			}
+		}
+		portEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortReportCriticalTrace( void ( *pxPutString )( const char *pcString ) )
+	{
+	CriticalTraceRecord_t xRecords[ configCRITICAL_TRACE_RECORDS ];
+	UBaseType_t uxIndex;
+
+		/* Take a snapshot first, the output function is likely to be slow and
+		must not run with interrupts masked.  Output is one line per window:
+		"addr=0x1234C cycles=412 tick=1020". */
+		( void ) uxPortGetCriticalTrace( xRecords, configCRITICAL_TRACE_RECORDS );
+
+		for( uxIndex = 0; uxIndex < configCRITICAL_TRACE_RECORDS; uxIndex++ )
+		{
+			if( xRecords[ uxIndex ].usDuration == 0U )
+			{
+				break;
+			}
+
+			pxPutString( "addr=0x" );
+			prvTraceWriteHex( pxPutString, xRecords[ uxIndex ].ulAddress, 5 );
+			pxPutString( " cycles=" );
+			prvTraceWriteDecimal( pxPutString, ( uint32_t ) xRecords[ uxIndex ].usDuration * configCRITICAL_TRACE_CYCLES_PER_COUNT );
+			pxPutString( " tick=" );
+			prvTraceWriteDecimal( pxPutString, ( uint32_t ) xRecords[ uxIndex ].xTickCount );
+			pxPutString( "\r\n" );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvTraceWriteHex( void ( *pxPutString )( const char *pcString ), uint32_t ulValue, UBaseType_t uxDigits )
+	{
+	char cBuffer[ 9 ];
+	UBaseType_t uxNibble;
+
+		cBuffer[ uxDigits ] = '\0';
+
+		while( uxDigits > 0 )
+		{
+			uxDigits--;
+			uxNibble = ( UBaseType_t ) ( ulValue & 0x0fUL );
+			cBuffer[ uxDigits ] = ( char ) ( ( uxNibble < 10 ) ? ( '0' + uxNibble ) : ( 'A' + uxNibble - 10 ) );
+			ulValue >>= 4;
+		}
+
+		pxPutString( cBuffer );
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvTraceWriteDecimal( void ( *pxPutString )( const char *pcString ), uint32_t ulValue )
+	{
+	char cBuffer[ 11 ];
+	UBaseType_t uxIndex = sizeof( cBuffer ) - 1;
+
+		cBuffer[ uxIndex ] = '\0';
+
+		do
+		{
+			uxIndex--;
+			cBuffer[ uxIndex ] = ( char ) ( '0' + ( ulValue % 10UL ) );
+			ulValue /= 10UL;
+		} while( ulValue != 0UL );
+
+		pxPutString( &( cBuffer[ uxIndex ] ) );
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configUSE_CRITICAL_TRACE */
+
+#if( configUSE_MPY_CONTEXT == 1 )
+
+	void vPortTaskUsesMPY( MPYContext_t *pxContext )
+	{
+		portENTER_CRITICAL();
+		{
+			if( pxContext != NULL )
+			{
+				/* The task is about to use the multiplier, whatever it holds
+				now belongs to the previous owner. */
+				if( ( pxMPYOwner != NULL ) && ( pxMPYOwner != pxContext ) )
+				{
+					prvMPYSave( pxMPYOwner );
+				}
+				pxMPYOwner = pxContext;
+			}
+			else if( pxMPYOwner == pxPortMPYContext )
+			{
+				pxMPYOwner = NULL;
+			}
+
+			pxPortMPYContext = pxContext;
+		}
+		portEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortMPYRestore( void )
+	{
+		/* Interrupts are disabled, pxPortMPYContext has just been loaded for
+		the task that is about to run. */
+		if( ( pxPortMPYContext != NULL ) && ( pxPortMPYContext != pxMPYOwner ) )
+		{
+			if( pxMPYOwner != NULL )
+			{
+				prvMPYSave( pxMPYOwner );
+			}
+			prvMPYLoad( pxPortMPYContext );
+			pxMPYOwner = pxPortMPYContext;
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvMPYSave( MPYContext_t *pxContext )
+	{
+		pxContext->usControl = MPY32CTL0;
+		pxContext->usOperand1Low = MPY32L;
+		pxContext->usOperand1High = MPY32H;
+		pxContext->usResult[ 0 ] = RES0;
+		pxContext->usResult[ 1 ] = RES1;
+		pxContext->usResult[ 2 ] = RES2;
+		pxContext->usResult[ 3 ] = RES3;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvMPYLoad( const MPYContext_t *pxContext )
+	{
+		/* Writing the first operand selects the operation (MPYM) and its width
+		(MPYOP1_32) without starting it, the operation only starts when the
+		second operand is written. */
+		if( ( pxContext->usControl & MPYOP1_32 ) != 0 )
+		{
+			switch( pxContext->usControl & MPYM_3 )
+			{
+				case MPYM_0:	MPY32L = pxContext->usOperand1Low;
+								MPY32H = pxContext->usOperand1High;
+								break;
+				case MPYM_1:	MPYS32L = pxContext->usOperand1Low;
+								MPYS32H = pxContext->usOperand1High;
+								break;
+				case MPYM_2:	MAC32L = pxContext->usOperand1Low;
+								MAC32H = pxContext->usOperand1High;
+								break;
+				default:		MACS32L = pxContext->usOperand1Low;
+								MACS32H = pxContext->usOperand1High;
+								break;
+			}
+		}
+		else
+		{
+			switch( pxContext->usControl & MPYM_3 )
+			{
+				case MPYM_0:	MPY = pxContext->usOperand1Low;		break;
+				case MPYM_1:	MPYS = pxContext->usOperand1Low;	break;
+				case MPYM_2:	MAC = pxContext->usOperand1Low;		break;
+				default:		MACS = pxContext->usOperand1Low;	break;
+			}
+		}
+
+		RES0 = pxContext->usResult[ 0 ];
+		RES1 = pxContext->usResult[ 1 ];
+		RES2 = pxContext->usResult[ 2 ];
+		RES3 = pxContext->usResult[ 3 ];
+
+		/* Fractional and saturation modes and the carry. */
+		MPY32CTL0 = pxContext->usControl;
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configUSE_MPY_CONTEXT */
+
 #pragma vector=configTICK_VECTOR
 interrupt void vTickISREntry( void )
 {
 extern void vPortTickISR( void );
 
-	__bic_SR_register_on_exit( SCG1 + SCG0 + OSCOFF + CPUOFF );
+	__bic_SR_register_on_exit( portLPM_BITS );
 	#if configUSE_PREEMPTION == 1
 		extern void vPortPreemptiveTickISR( void );
 		vPortPreemptiveTickISR();
@@ -64,9 +64,29 @@ typedef unsigned short UBaseType_t;
 #if( configUSE_16_BIT_TICKS == 1 )
 	typedef uint16_t TickType_t;
 	#define portMAX_DELAY ( TickType_t ) 0xffff
+
+	/* A 16 bit tick count is read by a single instruction. */
+	#define portTICK_TYPE_IS_ATOMIC 1
 #else
 	typedef uint32_t TickType_t;
 	#define portMAX_DELAY ( TickType_t ) 0xffffffffUL
+
+	/* The tick interrupt increments the 32 bit count as two 16 bit halves,
+	add to the lower half and add the carry to the upper half, so the fast
+	path only differs from a 16 bit count by the addc.  Tasks read the upper
+	half, the lower half and the upper half again, and only repeat if the
+	lower half wrapped in between - once every 65536 ticks - instead of
+	masking interrupts. */
+	#define portREAD_TICK_COUNT( xTicks, xTickCount )													\
+	{																									\
+	uint16_t usUpper;																					\
+																										\
+		do																								\
+		{																								\
+			usUpper = ( ( volatile uint16_t * ) &( xTickCount ) )[ 1 ];									\
+			( xTicks ) = ( ( TickType_t ) usUpper << 16 ) | ( ( volatile uint16_t * ) &( xTickCount ) )[ 0 ];	\
+		} while( usUpper != ( ( volatile uint16_t * ) &( xTickCount ) )[ 1 ] );						\
+	}
 #endif
 
 /*-----------------------------------------------------------*/
@@ -79,6 +99,45 @@ typedef unsigned short UBaseType_t;
 /* Critical section control macros. */
 #define portNO_CRITICAL_SECTION_NESTING		( ( uint16_t ) 0 )
 
+/* Interrupts-off window tracing.  Because portext.asm must see the same
+setting, configUSE_CRITICAL_TRACE is set as a project predefined symbol
+(--define=configUSE_CRITICAL_TRACE=1) rather than in FreeRTOSConfig.h.  When
+set, every window during which interrupts are masked by a critical section,
+by vPortYield() or by the tick interrupt is timed, and the longest
+configCRITICAL_TRACE_RECORDS windows are kept together with the address of
+the code that masked interrupts and the tick count at that moment. */
+#ifndef configUSE_CRITICAL_TRACE
+	#define configUSE_CRITICAL_TRACE 0
+#endif
+
+#if( configUSE_CRITICAL_TRACE == 1 )
+
+	#ifndef configCRITICAL_TRACE_RECORDS
+		#define configCRITICAL_TRACE_RECORDS	( 4 )
+	#endif
+
+	typedef struct xCRITICAL_TRACE_RECORD
+	{
+		uint32_t ulAddress;		/*< Address of the code that masked interrupts, 0 if the window started by resuming a task inside a critical section. */
+		uint16_t usDuration;	/*< Length of the window in trace timer counts. */
+		TickType_t xTickCount;	/*< Tick count at the start of the window. */
+	} CriticalTraceRecord_t;
+
+	/* vPortTraceCriticalStart() is implemented in portext.asm, it passes the
+	address it was called from on to vPortTraceCriticalOpen(). */
+	extern void vPortTraceCriticalStart( void );
+	extern void vPortTraceCriticalClose( void );
+	extern UBaseType_t uxPortGetCriticalTrace( CriticalTraceRecord_t *pxRecords, UBaseType_t uxMaxRecords );
+	extern void vPortClearCriticalTrace( void );
+	extern void vPortReportCriticalTrace( void ( *pxPutString )( const char *pcString ) );
+
+	#define portTRACE_CRITICAL_ENTER()	if( usCriticalNesting == 1 ) vPortTraceCriticalStart()
+	#define portTRACE_CRITICAL_EXIT()	vPortTraceCriticalClose()
+#else
+	#define portTRACE_CRITICAL_ENTER()
+	#define portTRACE_CRITICAL_EXIT()
+#endif
+
 #define portENTER_CRITICAL()													\
 {																				\
 extern volatile uint16_t usCriticalNesting;										\
@@ -89,6 +148,7 @@ extern volatile uint16_t usCriticalNesting;										\
 	/* directly.  Increment ulCriticalNesting to keep a count of how many */	\
 	/* times portENTER_CRITICAL() has been called. */							\
 	usCriticalNesting++;														\
+	portTRACE_CRITICAL_ENTER();													\
 }
 
 #define portEXIT_CRITICAL()														\
@@ -104,10 +164,20 @@ extern volatile uint16_t usCriticalNesting;										\
 		/* re-enabled. */														\
 		if( usCriticalNesting == portNO_CRITICAL_SECTION_NESTING )				\
 		{																		\
+			portTRACE_CRITICAL_EXIT();											\
 			portENABLE_INTERRUPTS();											\
 		}																		\
 	}																			\
 }
+
+/* Interrupt mask save and restore for short kernel updates that never yield.
+The nesting count is not touched, so this is cheaper than a critical section
+and can be used from within one.  Not defined with critical tracing, then the
+kernel uses a critical section and every masked window is traced. */
+#if( configUSE_CRITICAL_TRACE == 0 )
+	#define portMASK_INTERRUPTS( uxSavedStatus )		{ ( uxSavedStatus ) = __get_interrupt_state(); portDISABLE_INTERRUPTS(); }
+	#define portRESTORE_INTERRUPTS( uxSavedStatus )		__set_interrupt_state( uxSavedStatus )
+#endif
 /*-----------------------------------------------------------*/
 
 /* Task utilities. */
@@ -119,6 +189,38 @@ extern void vPortYield( void );
 #define portYIELD() vPortYield()
 /*-----------------------------------------------------------*/
 
+/* Hardware multiplier context.  Like configUSE_CRITICAL_TRACE this is set as a
+project predefined symbol (--define=configUSE_MPY_CONTEXT=1) because
+portext.asm must see it.  The compiler's own multiplications are atomic, but
+code that uses the MPY32 registers directly over several statements (MAC
+sequences, see hal_dsp) is not safe under preemption.  A task that does so
+calls portTASK_USES_MPY() with a buffer that lives as long as the task.  The
+buffer is part of the task context, and the multiplier state is only swapped
+when a task with a buffer is switched in while the multiplier still holds the
+state of another task with a buffer - tasks without one never cost more than
+a pointer compare, and a single multiplier task never causes a swap.  SUMEXT
+is read only and can not be restored, read it before the next preemption
+point.  A task that is deleted must first call portTASK_USES_MPY( NULL ). */
+#ifndef configUSE_MPY_CONTEXT
+	#define configUSE_MPY_CONTEXT 0
+#endif
+
+#if( configUSE_MPY_CONTEXT == 1 )
+
+	typedef struct xMPY_CONTEXT
+	{
+		uint16_t usOperand1Low;		/*< OP1, the register it was written through is kept in MPYM. */
+		uint16_t usOperand1High;
+		uint16_t usResult[ 4 ];		/*< RES0 to RES3. */
+		uint16_t usControl;			/*< MPY32CTL0. */
+	} MPYContext_t;
+
+	extern void vPortTaskUsesMPY( MPYContext_t *pxContext );
+	#define portTASK_USES_MPY( pxContext ) vPortTaskUsesMPY( pxContext )
+
+#endif /* configUSE_MPY_CONTEXT */
+/*-----------------------------------------------------------*/
+
 /* Hardware specifics. */
 #define portBYTE_ALIGNMENT			2
 #define portSTACK_GROWTH			( -1 )
@@ -131,7 +233,18 @@ extern void vPortYield( void );
 #define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void *pvParameters )
 
 extern void vTaskSwitchContext( void );
-#define portYIELD_FROM_ISR( x ) if( x ) vPortYield()
+
+/* The interrupted task resumes through the reti of the interrupt, so if it
+was the idle task asleep in a low power mode the mode bits are cleared first,
+as the tick interrupt does, or it would go back to sleep when it runs again.
+Must be used directly in the interrupt function. */
+#define portLPM_BITS			( SCG1 + SCG0 + OSCOFF + CPUOFF )
+#define portYIELD_FROM_ISR( x )									\
+	if( x )														\
+	{															\
+		__bic_SR_register_on_exit( portLPM_BITS );				\
+		vPortYield();											\
+	}
 
 void vApplicationSetupTimerInterrupt( void );
 
@@ -128,6 +128,10 @@ typedef struct QueueDefinition 		/* The old naming convention is used to prevent
 		uint8_t ucQueueType;
 	#endif
 
+	#if ( configUSE_QUEUE_STATISTICS == 1 )
+		QueueStats_t xStats;		/*< Occupancy and contention counters, see vQueueGetStatistics(). */
+	#endif
+
 } xQUEUE;
 
 /* The old xQUEUE name is maintained above then typedefed to the new Queue_t
@@ -212,6 +216,37 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue, void * const pvBuffer
  */
 static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, uint8_t *pucQueueStorage, const uint8_t ucQueueType, Queue_t *pxNewQueue ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_QUEUE_STATISTICS == 1 )
+	/*
+	 * Called as a blocking send or receive call returns.  Adds the time the
+	 * caller spent blocked since xFirstBlockTime to the queue statistics and
+	 * counts failed sends.
+	 */
+	static void prvQueueStatsCallEnded( Queue_t * const pxQueue, const BaseType_t xSending, const BaseType_t xPassed, const BaseType_t xEntryTimeSet, const TickType_t xFirstBlockTime ) PRIVILEGED_FUNCTION;
+
+	/* The macros below are used from within critical sections or from
+	interrupts, other than queueSTATS_BLOCK_STARTED() and
+	queueSTATS_CALL_ENDED() which rely on the local variable names used by all
+	the blocking queue functions.  xTimeOut.xTimeOnEntering is set again every
+	time the call wakes without timing out, so the tick of the first block is
+	kept in xFirstBlockTime. */
+	#define queueSTATS_BLOCK_STARTED() xFirstBlockTime = xTimeOut.xTimeOnEntering
+	#define queueSTATS_CALL_ENDED( xSending, xPassed ) prvQueueStatsCallEnded( pxQueue, ( xSending ), ( xPassed ), xEntryTimeSet, xFirstBlockTime )
+	#define queueSTATS_SEND_FAILED_FROM_ISR( pxQueue ) ( ( pxQueue )->xStats.ulSendFailures++ )
+	#define queueSTATS_WAKEUP( pxQueue ) ( ( pxQueue )->xStats.ulWakeups++ )
+	#define queueSTATS_UPDATE_PEAK( pxQueue )												\
+		if( ( pxQueue )->uxMessagesWaiting > ( pxQueue )->xStats.uxPeakMessagesWaiting )	\
+		{																					\
+			( pxQueue )->xStats.uxPeakMessagesWaiting = ( pxQueue )->uxMessagesWaiting;	\
+		}
+#else
+	#define queueSTATS_BLOCK_STARTED()
+	#define queueSTATS_CALL_ENDED( xSending, xPassed )
+	#define queueSTATS_SEND_FAILED_FROM_ISR( pxQueue )
+	#define queueSTATS_WAKEUP( pxQueue )
+	#define queueSTATS_UPDATE_PEAK( pxQueue )
+#endif
+
 /*
  * Mutexes are a special type of queue.  When a mutex is created, first the
  * queue is created, then prvInitialiseMutex() is called to configure the queue
@@ -276,6 +311,7 @@ Queue_t * const pxQueue = xQueue;
 			it will be possible to write to it. */
 			if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
 			{
+				queueSTATS_WAKEUP( pxQueue );
 				if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
 				{
 					queueYIELD_IF_USING_PREEMPTION();
@@ -464,6 +500,12 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseT
 	}
 	#endif /* configUSE_QUEUE_SETS */
 
+	#if( configUSE_QUEUE_STATISTICS == 1 )
+	{
+		( void ) memset( ( void * ) &( pxNewQueue->xStats ), 0x00, sizeof( QueueStats_t ) );
+	}
+	#endif /* configUSE_QUEUE_STATISTICS */
+
 	traceQUEUE_CREATE( pxNewQueue );
 }
 /*-----------------------------------------------------------*/
@@ -750,6 +792,10 @@ BaseType_t xEntryTimeSet = pdFALSE, xYieldRequired;
 TimeOut_t xTimeOut;
 Queue_t * const pxQueue = xQueue;
 
+#if( configUSE_QUEUE_STATISTICS == 1 )
+	TickType_t xFirstBlockTime = ( TickType_t ) 0U;
+#endif
+
 	configASSERT( pxQueue );
 	configASSERT( !( ( pvItemToQueue == NULL ) && ( pxQueue->uxItemSize != ( UBaseType_t ) 0U ) ) );
 	configASSERT( !( ( xCopyPosition == queueOVERWRITE ) && ( pxQueue->uxLength != 1 ) ) );
@@ -808,6 +854,7 @@ Queue_t * const pxQueue = xQueue;
 						queue then unblock it now. */
 						if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
 						{
+							queueSTATS_WAKEUP( pxQueue );
 							if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 							{
 								/* The unblocked task has a priority higher than
@@ -843,6 +890,7 @@ Queue_t * const pxQueue = xQueue;
 					queue then unblock it now. */
 					if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
 					{
+						queueSTATS_WAKEUP( pxQueue );
 						if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 						{
 							/* The unblocked task has a priority higher than
@@ -871,6 +919,7 @@ Queue_t * const pxQueue = xQueue;
 				}
 				#endif /* configUSE_QUEUE_SETS */
 
+				queueSTATS_CALL_ENDED( pdTRUE, pdPASS );
 				taskEXIT_CRITICAL();
 				return pdPASS;
 			}
@@ -884,6 +933,7 @@ Queue_t * const pxQueue = xQueue;
 
 					/* Return to the original privilege level before exiting
 					the function. */
+					queueSTATS_CALL_ENDED( pdTRUE, pdFAIL );
 					traceQUEUE_SEND_FAILED( pxQueue );
 					return errQUEUE_FULL;
 				}
@@ -893,6 +943,7 @@ Queue_t * const pxQueue = xQueue;
 					configure the timeout structure. */
 					vTaskInternalSetTimeOutState( &xTimeOut );
 					xEntryTimeSet = pdTRUE;
+					queueSTATS_BLOCK_STARTED();
 				}
 				else
 				{
@@ -947,6 +998,7 @@ Queue_t * const pxQueue = xQueue;
 			prvUnlockQueue( pxQueue );
 			( void ) xTaskResumeAll();
 
+			queueSTATS_CALL_ENDED( pdTRUE, pdFAIL );
 			traceQUEUE_SEND_FAILED( pxQueue );
 			return errQUEUE_FULL;
 		}
@@ -1031,6 +1083,7 @@ Queue_t * const pxQueue = xQueue;
 					{
 						if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
 						{
+							queueSTATS_WAKEUP( pxQueue );
 							if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 							{
 								/* The task waiting has a higher priority so
@@ -1059,6 +1112,7 @@ Queue_t * const pxQueue = xQueue;
 				{
 					if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
 					{
+						queueSTATS_WAKEUP( pxQueue );
 						if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 						{
 							/* The task waiting has a higher priority so record that a
@@ -1096,6 +1150,7 @@ Queue_t * const pxQueue = xQueue;
 		else
 		{
 			traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+			queueSTATS_SEND_FAILED_FROM_ISR( pxQueue );
 			xReturn = errQUEUE_FULL;
 		}
 	}
@@ -1164,6 +1219,7 @@ Queue_t * const pxQueue = xQueue;
 			priority disinheritance is needed.  Simply increase the count of
 			messages (semaphores) available. */
 			pxQueue->uxMessagesWaiting = uxMessagesWaiting + ( UBaseType_t ) 1;
+			queueSTATS_UPDATE_PEAK( pxQueue );
 
 			/* The event list is not altered if the queue is locked.  This will
 			be done when the queue is unlocked later. */
@@ -1196,6 +1252,7 @@ Queue_t * const pxQueue = xQueue;
 					{
 						if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
 						{
+							queueSTATS_WAKEUP( pxQueue );
 							if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 							{
 								/* The task waiting has a higher priority so
@@ -1224,6 +1281,7 @@ Queue_t * const pxQueue = xQueue;
 				{
 					if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
 					{
+						queueSTATS_WAKEUP( pxQueue );
 						if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 						{
 							/* The task waiting has a higher priority so record that a
@@ -1261,6 +1319,7 @@ Queue_t * const pxQueue = xQueue;
 		else
 		{
 			traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+			queueSTATS_SEND_FAILED_FROM_ISR( pxQueue );
 			xReturn = errQUEUE_FULL;
 		}
 	}
@@ -1276,6 +1335,10 @@ BaseType_t xEntryTimeSet = pdFALSE;
 TimeOut_t xTimeOut;
 Queue_t * const pxQueue = xQueue;
 
+#if( configUSE_QUEUE_STATISTICS == 1 )
+	TickType_t xFirstBlockTime = ( TickType_t ) 0U;
+#endif
+
 	/* Check the pointer is not NULL. */
 	configASSERT( ( pxQueue ) );
 
@@ -1314,6 +1377,7 @@ Queue_t * const pxQueue = xQueue;
 				task. */
 				if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
 				{
+					queueSTATS_WAKEUP( pxQueue );
 					if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
 					{
 						queueYIELD_IF_USING_PREEMPTION();
@@ -1328,6 +1392,7 @@ Queue_t * const pxQueue = xQueue;
 					mtCOVERAGE_TEST_MARKER();
 				}
 
+				queueSTATS_CALL_ENDED( pdFALSE, pdPASS );
 				taskEXIT_CRITICAL();
 				return pdPASS;
 			}
@@ -1338,6 +1403,7 @@ Queue_t * const pxQueue = xQueue;
 					/* The queue was empty and no block time is specified (or
 					the block time has expired) so leave now. */
 					taskEXIT_CRITICAL();
+					queueSTATS_CALL_ENDED( pdFALSE, pdFAIL );
 					traceQUEUE_RECEIVE_FAILED( pxQueue );
 					return errQUEUE_EMPTY;
 				}
@@ -1347,6 +1413,7 @@ Queue_t * const pxQueue = xQueue;
 					configure the timeout structure. */
 					vTaskInternalSetTimeOutState( &xTimeOut );
 					xEntryTimeSet = pdTRUE;
+					queueSTATS_BLOCK_STARTED();
 				}
 				else
 				{
@@ -1399,6 +1466,7 @@ Queue_t * const pxQueue = xQueue;
 
 			if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
 			{
+				queueSTATS_CALL_ENDED( pdFALSE, pdFAIL );
 				traceQUEUE_RECEIVE_FAILED( pxQueue );
 				return errQUEUE_EMPTY;
 			}
@@ -1421,6 +1489,10 @@ Queue_t * const pxQueue = xQueue;
 	BaseType_t xInheritanceOccurred = pdFALSE;
 #endif
 
+#if( configUSE_QUEUE_STATISTICS == 1 )
+	TickType_t xFirstBlockTime = ( TickType_t ) 0U;
+#endif
+
 	/* Check the queue pointer is not NULL. */
 	configASSERT( ( pxQueue ) );
 
@@ -1476,6 +1548,7 @@ Queue_t * const pxQueue = xQueue;
 				semaphore, and if so, unblock the highest priority such task. */
 				if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
 				{
+					queueSTATS_WAKEUP( pxQueue );
 					if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
 					{
 						queueYIELD_IF_USING_PREEMPTION();
@@ -1490,6 +1563,7 @@ Queue_t * const pxQueue = xQueue;
 					mtCOVERAGE_TEST_MARKER();
 				}
 
+				queueSTATS_CALL_ENDED( pdFALSE, pdPASS );
 				taskEXIT_CRITICAL();
 				return pdPASS;
 			}
@@ -1509,6 +1583,7 @@ Queue_t * const pxQueue = xQueue;
 					/* The semaphore count was 0 and no block time is specified
 					(or the block time has expired) so exit now. */
 					taskEXIT_CRITICAL();
+					queueSTATS_CALL_ENDED( pdFALSE, pdFAIL );
 					traceQUEUE_RECEIVE_FAILED( pxQueue );
 					return errQUEUE_EMPTY;
 				}
@@ -1518,6 +1593,7 @@ Queue_t * const pxQueue = xQueue;
 					so configure the timeout structure ready to block. */
 					vTaskInternalSetTimeOutState( &xTimeOut );
 					xEntryTimeSet = pdTRUE;
+					queueSTATS_BLOCK_STARTED();
 				}
 				else
 				{
@@ -1617,6 +1693,7 @@ Queue_t * const pxQueue = xQueue;
 				}
 				#endif /* configUSE_MUTEXES */
 
+				queueSTATS_CALL_ENDED( pdFALSE, pdFAIL );
 				traceQUEUE_RECEIVE_FAILED( pxQueue );
 				return errQUEUE_EMPTY;
 			}
@@ -1636,6 +1713,10 @@ TimeOut_t xTimeOut;
 int8_t *pcOriginalReadPosition;
 Queue_t * const pxQueue = xQueue;
 
+#if( configUSE_QUEUE_STATISTICS == 1 )
+	TickType_t xFirstBlockTime = ( TickType_t ) 0U;
+#endif
+
 	/* Check the pointer is not NULL. */
 	configASSERT( ( pxQueue ) );
 
@@ -1679,6 +1760,7 @@ Queue_t * const pxQueue = xQueue;
 				any other tasks waiting for the data. */
 				if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
 				{
+					queueSTATS_WAKEUP( pxQueue );
 					if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 					{
 						/* The task waiting has a higher priority than this task. */
@@ -1694,6 +1776,7 @@ Queue_t * const pxQueue = xQueue;
 					mtCOVERAGE_TEST_MARKER();
 				}
 
+				queueSTATS_CALL_ENDED( pdFALSE, pdPASS );
 				taskEXIT_CRITICAL();
 				return pdPASS;
 			}
@@ -1704,6 +1787,7 @@ Queue_t * const pxQueue = xQueue;
 					/* The queue was empty and no block time is specified (or
 					the block time has expired) so leave now. */
 					taskEXIT_CRITICAL();
+					queueSTATS_CALL_ENDED( pdFALSE, pdFAIL );
 					traceQUEUE_PEEK_FAILED( pxQueue );
 					return errQUEUE_EMPTY;
 				}
@@ -1714,6 +1798,7 @@ Queue_t * const pxQueue = xQueue;
 					state. */
 					vTaskInternalSetTimeOutState( &xTimeOut );
 					xEntryTimeSet = pdTRUE;
+					queueSTATS_BLOCK_STARTED();
 				}
 				else
 				{
@@ -1766,6 +1851,7 @@ Queue_t * const pxQueue = xQueue;
 
 			if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
 			{
+				queueSTATS_CALL_ENDED( pdFALSE, pdFAIL );
 				traceQUEUE_PEEK_FAILED( pxQueue );
 				return errQUEUE_EMPTY;
 			}
@@ -1825,6 +1911,7 @@ Queue_t * const pxQueue = xQueue;
 			{
 				if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
 				{
+					queueSTATS_WAKEUP( pxQueue );
 					if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
 					{
 						/* The task waiting has a higher priority than us so
@@ -2141,6 +2228,7 @@ UBaseType_t uxMessagesWaiting;
 	}
 
 	pxQueue->uxMessagesWaiting = uxMessagesWaiting + ( UBaseType_t ) 1;
+	queueSTATS_UPDATE_PEAK( pxQueue );
 
 	return xReturn;
 }
@@ -2204,6 +2292,7 @@ static void prvUnlockQueue( Queue_t * const pxQueue )
 					suspended. */
 					if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
 					{
+						queueSTATS_WAKEUP( pxQueue );
 						if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 						{
 							/* The task waiting has a higher priority so record that a
@@ -2227,6 +2316,7 @@ static void prvUnlockQueue( Queue_t * const pxQueue )
 				the pending ready list as the scheduler is still suspended. */
 				if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
 				{
+					queueSTATS_WAKEUP( pxQueue );
 					if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
 					{
 						/* The task waiting has a higher priority so record that
@@ -2261,6 +2351,7 @@ static void prvUnlockQueue( Queue_t * const pxQueue )
 		{
 			if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
 			{
+				queueSTATS_WAKEUP( pxQueue );
 				if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
 				{
 					vTaskMissedYield();
@@ -2728,6 +2819,134 @@ Queue_t * const pxQueue = xQueue;
 #endif /* configQUEUE_REGISTRY_SIZE */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_STATISTICS == 1 )
+
+	static void prvQueueStatsCallEnded( Queue_t * const pxQueue, const BaseType_t xSending, const BaseType_t xPassed, const BaseType_t xEntryTimeSet, const TickType_t xFirstBlockTime )
+	{
+	uint32_t ulBlockedTicks = 0UL;
+
+		taskENTER_CRITICAL();
+		{
+			/* xFirstBlockTime is only valid if the call got as far as
+			preparing to block. */
+			if( xEntryTimeSet != pdFALSE )
+			{
+				ulBlockedTicks = ( uint32_t ) ( TickType_t ) ( xTaskGetTickCount() - xFirstBlockTime );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( xSending != pdFALSE )
+			{
+				pxQueue->xStats.ulSendBlockedTicks += ulBlockedTicks;
+
+				if( xPassed == pdFALSE )
+				{
+					pxQueue->xStats.ulSendFailures++;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				pxQueue->xStats.ulReceiveBlockedTicks += ulBlockedTicks;
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+
+#endif /* configUSE_QUEUE_STATISTICS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_STATISTICS == 1 )
+
+	void vQueueGetStatistics( QueueHandle_t xQueue, QueueStats_t *pxStats )
+	{
+	Queue_t * const pxQueue = xQueue;
+
+		configASSERT( pxQueue );
+		configASSERT( pxStats );
+
+		taskENTER_CRITICAL();
+		{
+			*pxStats = pxQueue->xStats;
+		}
+		taskEXIT_CRITICAL();
+	}
+
+#endif /* configUSE_QUEUE_STATISTICS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_STATISTICS == 1 )
+
+	void vQueueResetStatistics( QueueHandle_t xQueue )
+	{
+	Queue_t * const pxQueue = xQueue;
+
+		configASSERT( pxQueue );
+
+		taskENTER_CRITICAL();
+		{
+			( void ) memset( ( void * ) &( pxQueue->xStats ), 0x00, sizeof( QueueStats_t ) );
+			pxQueue->xStats.uxPeakMessagesWaiting = pxQueue->uxMessagesWaiting;
+		}
+		taskEXIT_CRITICAL();
+	}
+
+#endif /* configUSE_QUEUE_STATISTICS */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_QUEUE_STATISTICS == 1 ) && ( configQUEUE_REGISTRY_SIZE > 0 ) )
+
+	UBaseType_t uxQueueGetRegistryStatistics( QueueRegistryStats_t * const pxArray, const UBaseType_t uxArraySize )
+	{
+	UBaseType_t ux, uxEntries = 0;
+	Queue_t *pxQueue;
+
+		configASSERT( pxArray );
+
+		/* Registry entries are added and removed outside of critical
+		sections, so the registry is scanned with the scheduler suspended.
+		Each queue's counters are copied inside a critical section so they are
+		consistent with each other. */
+		vTaskSuspendAll();
+		{
+			for( ux = ( UBaseType_t ) 0U; ( ux < ( UBaseType_t ) configQUEUE_REGISTRY_SIZE ) && ( uxEntries < uxArraySize ); ux++ )
+			{
+				if( xQueueRegistry[ ux ].pcQueueName != NULL )
+				{
+					pxQueue = xQueueRegistry[ ux ].xHandle;
+
+					pxArray[ uxEntries ].pcQueueName = xQueueRegistry[ ux ].pcQueueName;
+					pxArray[ uxEntries ].xHandle = pxQueue;
+					pxArray[ uxEntries ].uxLength = pxQueue->uxLength;
+
+					taskENTER_CRITICAL();
+					{
+						pxArray[ uxEntries ].xStats = pxQueue->xStats;
+					}
+					taskEXIT_CRITICAL();
+
+					uxEntries++;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		( void ) xTaskResumeAll();
+
+		return uxEntries;
+	}
+
+#endif /* configUSE_QUEUE_STATISTICS && configQUEUE_REGISTRY_SIZE */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_TIMERS == 1 )
 
 	void vQueueWaitForMessageRestricted( QueueHandle_t xQueue, TickType_t xTicksToWait, const BaseType_t xWaitIndefinitely )
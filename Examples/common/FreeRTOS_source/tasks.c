@@ -64,11 +64,24 @@ functions but without including stdio.h here. */
 	#define taskYIELD_IF_USING_PREEMPTION() portYIELD_WITHIN_API()
 #endif
 
-/* Values that can be assigned to the ucNotifyState member of the TCB. */
+/* Values that can be assigned to the ucNotifyState members of the TCB. */
 #define taskNOT_WAITING_NOTIFICATION	( ( uint8_t ) 0 )
 #define taskWAITING_NOTIFICATION		( ( uint8_t ) 1 )
 #define taskNOTIFICATION_RECEIVED		( ( uint8_t ) 2 )
 
+/* Notifying a task that is not waiting for the notification only changes the
+notification value and state, which needs interrupts masked for a few
+instructions but not a full critical section.  Ports that can save and restore
+the interrupt mask cheaply define portMASK_INTERRUPTS() and
+portRESTORE_INTERRUPTS(), others use a critical section. */
+#ifdef portMASK_INTERRUPTS
+	#define taskMASK_NOTIFY_UPDATE( uxSavedInterruptStatus )		portMASK_INTERRUPTS( uxSavedInterruptStatus )
+	#define taskRESTORE_NOTIFY_UPDATE( uxSavedInterruptStatus )	portRESTORE_INTERRUPTS( uxSavedInterruptStatus )
+#else
+	#define taskMASK_NOTIFY_UPDATE( uxSavedInterruptStatus )		{ ( uxSavedInterruptStatus ) = 0; taskENTER_CRITICAL(); }
+	#define taskRESTORE_NOTIFY_UPDATE( uxSavedInterruptStatus )	{ ( void ) ( uxSavedInterruptStatus ); taskEXIT_CRITICAL(); }
+#endif
+
 /*
  * The value used to fill the stack of a task when the task is created.  This
  * is used purely for checking the high water mark for tasks.
@@ -142,8 +155,9 @@ configIDLE_TASK_NAME in FreeRTOSConfig.h. */
 		}																								\
 																										\
 		/* listGET_OWNER_OF_NEXT_ENTRY indexes through the list, so the tasks of						\
-		the	same priority get an equal share of the processor time. */									\
-		listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );			\
+		the	same priority get an equal share of the processor time, unless they						\
+		are ordered by deadline. */																		\
+		taskSELECT_FROM_READY_LIST( &( pxReadyTasksLists[ uxTopPriority ] ) );							\
 		uxTopReadyPriority = uxTopPriority;																\
 	} /* taskSELECT_HIGHEST_PRIORITY_TASK */
 
@@ -173,7 +187,7 @@ configIDLE_TASK_NAME in FreeRTOSConfig.h. */
 		/* Find the highest priority list that contains ready tasks. */								\
 		portGET_HIGHEST_PRIORITY( uxTopPriority, uxTopReadyPriority );								\
 		configASSERT( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ uxTopPriority ] ) ) > 0 );		\
-		listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );		\
+		taskSELECT_FROM_READY_LIST( &( pxReadyTasksLists[ uxTopPriority ] ) );						\
 	} /* taskSELECT_HIGHEST_PRIORITY_TASK() */
 
 	/*-----------------------------------------------------------*/
@@ -193,6 +207,72 @@ configIDLE_TASK_NAME in FreeRTOSConfig.h. */
 
 /*-----------------------------------------------------------*/
 
+/* With configUSE_EDF_SCHEDULING set to 1 the ready tasks of the highest
+priority do not share the processor round robin.  The one with the earliest
+absolute deadline runs, and tasks without a deadline only run when no ready task
+of their priority has one.  The jobs of a periodic task are released by
+xTaskWaitForNextRelease() at their nominal release times, so blocking within a
+job leaves its deadline alone.  Any other task releases a job, and gets its
+absolute deadline set, each time it leaves the Blocked or Suspended state.
+Deadlines are
+compared to each other rather than to zero, so they can overflow as long as no
+two of them are more than half the TickType_t range apart. */
+#if( configUSE_EDF_SCHEDULING == 1 )
+
+	#define taskDEADLINE_IS_EARLIER( pxTCBA, pxTCBB )																\
+		( ( ( pxTCBA )->xRelativeDeadline != ( TickType_t ) 0 ) &&												\
+		  ( ( ( pxTCBB )->xRelativeDeadline == ( TickType_t ) 0 ) ||												\
+			( ( TickType_t ) ( ( pxTCBA )->xAbsoluteDeadline - ( pxTCBB )->xAbsoluteDeadline ) > ( portMAX_DELAY >> 1 ) ) ) )
+
+	#define taskSELECT_FROM_READY_LIST( pxList )	pxCurrentTCB = prvSelectEarliestDeadlineTask( pxList )
+
+	#define taskSET_JOB_DEADLINE( pxTCB, xReleaseTime )														\
+	{																										\
+		( pxTCB )->xAbsoluteDeadline = ( xReleaseTime ) + ( pxTCB )->xRelativeDeadline;						\
+		( pxTCB )->ucDeadlineMissed = pdFALSE;																\
+	}
+
+	/* Used where a task leaves the Blocked or Suspended state. */
+	#define taskRELEASE_JOB( pxTCB, xReleaseTime )															\
+	{																										\
+		if( ( pxTCB )->ucPeriodic == pdFALSE )																\
+		{																									\
+			taskSET_JOB_DEADLINE( ( pxTCB ), ( xReleaseTime ) );											\
+		}																									\
+	}
+
+	/* Used where a task made ready only preempts the running task if its
+	priority is higher. */
+	#define taskIS_MORE_URGENT( pxTCB )																		\
+		( ( ( pxTCB )->uxPriority > pxCurrentTCB->uxPriority ) ||											\
+		  ( ( ( pxTCB )->uxPriority == pxCurrentTCB->uxPriority ) && taskDEADLINE_IS_EARLIER( ( pxTCB ), pxCurrentTCB ) ) )
+
+#else
+
+	#define taskSELECT_FROM_READY_LIST( pxList )	listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, ( pxList ) )
+	#define taskSET_JOB_DEADLINE( pxTCB, xReleaseTime )
+	#define taskRELEASE_JOB( pxTCB, xReleaseTime )
+	#define taskIS_MORE_URGENT( pxTCB )				( ( pxTCB )->uxPriority > pxCurrentTCB->uxPriority )
+
+#endif /* configUSE_EDF_SCHEDULING */
+
+/*-----------------------------------------------------------*/
+
+/* With configDELAYED_LIST_BUCKETS above 1 each delayed list is an array of
+buckets, and a task is kept in the bucket selected by the low bits of its wake
+time.  Every bucket is still sorted by wake time, so an insertion only walks
+the tasks of one bucket, and the head of the bucket of xNextTaskUnblockTime is
+always the next task to unblock. */
+#if( configDELAYED_LIST_BUCKETS > 1 )
+	#define taskDELAYED_BUCKET( pxList, xTime )				( &( ( pxList )[ ( xTime ) & ( ( TickType_t ) configDELAYED_LIST_BUCKETS - ( TickType_t ) 1 ) ] ) )
+	#define taskIS_DELAYED_LIST( pxStateList, pxList )		( ( ( pxStateList ) >= ( pxList ) ) && ( ( pxStateList ) < &( ( pxList )[ configDELAYED_LIST_BUCKETS ] ) ) )
+	#define taskDELAYED_LIST_IS_EMPTY( pxList )				prvDelayedListIsEmpty( pxList )
+#else
+	#define taskDELAYED_BUCKET( pxList, xTime )				( pxList )
+	#define taskIS_DELAYED_LIST( pxStateList, pxList )		( ( pxStateList ) == ( pxList ) )
+	#define taskDELAYED_LIST_IS_EMPTY( pxList )				listLIST_IS_EMPTY( pxList )
+#endif
+
 /* pxDelayedTaskList and pxOverflowDelayedTaskList are switched when the tick
 count overflows. */
 #define taskSWITCH_DELAYED_LISTS()																	\
@@ -200,7 +280,7 @@ count overflows. */
 	List_t *pxTemp;																					\
 																									\
 	/* The delayed tasks list should be empty when the lists are switched. */						\
-	configASSERT( ( listLIST_IS_EMPTY( pxDelayedTaskList ) ) );										\
+	configASSERT( ( taskDELAYED_LIST_IS_EMPTY( pxDelayedTaskList ) ) );								\
 																									\
 	pxTemp = pxDelayedTaskList;																		\
 	pxDelayedTaskList = pxOverflowDelayedTaskList;													\
@@ -222,6 +302,73 @@ count overflows. */
 	tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB )
 /*-----------------------------------------------------------*/
 
+/* A task readied while the scheduler is suspended is held until
+xTaskResumeAll().  With configUSE_BATCHED_WAKEUPS every task gets one bit of
+uxPendingWakeups when it is created, so an interrupt only sets the bit and
+xTaskResumeAll() moves all the tasks to the ready lists in one pass over the
+bits, instead of a list insertion and removal per task.  Tasks created after
+all the bits are taken use xPendingReadyList as before.  Called with interrupts
+masked. */
+#if( configUSE_BATCHED_WAKEUPS == 1 )
+
+	#define taskWAKEUP_BITS		( sizeof( UBaseType_t ) * ( size_t ) 8 )
+
+	#define taskPEND_WAKEUP( pxTCB )																	\
+	{																								\
+		if( ( pxTCB )->uxWakeupBit != ( UBaseType_t ) 0U )											\
+		{																							\
+			uxPendingWakeups |= ( pxTCB )->uxWakeupBit;												\
+		}																							\
+		else																						\
+		{																							\
+			vListInsertEnd( &( xPendingReadyList ), &( ( pxTCB )->xEventListItem ) );				\
+		}																							\
+	}
+
+	#define taskCANCEL_WAKEUP( pxTCB )		uxPendingWakeups &= ~( ( pxTCB )->uxWakeupBit )
+	#define taskIS_WAKEUP_PENDING( pxTCB )	( ( uxPendingWakeups & ( pxTCB )->uxWakeupBit ) != ( UBaseType_t ) 0U )
+	#define taskANY_WAKEUP_PENDING()		( uxPendingWakeups != ( UBaseType_t ) 0U )
+
+#else
+
+	#define taskPEND_WAKEUP( pxTCB )		vListInsertEnd( &( xPendingReadyList ), &( ( pxTCB )->xEventListItem ) )
+	#define taskCANCEL_WAKEUP( pxTCB )
+	#define taskIS_WAKEUP_PENDING( pxTCB )	( pdFALSE )
+	#define taskANY_WAKEUP_PENDING()		( pdFALSE )
+
+#endif /* configUSE_BATCHED_WAKEUPS */
+/*-----------------------------------------------------------*/
+
+/* States of the current job of a periodic task.  A job is released by the
+tick, or at once if it was due before the previous job completed, and starts
+when the task first runs after that. */
+#define tskJOB_NONE			( ( uint8_t ) 0 )
+#define tskJOB_WAITING		( ( uint8_t ) 1 )
+#define tskJOB_RELEASED		( ( uint8_t ) 2 )
+#define tskJOB_RUNNING		( ( uint8_t ) 3 )
+
+#if( configUSE_PERIODIC_TASKS == 1 )
+
+	/* Used where a task leaves the Blocked or Suspended state.  A periodic
+	task waiting for its next release is normally unblocked by the tick at the
+	release time, but xTaskAbortDelay() or vTaskSuspend() followed by
+	vTaskResume() release the job early. */
+	#define taskRELEASE_PERIODIC_JOB( pxTCB )																\
+	{																										\
+		if( ( pxTCB )->ucJobState == tskJOB_WAITING )														\
+		{																									\
+			( pxTCB )->ulReleaseTimestamp = configPERIODIC_STATS_TIME();									\
+			( pxTCB )->ucJobState = tskJOB_RELEASED;														\
+			( ( pxTCB )->ulReleases )++;																	\
+		}																									\
+	}
+
+#else
+
+	#define taskRELEASE_PERIODIC_JOB( pxTCB )
+
+#endif /* configUSE_PERIODIC_TASKS */
+
 /*
  * Several functions take an TaskHandle_t parameter that can optionally be NULL,
  * where NULL is used to indicate that the handle of the currently executing
@@ -305,8 +452,8 @@ typedef struct tskTaskControlBlock 			/* The old naming convention is used to pr
 	#endif
 
 	#if( configUSE_TASK_NOTIFICATIONS == 1 )
-		volatile uint32_t ulNotifiedValue;
-		volatile uint8_t ucNotifyState;
+		volatile uint32_t ulNotifiedValue[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
+		volatile uint8_t ucNotifyState[ configTASK_NOTIFICATION_ARRAY_ENTRIES ];
 	#endif
 
 	/* See the comments in FreeRTOS.h with the definition of
@@ -323,6 +470,28 @@ typedef struct tskTaskControlBlock 			/* The old naming convention is used to pr
 		int iTaskErrno;
 	#endif
 
+	#if( configUSE_EDF_SCHEDULING == 1 )
+		TickType_t		xRelativeDeadline;	/*< Deadline of each job relative to its release, 0 if the task has no deadline. */
+		TickType_t		xAbsoluteDeadline;	/*< Deadline of the current job. */
+		UBaseType_t		uxDeadlineMisses;	/*< Number of jobs that were still running after their deadline. */
+		uint8_t			ucDeadlineMissed;	/*< Set to pdTRUE once the current job has been counted as a miss. */
+		uint8_t			ucPeriodic;			/*< Set to pdTRUE once the task calls xTaskWaitForNextRelease(). */
+	#endif
+
+	#if( configUSE_PERIODIC_TASKS == 1 )
+		TickType_t		xPeriod;			/*< Period passed to the last xTaskWaitForNextRelease() call, 0 if the task is not periodic. */
+		uint32_t		ulReleaseTimestamp;	/*< configPERIODIC_STATS_TIME() when the current job was released. */
+		uint32_t		ulReleases;
+		uint32_t		ulOverruns;
+		uint32_t		ulMaxReleaseJitter;
+		uint32_t		ulMaxResponseTime;
+		uint8_t			ucJobState;			/*< One of the tskJOB_ values. */
+	#endif
+
+	#if( configUSE_BATCHED_WAKEUPS == 1 )
+		UBaseType_t		uxWakeupBit;		/*< Bit of the task in uxPendingWakeups, 0 if all bits were taken when the task was created. */
+	#endif
+
 } tskTCB;
 
 /* The old tskTCB name is maintained above then typedefed to the new TCB_t name
@@ -338,12 +507,20 @@ xDelayedTaskList1 and xDelayedTaskList2 could be move to function scople but
 doing so breaks some kernel aware debuggers and debuggers that rely on removing
 the static qualifier. */
 PRIVILEGED_DATA static List_t pxReadyTasksLists[ configMAX_PRIORITIES ];/*< Prioritised ready tasks. */
-PRIVILEGED_DATA static List_t xDelayedTaskList1;						/*< Delayed tasks. */
-PRIVILEGED_DATA static List_t xDelayedTaskList2;						/*< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
-PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;				/*< Points to the delayed task list currently being used. */
-PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;		/*< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
+PRIVILEGED_DATA static List_t xDelayedTaskList1[ configDELAYED_LIST_BUCKETS ];	/*< Delayed tasks. */
+PRIVILEGED_DATA static List_t xDelayedTaskList2[ configDELAYED_LIST_BUCKETS ];	/*< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
+PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;				/*< Points to the (first bucket of the) delayed task list currently being used. */
+PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;		/*< Points to the (first bucket of the) delayed task list currently being used to hold tasks that have overflowed the current tick count. */
 PRIVILEGED_DATA static List_t xPendingReadyList;						/*< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
 
+#if( configUSE_BATCHED_WAKEUPS == 1 )
+
+	PRIVILEGED_DATA static volatile UBaseType_t uxPendingWakeups = ( UBaseType_t ) 0U;	/*< Bits of the tasks that have been readied while the scheduler was suspended. */
+	PRIVILEGED_DATA static UBaseType_t uxWakeupBitsInUse = ( UBaseType_t ) 0U;
+	PRIVILEGED_DATA static TCB_t * pxWakeupBitOwners[ taskWAKEUP_BITS ];		/*< Task that holds each bit. */
+
+#endif
+
 #if( INCLUDE_vTaskDelete == 1 )
 
 	PRIVILEGED_DATA static List_t xTasksWaitingTermination;				/*< Tasks that have been deleted - but their memory not yet freed. */
@@ -475,6 +652,67 @@ static void prvCheckTasksWaitingTermination( void ) PRIVILEGED_FUNCTION;
  */
 static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait, const BaseType_t xCanBlockIndefinitely ) PRIVILEGED_FUNCTION;
 
+#if( configUSE_EDF_SCHEDULING == 1 )
+
+	/*
+	 * Returns the task of pxList that has the earliest deadline, or the next task
+	 * of pxList in round robin order if no task in the list has a deadline.
+	 */
+	static TCB_t *prvSelectEarliestDeadlineTask( List_t * const pxList ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Counts a miss if the job of the calling task is still running after its
+	 * deadline.  Returns pdTRUE if the current job has missed its deadline.
+	 */
+	static BaseType_t prvCheckDeadline( const TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if( ( configUSE_EDF_SCHEDULING == 1 ) || ( configUSE_PERIODIC_TASKS == 1 ) )
+
+	/*
+	 * Sets the deadline of the job the calling task releases at xReleaseTime,
+	 * and blocks the task until then.  Returns pdFALSE, without blocking, if
+	 * xReleaseTime is not in the future.  Called with the scheduler suspended.
+	 */
+	static BaseType_t prvDelayUntilRelease( const TickType_t xReleaseTime, const TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if( configUSE_PERIODIC_TASKS == 1 )
+
+	/*
+	 * Clears the periodic task statistics of pxTCB.
+	 */
+	static void prvResetPeriodicStats( TCB_t * const pxTCB ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Records the response time of the job the calling task completes, and the
+	 * period it runs at.  Called with the scheduler suspended.
+	 */
+	static void prvCompletePeriodicJob( const TickType_t xPeriod ) PRIVILEGED_FUNCTION;
+
+	/*
+	 * Releases the next job of the calling task at once when it was already
+	 * due, at xReleaseTime, before the previous job completed.  Called with the
+	 * scheduler suspended.
+	 */
+	static void prvReleaseOverrunJob( const TickType_t xReleaseTime, const TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if( configUSE_TASK_NOTIFICATIONS == 1 )
+
+	/*
+	 * Applies eAction to notification uxIndexToNotify of pxTCB and marks the
+	 * notification as received.  ucOriginalNotifyState is the state before the
+	 * call.  Returns pdFAIL if eSetValueWithoutOverwrite could not write the
+	 * value.  Called with interrupts masked.
+	 */
+	static BaseType_t prvSetNotifiedValue( TCB_t * const pxTCB, const UBaseType_t uxIndexToNotify, const uint32_t ulValue, const eNotifyAction eAction, const uint8_t ucOriginalNotifyState, uint32_t * const pulPreviousNotificationValue ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /*
  * Fills an TaskStatus_t structure with information on each task that is
  * referenced from the pxList list (which may be a ready list, a delayed list,
@@ -531,6 +769,15 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait, const BaseT
  */
 static void prvResetNextTaskUnblockTime( void );
 
+#if( configDELAYED_LIST_BUCKETS > 1 )
+
+	/*
+	 * Returns pdTRUE if no bucket of the delayed list pxList holds a task.
+	 */
+	static BaseType_t prvDelayedListIsEmpty( const List_t *pxList ) PRIVILEGED_FUNCTION;
+
+#endif
+
 #if ( ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
 
 	/*
@@ -986,8 +1233,8 @@ UBaseType_t x;
 
 	#if ( configUSE_TASK_NOTIFICATIONS == 1 )
 	{
-		pxNewTCB->ulNotifiedValue = 0;
-		pxNewTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+		( void ) memset( ( void * ) &( pxNewTCB->ulNotifiedValue[ 0 ] ), 0x00, sizeof( pxNewTCB->ulNotifiedValue ) );
+		( void ) memset( ( void * ) &( pxNewTCB->ucNotifyState[ 0 ] ), taskNOT_WAITING_NOTIFICATION, sizeof( pxNewTCB->ucNotifyState ) );
 	}
 	#endif
 
@@ -1004,6 +1251,25 @@ UBaseType_t x;
 	}
 	#endif
 
+	#if( configUSE_EDF_SCHEDULING == 1 )
+	{
+		pxNewTCB->xRelativeDeadline = ( TickType_t ) 0U;
+		pxNewTCB->xAbsoluteDeadline = ( TickType_t ) 0U;
+		pxNewTCB->uxDeadlineMisses = ( UBaseType_t ) 0U;
+		pxNewTCB->ucDeadlineMissed = pdFALSE;
+		pxNewTCB->ucPeriodic = pdFALSE;
+	}
+	#endif
+
+	#if( configUSE_PERIODIC_TASKS == 1 )
+	{
+		pxNewTCB->xPeriod = ( TickType_t ) 0U;
+		pxNewTCB->ulReleaseTimestamp = 0UL;
+		pxNewTCB->ucJobState = tskJOB_NONE;
+		prvResetPeriodicStats( pxNewTCB );
+	}
+	#endif
+
 	/* Initialize the TCB stack to look as if the task was already running,
 	but had been interrupted by the scheduler.  The return address is set
 	to the start of the task function. Once the stack has been initialised
@@ -1126,6 +1392,26 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		#endif /* configUSE_TRACE_FACILITY */
 		traceTASK_CREATE( pxNewTCB );
 
+		#if( configUSE_BATCHED_WAKEUPS == 1 )
+		{
+		UBaseType_t x;
+
+			/* Take the lowest free wakeup bit, if there is one. */
+			pxNewTCB->uxWakeupBit = ( UBaseType_t ) 0U;
+
+			for( x = ( UBaseType_t ) 0U; x < ( UBaseType_t ) taskWAKEUP_BITS; x++ )
+			{
+				if( ( uxWakeupBitsInUse & ( ( UBaseType_t ) 1U << x ) ) == ( UBaseType_t ) 0U )
+				{
+					pxNewTCB->uxWakeupBit = ( UBaseType_t ) 1U << x;
+					uxWakeupBitsInUse |= pxNewTCB->uxWakeupBit;
+					pxWakeupBitOwners[ x ] = pxNewTCB;
+					break;
+				}
+			}
+		}
+		#endif /* configUSE_BATCHED_WAKEUPS */
+
 		prvAddTaskToReadyList( pxNewTCB );
 
 		portSETUP_TCB( pxNewTCB );
@@ -1184,6 +1470,14 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 				mtCOVERAGE_TEST_MARKER();
 			}
 
+			#if( configUSE_BATCHED_WAKEUPS == 1 )
+			{
+				/* A pending wakeup goes with the bit. */
+				taskCANCEL_WAKEUP( pxTCB );
+				uxWakeupBitsInUse &= ~( pxTCB->uxWakeupBit );
+			}
+			#endif
+
 			/* Increment the uxTaskNumber also so kernel aware debuggers can
 			detect that the task lists need re-generating.  This is done before
 			portPRE_TASK_DELETE_HOOK() as in the Windows port that macro will
@@ -1328,6 +1622,194 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 #endif /* INCLUDE_vTaskDelayUntil */
 /*-----------------------------------------------------------*/
 
+#if( ( configUSE_EDF_SCHEDULING == 1 ) || ( configUSE_PERIODIC_TASKS == 1 ) )
+
+	BaseType_t xTaskWaitForNextRelease( TickType_t * const pxPreviousReleaseTime, const TickType_t xPeriod )
+	{
+	TickType_t xReleaseTime;
+	BaseType_t xAlreadyYielded, xDeadlineMet;
+
+		configASSERT( pxPreviousReleaseTime );
+		configASSERT( ( xPeriod > 0U ) );
+		configASSERT( uxSchedulerSuspended == 0 );
+
+		vTaskSuspendAll();
+		{
+			const TickType_t xConstTickCount = xTickCount;
+
+			#if( configUSE_EDF_SCHEDULING == 1 )
+			{
+				/* The job that is finishing is checked against its own
+				deadline before the deadline of the next job is set. */
+				xDeadlineMet = ( prvCheckDeadline( xConstTickCount ) == pdFALSE ) ? pdTRUE : pdFALSE;
+
+				/* From now on only this function releases the jobs of the
+				task. */
+				pxCurrentTCB->ucPeriodic = pdTRUE;
+			}
+			#endif
+
+			#if( configUSE_PERIODIC_TASKS == 1 )
+			{
+				prvCompletePeriodicJob( xPeriod );
+			}
+			#endif
+
+			xReleaseTime = *pxPreviousReleaseTime + xPeriod;
+			*pxPreviousReleaseTime = xReleaseTime;
+
+			/* If the next job is already due the task keeps running, but the
+			yield below lets a job with an earlier deadline, or another task of
+			the same priority, run first. */
+			if( prvDelayUntilRelease( xReleaseTime, xConstTickCount ) != pdFALSE )
+			{
+				#if( configUSE_EDF_SCHEDULING == 0 )
+				{
+					xDeadlineMet = pdTRUE;
+				}
+				#endif
+
+				#if( configUSE_PERIODIC_TASKS == 1 )
+				{
+					/* The tick that unblocks the task releases the next
+					job. */
+					pxCurrentTCB->ucJobState = tskJOB_WAITING;
+				}
+				#endif
+			}
+			else
+			{
+				#if( configUSE_EDF_SCHEDULING == 0 )
+				{
+					/* Without EDF scheduling the deadline of a job is the
+					release of the next one. */
+					xDeadlineMet = pdFALSE;
+				}
+				#endif
+
+				#if( configUSE_PERIODIC_TASKS == 1 )
+				{
+					prvReleaseOverrunJob( xReleaseTime, xConstTickCount );
+				}
+				#endif
+			}
+		}
+		xAlreadyYielded = xTaskResumeAll();
+
+		if( xAlreadyYielded == pdFALSE )
+		{
+			portYIELD_WITHIN_API();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return xDeadlineMet;
+	}
+
+#endif /* ( configUSE_EDF_SCHEDULING == 1 ) || ( configUSE_PERIODIC_TASKS == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_PERIODIC_TASKS == 1 )
+
+	void vTaskGetPeriodicStats( TaskHandle_t xTask, PeriodicStats_t *pxStats )
+	{
+	TCB_t const *pxTCB;
+
+		configASSERT( pxStats );
+
+		taskENTER_CRITICAL();
+		{
+			pxTCB = prvGetTCBFromHandle( xTask );
+			pxStats->xPeriod = pxTCB->xPeriod;
+			pxStats->ulReleases = pxTCB->ulReleases;
+			pxStats->ulOverruns = pxTCB->ulOverruns;
+			pxStats->ulMaxReleaseJitter = pxTCB->ulMaxReleaseJitter;
+			pxStats->ulMaxResponseTime = pxTCB->ulMaxResponseTime;
+		}
+		taskEXIT_CRITICAL();
+	}
+
+#endif /* configUSE_PERIODIC_TASKS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_PERIODIC_TASKS == 1 )
+
+	void vTaskResetPeriodicStats( TaskHandle_t xTask )
+	{
+		taskENTER_CRITICAL();
+		{
+			prvResetPeriodicStats( prvGetTCBFromHandle( xTask ) );
+		}
+		taskEXIT_CRITICAL();
+	}
+
+#endif /* configUSE_PERIODIC_TASKS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+	void vTaskSetDeadline( TaskHandle_t xTask, TickType_t xRelativeDeadline )
+	{
+	TCB_t *pxTCB;
+	BaseType_t xYieldRequired = pdFALSE;
+
+		taskENTER_CRITICAL();
+		{
+			pxTCB = prvGetTCBFromHandle( xTask );
+
+			/* The current job of the task gets the new deadline too, as if it
+			was released now. */
+			pxTCB->xRelativeDeadline = xRelativeDeadline;
+			taskSET_JOB_DEADLINE( pxTCB, xTickCount );
+
+			/* A ready task, or the running task itself, may now be ahead of or
+			behind the running task. */
+			if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
+			{
+				xYieldRequired = xSchedulerRunning;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+
+			if( xYieldRequired != pdFALSE )
+			{
+				taskYIELD_IF_USING_PREEMPTION();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		taskEXIT_CRITICAL();
+	}
+
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+	UBaseType_t uxTaskGetDeadlineMisses( TaskHandle_t xTask )
+	{
+	TCB_t const *pxTCB;
+	UBaseType_t uxReturn;
+
+		taskENTER_CRITICAL();
+		{
+			pxTCB = prvGetTCBFromHandle( xTask );
+			uxReturn = pxTCB->uxDeadlineMisses;
+		}
+		taskEXIT_CRITICAL();
+
+		return uxReturn;
+	}
+
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
 #if ( INCLUDE_vTaskDelay == 1 )
 
 	void vTaskDelay( const TickType_t xTicksToDelay )
@@ -1398,7 +1880,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			}
 			taskEXIT_CRITICAL();
 
-			if( ( pxStateList == pxDelayedList ) || ( pxStateList == pxOverflowedDelayedList ) )
+			if( ( taskIS_DELAYED_LIST( pxStateList, pxDelayedList ) ) || ( taskIS_DELAYED_LIST( pxStateList, pxOverflowedDelayedList ) ) )
 			{
 				/* The task being queried is referenced from one of the Blocked
 				lists. */
@@ -1411,21 +1893,25 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 					/* The task being queried is referenced from the suspended
 					list.  Is it genuinely suspended or is it blocked
 					indefinitely? */
-					if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) == NULL )
+					if( ( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) == NULL ) && ( taskIS_WAKEUP_PENDING( pxTCB ) == pdFALSE ) )
 					{
 						#if( configUSE_TASK_NOTIFICATIONS == 1 )
 						{
+						BaseType_t x;
+
 							/* The task does not appear on the event list item of
 							and of the RTOS objects, but could still be in the
-							blocked state if it is waiting on its notification
-							rather than waiting on an object. */
-							if( pxTCB->ucNotifyState == taskWAITING_NOTIFICATION )
-							{
-								eReturn = eBlocked;
-							}
-							else
+							blocked state if it is waiting on one of its
+							notifications rather than waiting on an object. */
+							eReturn = eSuspended;
+
+							for( x = 0; x < configTASK_NOTIFICATION_ARRAY_ENTRIES; x++ )
 							{
-								eReturn = eSuspended;
+								if( pxTCB->ucNotifyState[ x ] == taskWAITING_NOTIFICATION )
+								{
+									eReturn = eBlocked;
+									break;
+								}
 							}
 						}
 						#else
@@ -1726,15 +2212,22 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 				mtCOVERAGE_TEST_MARKER();
 			}
 
+			taskCANCEL_WAKEUP( pxTCB );
+
 			vListInsertEnd( &xSuspendedTaskList, &( pxTCB->xStateListItem ) );
 
 			#if( configUSE_TASK_NOTIFICATIONS == 1 )
 			{
-				if( pxTCB->ucNotifyState == taskWAITING_NOTIFICATION )
+			BaseType_t x;
+
+				for( x = 0; x < configTASK_NOTIFICATION_ARRAY_ENTRIES; x++ )
 				{
-					/* The task was blocked to wait for a notification, but is
-					now suspended, so no notification was received. */
-					pxTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+					if( pxTCB->ucNotifyState[ x ] == taskWAITING_NOTIFICATION )
+					{
+						/* The task was blocked to wait for a notification, but is
+						now suspended, so no notification was received. */
+						pxTCB->ucNotifyState[ x ] = taskNOT_WAITING_NOTIFICATION;
+					}
 				}
 			}
 			#endif
@@ -1809,7 +2302,8 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 		if( listIS_CONTAINED_WITHIN( &xSuspendedTaskList, &( pxTCB->xStateListItem ) ) != pdFALSE )
 		{
 			/* Has the task already been resumed from within an ISR? */
-			if( listIS_CONTAINED_WITHIN( &xPendingReadyList, &( pxTCB->xEventListItem ) ) == pdFALSE )
+			if( ( listIS_CONTAINED_WITHIN( &xPendingReadyList, &( pxTCB->xEventListItem ) ) == pdFALSE ) &&
+				( taskIS_WAKEUP_PENDING( pxTCB ) == pdFALSE ) )
 			{
 				/* Is it in the suspended list because it is in the	Suspended
 				state, or because is is blocked with no timeout? */
@@ -1860,6 +2354,8 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 					/* The ready list can be accessed even if the scheduler is
 					suspended because this is inside a critical section. */
 					( void ) uxListRemove(  &( pxTCB->xStateListItem ) );
+					taskRELEASE_JOB( pxTCB, xTickCount );
+					taskRELEASE_PERIODIC_JOB( pxTCB );
 					prvAddTaskToReadyList( pxTCB );
 
 					/* A higher priority task may have just been resumed. */
@@ -1925,6 +2421,8 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 			if( prvTaskIsTaskSuspended( pxTCB ) != pdFALSE )
 			{
 				traceTASK_RESUME_FROM_ISR( pxTCB );
+				taskRELEASE_JOB( pxTCB, xTickCount );
+				taskRELEASE_PERIODIC_JOB( pxTCB );
 
 				/* Check the ready lists can be accessed. */
 				if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
@@ -1948,7 +2446,7 @@ static void prvAddNewTaskToReadyList( TCB_t *pxNewTCB )
 					/* The delayed or ready lists cannot be accessed so the task
 					is held in the pending ready list until the scheduler is
 					unsuspended. */
-					vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
+					taskPEND_WAKEUP( pxTCB );
 				}
 			}
 			else
@@ -2213,27 +2711,68 @@ BaseType_t xAlreadyYielded = pdFALSE;
 					}
 				}
 
-				if( pxTCB != NULL )
+				#if( configUSE_BATCHED_WAKEUPS == 1 )
+				if( uxPendingWakeups != ( UBaseType_t ) 0U )
 				{
-					/* A task was unblocked while the scheduler was suspended,
-					which may have prevented the next unblock time from being
-					re-calculated, in which case re-calculate it now.  Mainly
-					important for low power tickless implementations, where
-					this can prevent an unnecessary exit from low power
-					state. */
-					prvResetNextTaskUnblockTime();
-				}
+				UBaseType_t uxWakeups = uxPendingWakeups;
+				UBaseType_t x;
 
-				/* If any ticks occurred while the scheduler was suspended then
-				they should be processed now.  This ensures the tick count does
-				not	slip, and that any delayed tasks are resumed at the correct
-				time. */
-				{
-					UBaseType_t uxPendedCounts = uxPendedTicks; /* Non-volatile copy. */
+					/* Then the tasks held by their bits, all in one pass.
+					Interrupts are masked, so no bit is set meanwhile. */
+					uxPendingWakeups = ( UBaseType_t ) 0U;
 
-					if( uxPendedCounts > ( UBaseType_t ) 0U )
+					for( x = ( UBaseType_t ) 0U; uxWakeups != ( UBaseType_t ) 0U; x++ )
 					{
-						do
+						if( ( uxWakeups & ( UBaseType_t ) 1U ) != ( UBaseType_t ) 0U )
+						{
+							pxTCB = pxWakeupBitOwners[ x ];
+							( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+							prvAddTaskToReadyList( pxTCB );
+
+							if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+							{
+								xYieldPending = pdTRUE;
+							}
+							else
+							{
+								mtCOVERAGE_TEST_MARKER();
+							}
+						}
+						else
+						{
+							mtCOVERAGE_TEST_MARKER();
+						}
+
+						uxWakeups >>= 1;
+					}
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+				#endif /* configUSE_BATCHED_WAKEUPS */
+
+				if( pxTCB != NULL )
+				{
+					/* A task was unblocked while the scheduler was suspended,
+					which may have prevented the next unblock time from being
+					re-calculated, in which case re-calculate it now.  Mainly
+					important for low power tickless implementations, where
+					this can prevent an unnecessary exit from low power
+					state. */
+					prvResetNextTaskUnblockTime();
+				}
+
+				/* If any ticks occurred while the scheduler was suspended then
+				they should be processed now.  This ensures the tick count does
+				not	slip, and that any delayed tasks are resumed at the correct
+				time. */
+				{
+					UBaseType_t uxPendedCounts = uxPendedTicks; /* Non-volatile copy. */
+
+					if( uxPendedCounts > ( UBaseType_t ) 0U )
+					{
+						do
 						{
 							if( xTaskIncrementTick() != pdFALSE )
 							{
@@ -2284,12 +2823,23 @@ TickType_t xTaskGetTickCount( void )
 {
 TickType_t xTicks;
 
-	/* Critical section required if running on a 16 bit processor. */
-	portTICK_TYPE_ENTER_CRITICAL();
+	#ifdef portREAD_TICK_COUNT
 	{
-		xTicks = xTickCount;
+		/* The port can read a tick count that is wider than its word size
+		consistently without a critical section, for example by reading the
+		upper half of the count before and after the lower half. */
+		portREAD_TICK_COUNT( xTicks, xTickCount );
 	}
-	portTICK_TYPE_EXIT_CRITICAL();
+	#else
+	{
+		/* Critical section required if running on a 16 bit processor. */
+		portTICK_TYPE_ENTER_CRITICAL();
+		{
+			xTicks = xTickCount;
+		}
+		portTICK_TYPE_EXIT_CRITICAL();
+	}
+	#endif
 
 	return xTicks;
 }
@@ -2326,6 +2876,36 @@ UBaseType_t uxSavedInterruptStatus;
 }
 /*-----------------------------------------------------------*/
 
+#if ( INCLUDE_xTaskGetTicksToNextUnblock == 1 )
+
+	TickType_t xTaskGetTicksToNextUnblock( void )
+	{
+	TickType_t xReturn;
+
+		/* No critical section - the caller has interrupts disabled, so the
+		delayed lists, xNextTaskUnblockTime and xTickCount can not change while
+		they are read, and the interrupts stay disabled on return. */
+		if( ( taskDELAYED_LIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE ) &&
+			( taskDELAYED_LIST_IS_EMPTY( pxOverflowDelayedTaskList ) != pdFALSE ) )
+		{
+			/* Only an interrupt or a task without a timeout can make a task
+			ready. */
+			xReturn = portMAX_DELAY;
+		}
+		else
+		{
+			/* When only the overflow list holds tasks xNextTaskUnblockTime is
+			portMAX_DELAY, which gives the ticks left until the tick count
+			wraps - early, but never late. */
+			xReturn = xNextTaskUnblockTime - xTickCount;
+		}
+
+		return xReturn;
+	}
+
+#endif /* INCLUDE_xTaskGetTicksToNextUnblock */
+/*-----------------------------------------------------------*/
+
 UBaseType_t uxTaskGetNumberOfTasks( void )
 {
 	/* A critical section is not required because the variables are of type
@@ -2418,7 +2998,7 @@ TCB_t *pxTCB;
 
 	TaskHandle_t xTaskGetHandle( const char *pcNameToQuery ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
 	{
-	UBaseType_t uxQueue = configMAX_PRIORITIES;
+	UBaseType_t uxQueue = configMAX_PRIORITIES, uxBucket;
 	TCB_t* pxTCB;
 
 		/* Task names will be truncated to configMAX_TASK_NAME_LEN - 1 bytes. */
@@ -2441,14 +3021,14 @@ TCB_t *pxTCB;
 			} while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 
 			/* Search the delayed lists. */
-			if( pxTCB == NULL )
+			for( uxBucket = ( UBaseType_t ) 0U; ( uxBucket < ( UBaseType_t ) configDELAYED_LIST_BUCKETS ) && ( pxTCB == NULL ); uxBucket++ )
 			{
-				pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxDelayedTaskList, pcNameToQuery );
+				pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) &( pxDelayedTaskList[ uxBucket ] ), pcNameToQuery );
 			}
 
-			if( pxTCB == NULL )
+			for( uxBucket = ( UBaseType_t ) 0U; ( uxBucket < ( UBaseType_t ) configDELAYED_LIST_BUCKETS ) && ( pxTCB == NULL ); uxBucket++ )
 			{
-				pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
+				pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) &( pxOverflowDelayedTaskList[ uxBucket ] ), pcNameToQuery );
 			}
 
 			#if ( INCLUDE_vTaskSuspend == 1 )
@@ -2483,7 +3063,7 @@ TCB_t *pxTCB;
 
 	UBaseType_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray, const UBaseType_t uxArraySize, uint32_t * const pulTotalRunTime )
 	{
-	UBaseType_t uxTask = 0, uxQueue = configMAX_PRIORITIES;
+	UBaseType_t uxTask = 0, uxQueue = configMAX_PRIORITIES, uxBucket;
 
 		vTaskSuspendAll();
 		{
@@ -2501,8 +3081,11 @@ TCB_t *pxTCB;
 
 				/* Fill in an TaskStatus_t structure with information on each
 				task in the Blocked state. */
-				uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked );
-				uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked );
+				for( uxBucket = ( UBaseType_t ) 0U; uxBucket < ( UBaseType_t ) configDELAYED_LIST_BUCKETS; uxBucket++ )
+				{
+					uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) &( pxDelayedTaskList[ uxBucket ] ), eBlocked );
+					uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) &( pxOverflowDelayedTaskList[ uxBucket ] ), eBlocked );
+				}
 
 				#if( INCLUDE_vTaskDelete == 1 )
 				{
@@ -2618,6 +3201,12 @@ implementations require configUSE_TICKLESS_IDLE to be set to a value other than
 						( void ) uxListRemove( &( pxTCB->xEventListItem ) );
 						pxTCB->ucDelayAborted = pdTRUE;
 					}
+					else if( taskIS_WAKEUP_PENDING( pxTCB ) != pdFALSE )
+					{
+						/* Same as a task held in xPendingReadyList. */
+						taskCANCEL_WAKEUP( pxTCB );
+						pxTCB->ucDelayAborted = pdTRUE;
+					}
 					else
 					{
 						mtCOVERAGE_TEST_MARKER();
@@ -2626,6 +3215,8 @@ implementations require configUSE_TICKLESS_IDLE to be set to a value other than
 				taskEXIT_CRITICAL();
 
 				/* Place the unblocked task into the appropriate ready list. */
+				taskRELEASE_JOB( pxTCB, xTickCount );
+				taskRELEASE_PERIODIC_JOB( pxTCB );
 				prvAddTaskToReadyList( pxTCB );
 
 				/* A task being unblocked cannot cause an immediate context
@@ -2635,7 +3226,7 @@ implementations require configUSE_TICKLESS_IDLE to be set to a value other than
 					/* Preemption is on, but a context switch should only be
 					performed if the unblocked task has a priority that is
 					equal to or higher than the currently executing task. */
-					if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+					if( taskIS_MORE_URGENT( pxTCB ) )
 					{
 						/* Pend the yield to be performed when the scheduler
 						is unsuspended. */
@@ -2664,6 +3255,7 @@ implementations require configUSE_TICKLESS_IDLE to be set to a value other than
 BaseType_t xTaskIncrementTick( void )
 {
 TCB_t * pxTCB;
+List_t * pxDueList;
 TickType_t xItemValue;
 BaseType_t xSwitchRequired = pdFALSE;
 
@@ -2698,15 +3290,36 @@ BaseType_t xSwitchRequired = pdFALSE;
 		{
 			for( ;; )
 			{
-				if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+				pxDueList = taskDELAYED_BUCKET( pxDelayedTaskList, xNextTaskUnblockTime );
+
+				if( listLIST_IS_EMPTY( pxDueList ) != pdFALSE )
 				{
-					/* The delayed list is empty.  Set xNextTaskUnblockTime
-					to the maximum possible value so it is extremely
-					unlikely that the
-					if( xTickCount >= xNextTaskUnblockTime ) test will pass
-					next time through. */
-					xNextTaskUnblockTime = portMAX_DELAY; /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
-					break;
+					#if( configDELAYED_LIST_BUCKETS > 1 )
+					{
+						/* Either no task is delayed or the task that set
+						xNextTaskUnblockTime has been unblocked by an event.
+						Find the earliest wake time of all the buckets, which
+						can also be in the past if ticks were stepped over. */
+						prvResetNextTaskUnblockTime();
+
+						if( ( xConstTickCount < xNextTaskUnblockTime ) ||
+							( listLIST_IS_EMPTY( taskDELAYED_BUCKET( pxDelayedTaskList, xNextTaskUnblockTime ) ) != pdFALSE ) )
+						{
+							break;
+						}
+						continue;
+					}
+					#else
+					{
+						/* The delayed list is empty.  Set xNextTaskUnblockTime
+						to the maximum possible value so it is extremely
+						unlikely that the
+						if( xTickCount >= xNextTaskUnblockTime ) test will pass
+						next time through. */
+						xNextTaskUnblockTime = portMAX_DELAY; /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+						break;
+					}
+					#endif
 				}
 				else
 				{
@@ -2714,18 +3327,34 @@ BaseType_t xSwitchRequired = pdFALSE;
 					item at the head of the delayed list.  This is the time
 					at which the task at the head of the delayed list must
 					be removed from the Blocked state. */
-					pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+					pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDueList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
 					xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
 
 					if( xConstTickCount < xItemValue )
 					{
-						/* It is not time to unblock this item yet, but the
-						item value is the time at which the task at the head
-						of the blocked list must be removed from the Blocked
-						state -	so record the item value in
-						xNextTaskUnblockTime. */
-						xNextTaskUnblockTime = xItemValue;
-						break; /*lint !e9011 Code structure here is deedmed easier to understand with multiple breaks. */
+						#if( configDELAYED_LIST_BUCKETS > 1 )
+						{
+							/* No more tasks wake at this time, the next one
+							can be in any bucket. */
+							prvResetNextTaskUnblockTime();
+
+							if( xConstTickCount < xNextTaskUnblockTime )
+							{
+								break;
+							}
+							continue;
+						}
+						#else
+						{
+							/* It is not time to unblock this item yet, but the
+							item value is the time at which the task at the head
+							of the blocked list must be removed from the Blocked
+							state -	so record the item value in
+							xNextTaskUnblockTime. */
+							xNextTaskUnblockTime = xItemValue;
+							break; /*lint !e9011 Code structure here is deedmed easier to understand with multiple breaks. */
+						}
+						#endif
 					}
 					else
 					{
@@ -2748,6 +3377,8 @@ BaseType_t xSwitchRequired = pdFALSE;
 
 					/* Place the unblocked task into the appropriate ready
 					list. */
+					taskRELEASE_JOB( pxTCB, xConstTickCount );
+					taskRELEASE_PERIODIC_JOB( pxTCB );
 					prvAddTaskToReadyList( pxTCB );
 
 					/* A task being unblocked cannot cause an immediate
@@ -2998,6 +3629,32 @@ void vTaskSwitchContext( void )
 		taskSELECT_HIGHEST_PRIORITY_TASK(); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
 		traceTASK_SWITCHED_IN();
 
+		#if( configUSE_PERIODIC_TASKS == 1 )
+		{
+			/* Release jitter is the time from the release of a job until the
+			task first runs. */
+			if( pxCurrentTCB->ucJobState == tskJOB_RELEASED )
+			{
+			uint32_t ulJitter = configPERIODIC_STATS_ELAPSED( configPERIODIC_STATS_TIME(), pxCurrentTCB->ulReleaseTimestamp );
+
+				pxCurrentTCB->ucJobState = tskJOB_RUNNING;
+
+				if( ulJitter > pxCurrentTCB->ulMaxReleaseJitter )
+				{
+					pxCurrentTCB->ulMaxReleaseJitter = ulJitter;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		#endif
+
 		/* After the new task is switched in, update the global errno. */
 		#if( configUSE_POSIX_ERRNO == 1 )
 		{
@@ -3111,6 +3768,7 @@ BaseType_t xReturn;
 	pxUnblockedTCB = listGET_OWNER_OF_HEAD_ENTRY( pxEventList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
 	configASSERT( pxUnblockedTCB );
 	( void ) uxListRemove( &( pxUnblockedTCB->xEventListItem ) );
+	taskRELEASE_JOB( pxUnblockedTCB, xTickCount );
 
 	if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
 	{
@@ -3135,10 +3793,10 @@ BaseType_t xReturn;
 	{
 		/* The delayed and ready lists cannot be accessed, so hold this task
 		pending until the scheduler is resumed. */
-		vListInsertEnd( &( xPendingReadyList ), &( pxUnblockedTCB->xEventListItem ) );
+		taskPEND_WAKEUP( pxUnblockedTCB );
 	}
 
-	if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+	if( taskIS_MORE_URGENT( pxUnblockedTCB ) )
 	{
 		/* Return true if the task removed from the event list has a higher
 		priority than the calling task.  This allows the calling task to know if
@@ -3179,9 +3837,10 @@ TCB_t *pxUnblockedTCB;
 	scheduler is suspended so interrupts will not be accessing the ready
 	lists. */
 	( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
+	taskRELEASE_JOB( pxUnblockedTCB, xTickCount );
 	prvAddTaskToReadyList( pxUnblockedTCB );
 
-	if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+	if( taskIS_MORE_URGENT( pxUnblockedTCB ) )
 	{
 		/* The unblocked task has a priority above that of the calling task, so
 		a context switch is required.  This function is called with the
@@ -3455,7 +4114,7 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
 	const UBaseType_t uxNonApplicationTasks = 1;
 	eSleepModeStatus eReturn = eStandardSleep;
 
-		if( listCURRENT_LIST_LENGTH( &xPendingReadyList ) != 0 )
+		if( ( listCURRENT_LIST_LENGTH( &xPendingReadyList ) != 0 ) || ( taskANY_WAKEUP_PENDING() != pdFALSE ) )
 		{
 			/* A task was made ready while the scheduler was suspended. */
 			eReturn = eAbortSleep;
@@ -3551,8 +4210,11 @@ UBaseType_t uxPriority;
 		vListInitialise( &( pxReadyTasksLists[ uxPriority ] ) );
 	}
 
-	vListInitialise( &xDelayedTaskList1 );
-	vListInitialise( &xDelayedTaskList2 );
+	for( uxPriority = ( UBaseType_t ) 0U; uxPriority < ( UBaseType_t ) configDELAYED_LIST_BUCKETS; uxPriority++ )
+	{
+		vListInitialise( &( xDelayedTaskList1[ uxPriority ] ) );
+		vListInitialise( &( xDelayedTaskList2[ uxPriority ] ) );
+	}
 	vListInitialise( &xPendingReadyList );
 
 	#if ( INCLUDE_vTaskDelete == 1 )
@@ -3569,8 +4231,8 @@ UBaseType_t uxPriority;
 
 	/* Start with pxDelayedTaskList using list1 and the pxOverflowDelayedTaskList
 	using list2. */
-	pxDelayedTaskList = &xDelayedTaskList1;
-	pxOverflowDelayedTaskList = &xDelayedTaskList2;
+	pxDelayedTaskList = xDelayedTaskList1;
+	pxOverflowDelayedTaskList = xDelayedTaskList2;
 }
 /*-----------------------------------------------------------*/
 
@@ -3660,7 +4322,7 @@ static void prvCheckTasksWaitingTermination( void )
 					{
 						vTaskSuspendAll();
 						{
-							if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+							if( ( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL ) || ( taskIS_WAKEUP_PENDING( pxTCB ) != pdFALSE ) )
 							{
 								pxTaskStatus->eCurrentState = eBlocked;
 							}
@@ -3876,6 +4538,49 @@ static void prvCheckTasksWaitingTermination( void )
 #endif /* INCLUDE_vTaskDelete */
 /*-----------------------------------------------------------*/
 
+#if( configDELAYED_LIST_BUCKETS > 1 )
+
+	static BaseType_t prvDelayedListIsEmpty( const List_t *pxList )
+	{
+	UBaseType_t uxBucket;
+
+		for( uxBucket = ( UBaseType_t ) 0U; uxBucket < ( UBaseType_t ) configDELAYED_LIST_BUCKETS; uxBucket++ )
+		{
+			if( listLIST_IS_EMPTY( &( pxList[ uxBucket ] ) ) == pdFALSE )
+			{
+				return pdFALSE;
+			}
+		}
+
+		return pdTRUE;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvResetNextTaskUnblockTime( void )
+	{
+	UBaseType_t uxBucket;
+	TickType_t xNextTime = portMAX_DELAY, xItemValue;
+
+		/* The earliest wake time is at the head of one of the buckets.  Leaves
+		xNextTaskUnblockTime at portMAX_DELAY if no task is delayed. */
+		for( uxBucket = ( UBaseType_t ) 0U; uxBucket < ( UBaseType_t ) configDELAYED_LIST_BUCKETS; uxBucket++ )
+		{
+			if( listLIST_IS_EMPTY( &( pxDelayedTaskList[ uxBucket ] ) ) == pdFALSE )
+			{
+				xItemValue = listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxDelayedTaskList[ uxBucket ] ) );
+
+				if( xItemValue < xNextTime )
+				{
+					xNextTime = xItemValue;
+				}
+			}
+		}
+
+		xNextTaskUnblockTime = xNextTime;
+	}
+
+#else /* configDELAYED_LIST_BUCKETS */
+
 static void prvResetNextTaskUnblockTime( void )
 {
 TCB_t *pxTCB;
@@ -3898,6 +4603,8 @@ TCB_t *pxTCB;
 		xNextTaskUnblockTime = listGET_LIST_ITEM_VALUE( &( ( pxTCB )->xStateListItem ) );
 	}
 }
+
+#endif /* configDELAYED_LIST_BUCKETS */
 /*-----------------------------------------------------------*/
 
 #if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) )
@@ -4562,17 +5269,19 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
+	uint32_t ulTaskGenericNotifyTake( UBaseType_t uxIndexToWait, BaseType_t xClearCountOnExit, TickType_t xTicksToWait )
 	{
 	uint32_t ulReturn;
 
+		configASSERT( uxIndexToWait < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		taskENTER_CRITICAL();
 		{
 			/* Only block if the notification count is not already non-zero. */
-			if( pxCurrentTCB->ulNotifiedValue == 0UL )
+			if( pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] == 0UL )
 			{
 				/* Mark this task as waiting for a notification. */
-				pxCurrentTCB->ucNotifyState = taskWAITING_NOTIFICATION;
+				pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskWAITING_NOTIFICATION;
 
 				if( xTicksToWait > ( TickType_t ) 0 )
 				{
@@ -4600,17 +5309,17 @@ TickType_t uxReturn;
 		taskENTER_CRITICAL();
 		{
 			traceTASK_NOTIFY_TAKE();
-			ulReturn = pxCurrentTCB->ulNotifiedValue;
+			ulReturn = pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ];
 
 			if( ulReturn != 0UL )
 			{
 				if( xClearCountOnExit != pdFALSE )
 				{
-					pxCurrentTCB->ulNotifiedValue = 0UL;
+					pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] = 0UL;
 				}
 				else
 				{
-					pxCurrentTCB->ulNotifiedValue = ulReturn - ( uint32_t ) 1;
+					pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] = ulReturn - ( uint32_t ) 1;
 				}
 			}
 			else
@@ -4618,7 +5327,7 @@ TickType_t uxReturn;
 				mtCOVERAGE_TEST_MARKER();
 			}
 
-			pxCurrentTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+			pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskNOT_WAITING_NOTIFICATION;
 		}
 		taskEXIT_CRITICAL();
 
@@ -4630,22 +5339,24 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait )
+	BaseType_t xTaskGenericNotifyWait( UBaseType_t uxIndexToWait, uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait )
 	{
 	BaseType_t xReturn;
 
+		configASSERT( uxIndexToWait < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		taskENTER_CRITICAL();
 		{
 			/* Only block if a notification is not already pending. */
-			if( pxCurrentTCB->ucNotifyState != taskNOTIFICATION_RECEIVED )
+			if( pxCurrentTCB->ucNotifyState[ uxIndexToWait ] != taskNOTIFICATION_RECEIVED )
 			{
 				/* Clear bits in the task's notification value as bits may get
 				set	by the notifying task or interrupt.  This can be used to
 				clear the value to zero. */
-				pxCurrentTCB->ulNotifiedValue &= ~ulBitsToClearOnEntry;
+				pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] &= ~ulBitsToClearOnEntry;
 
 				/* Mark this task as waiting for a notification. */
-				pxCurrentTCB->ucNotifyState = taskWAITING_NOTIFICATION;
+				pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskWAITING_NOTIFICATION;
 
 				if( xTicksToWait > ( TickType_t ) 0 )
 				{
@@ -4678,14 +5389,14 @@ TickType_t uxReturn;
 			{
 				/* Output the current notification value, which may or may not
 				have changed. */
-				*pulNotificationValue = pxCurrentTCB->ulNotifiedValue;
+				*pulNotificationValue = pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ];
 			}
 
 			/* If ucNotifyValue is set then either the task never entered the
 			blocked state (because a notification was already pending) or the
 			task unblocked because of a notification.  Otherwise the task
 			unblocked because of a timeout. */
-			if( pxCurrentTCB->ucNotifyState != taskNOTIFICATION_RECEIVED )
+			if( pxCurrentTCB->ucNotifyState[ uxIndexToWait ] != taskNOTIFICATION_RECEIVED )
 			{
 				/* A notification was not received. */
 				xReturn = pdFALSE;
@@ -4694,11 +5405,11 @@ TickType_t uxReturn;
 			{
 				/* A notification was already pending or a notification was
 				received while the task was waiting. */
-				pxCurrentTCB->ulNotifiedValue &= ~ulBitsToClearOnExit;
+				pxCurrentTCB->ulNotifiedValue[ uxIndexToWait ] &= ~ulBitsToClearOnExit;
 				xReturn = pdTRUE;
 			}
 
-			pxCurrentTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+			pxCurrentTCB->ucNotifyState[ uxIndexToWait ] = taskNOT_WAITING_NOTIFICATION;
 		}
 		taskEXIT_CRITICAL();
 
@@ -4710,111 +5421,98 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue )
+	BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue )
 	{
 	TCB_t * pxTCB;
 	BaseType_t xReturn = pdPASS;
 	uint8_t ucOriginalNotifyState;
+	UBaseType_t uxSavedInterruptStatus;
 
 		configASSERT( xTaskToNotify );
+		configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		pxTCB = xTaskToNotify;
 
-		taskENTER_CRITICAL();
+		/* Most notifications find the task running or busy with an earlier
+		notification.  Then nothing but the value changes, and only a task
+		that waits for the notification goes through the critical section
+		below. */
+		taskMASK_NOTIFY_UPDATE( uxSavedInterruptStatus );
 		{
-			if( pulPreviousNotificationValue != NULL )
+			ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
+
+			if( ucOriginalNotifyState != taskWAITING_NOTIFICATION )
 			{
-				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue;
+				xReturn = prvSetNotifiedValue( pxTCB, uxIndexToNotify, ulValue, eAction, ucOriginalNotifyState, pulPreviousNotificationValue );
+				traceTASK_NOTIFY();
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
 			}
+		}
+		taskRESTORE_NOTIFY_UPDATE( uxSavedInterruptStatus );
 
-			ucOriginalNotifyState = pxTCB->ucNotifyState;
+		if( ucOriginalNotifyState == taskWAITING_NOTIFICATION )
+		{
+			taskENTER_CRITICAL();
+			{
+				/* An interrupt might have notified the task since the state was
+				read, so read it again. */
+				ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
+				xReturn = prvSetNotifiedValue( pxTCB, uxIndexToNotify, ulValue, eAction, ucOriginalNotifyState, pulPreviousNotificationValue );
 
-			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+				traceTASK_NOTIFY();
 
-			switch( eAction )
-			{
-				case eSetBits	:
-					pxTCB->ulNotifiedValue |= ulValue;
-					break;
+				/* If the task is in the blocked state specifically to wait for a
+				notification then unblock it now. */
+				if( ucOriginalNotifyState == taskWAITING_NOTIFICATION )
+				{
+					( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+					taskRELEASE_JOB( pxTCB, xTickCount );
+					prvAddTaskToReadyList( pxTCB );
 
-				case eIncrement	:
-					( pxTCB->ulNotifiedValue )++;
-					break;
+					/* The task should not have been on an event list. */
+					configASSERT( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) == NULL );
 
-				case eSetValueWithOverwrite	:
-					pxTCB->ulNotifiedValue = ulValue;
-					break;
+					#if( configUSE_TICKLESS_IDLE != 0 )
+					{
+						/* If a task is blocked waiting for a notification then
+						xNextTaskUnblockTime might be set to the blocked task's time
+						out time.  If the task is unblocked for a reason other than
+						a timeout xNextTaskUnblockTime is normally left unchanged,
+						because it will automatically get reset to a new value when
+						the tick count equals xNextTaskUnblockTime.  However if
+						tickless idling is used it might be more important to enter
+						sleep mode at the earliest possible time - so reset
+						xNextTaskUnblockTime here to ensure it is updated at the
+						earliest possible time. */
+						prvResetNextTaskUnblockTime();
+					}
+					#endif
 
-				case eSetValueWithoutOverwrite :
-					if( ucOriginalNotifyState != taskNOTIFICATION_RECEIVED )
+					if( taskIS_MORE_URGENT( pxTCB ) )
 					{
-						pxTCB->ulNotifiedValue = ulValue;
+						/* The notified task has a priority above the currently
+						executing task so a yield is required. */
+						taskYIELD_IF_USING_PREEMPTION();
 					}
 					else
 					{
-						/* The value could not be written to the task. */
-						xReturn = pdFAIL;
+						mtCOVERAGE_TEST_MARKER();
 					}
-					break;
-
-				case eNoAction:
-					/* The task is being notified without its notify value being
-					updated. */
-					break;
-
-				default:
-					/* Should not get here if all enums are handled.
-					Artificially force an assert by testing a value the
-					compiler can't assume is const. */
-					configASSERT( pxTCB->ulNotifiedValue == ~0UL );
-
-					break;
-			}
-
-			traceTASK_NOTIFY();
-
-			/* If the task is in the blocked state specifically to wait for a
-			notification then unblock it now. */
-			if( ucOriginalNotifyState == taskWAITING_NOTIFICATION )
-			{
-				( void ) uxListRemove( &( pxTCB->xStateListItem ) );
-				prvAddTaskToReadyList( pxTCB );
-
-				/* The task should not have been on an event list. */
-				configASSERT( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) == NULL );
-
-				#if( configUSE_TICKLESS_IDLE != 0 )
-				{
-					/* If a task is blocked waiting for a notification then
-					xNextTaskUnblockTime might be set to the blocked task's time
-					out time.  If the task is unblocked for a reason other than
-					a timeout xNextTaskUnblockTime is normally left unchanged,
-					because it will automatically get reset to a new value when
-					the tick count equals xNextTaskUnblockTime.  However if
-					tickless idling is used it might be more important to enter
-					sleep mode at the earliest possible time - so reset
-					xNextTaskUnblockTime here to ensure it is updated at the
-					earliest possible time. */
-					prvResetNextTaskUnblockTime();
-				}
-				#endif
-
-				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
-				{
-					/* The notified task has a priority above the currently
-					executing task so a yield is required. */
-					taskYIELD_IF_USING_PREEMPTION();
 				}
 				else
 				{
 					mtCOVERAGE_TEST_MARKER();
 				}
 			}
-			else
-			{
-				mtCOVERAGE_TEST_MARKER();
-			}
+			taskEXIT_CRITICAL();
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
 		}
-		taskEXIT_CRITICAL();
 
 		return xReturn;
 	}
@@ -4824,7 +5522,7 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue, BaseType_t *pxHigherPriorityTaskWoken )
+	BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, uint32_t *pulPreviousNotificationValue, BaseType_t *pxHigherPriorityTaskWoken )
 	{
 	TCB_t * pxTCB;
 	uint8_t ucOriginalNotifyState;
@@ -4832,6 +5530,7 @@ TickType_t uxReturn;
 	UBaseType_t uxSavedInterruptStatus;
 
 		configASSERT( xTaskToNotify );
+		configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
 
 		/* RTOS ports that support interrupt nesting have the concept of a
 		maximum	system call (or maximum API call) interrupt priority.
@@ -4855,52 +5554,8 @@ TickType_t uxReturn;
 
 		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
 		{
-			if( pulPreviousNotificationValue != NULL )
-			{
-				*pulPreviousNotificationValue = pxTCB->ulNotifiedValue;
-			}
-
-			ucOriginalNotifyState = pxTCB->ucNotifyState;
-			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
-
-			switch( eAction )
-			{
-				case eSetBits	:
-					pxTCB->ulNotifiedValue |= ulValue;
-					break;
-
-				case eIncrement	:
-					( pxTCB->ulNotifiedValue )++;
-					break;
-
-				case eSetValueWithOverwrite	:
-					pxTCB->ulNotifiedValue = ulValue;
-					break;
-
-				case eSetValueWithoutOverwrite :
-					if( ucOriginalNotifyState != taskNOTIFICATION_RECEIVED )
-					{
-						pxTCB->ulNotifiedValue = ulValue;
-					}
-					else
-					{
-						/* The value could not be written to the task. */
-						xReturn = pdFAIL;
-					}
-					break;
-
-				case eNoAction :
-					/* The task is being notified without its notify value being
-					updated. */
-					break;
-
-				default:
-					/* Should not get here if all enums are handled.
-					Artificially force an assert by testing a value the
-					compiler can't assume is const. */
-					configASSERT( pxTCB->ulNotifiedValue == ~0UL );
-					break;
-			}
+			ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
+			xReturn = prvSetNotifiedValue( pxTCB, uxIndexToNotify, ulValue, eAction, ucOriginalNotifyState, pulPreviousNotificationValue );
 
 			traceTASK_NOTIFY_FROM_ISR();
 
@@ -4910,6 +5565,7 @@ TickType_t uxReturn;
 			{
 				/* The task should not have been on an event list. */
 				configASSERT( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) == NULL );
+				taskRELEASE_JOB( pxTCB, xTickCount );
 
 				if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
 				{
@@ -4920,10 +5576,10 @@ TickType_t uxReturn;
 				{
 					/* The delayed and ready lists cannot be accessed, so hold
 					this task pending until the scheduler is resumed. */
-					vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
+					taskPEND_WAKEUP( pxTCB );
 				}
 
-				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				if( taskIS_MORE_URGENT( pxTCB ) )
 				{
 					/* The notified task has a priority above the currently
 					executing task so a yield is required. */
@@ -4953,13 +5609,14 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	void vTaskNotifyGiveFromISR( TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken )
+	void vTaskGenericNotifyGiveFromISR( TaskHandle_t xTaskToNotify, UBaseType_t uxIndexToNotify, BaseType_t *pxHigherPriorityTaskWoken )
 	{
 	TCB_t * pxTCB;
 	uint8_t ucOriginalNotifyState;
 	UBaseType_t uxSavedInterruptStatus;
 
 		configASSERT( xTaskToNotify );
+		configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
 
 		/* RTOS ports that support interrupt nesting have the concept of a
 		maximum	system call (or maximum API call) interrupt priority.
@@ -4983,12 +5640,12 @@ TickType_t uxReturn;
 
 		uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
 		{
-			ucOriginalNotifyState = pxTCB->ucNotifyState;
-			pxTCB->ucNotifyState = taskNOTIFICATION_RECEIVED;
+			ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
+			pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
 
 			/* 'Giving' is equivalent to incrementing a count in a counting
 			semaphore. */
-			( pxTCB->ulNotifiedValue )++;
+			( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
 
 			traceTASK_NOTIFY_GIVE_FROM_ISR();
 
@@ -4998,6 +5655,7 @@ TickType_t uxReturn;
 			{
 				/* The task should not have been on an event list. */
 				configASSERT( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) == NULL );
+				taskRELEASE_JOB( pxTCB, xTickCount );
 
 				if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
 				{
@@ -5008,10 +5666,10 @@ TickType_t uxReturn;
 				{
 					/* The delayed and ready lists cannot be accessed, so hold
 					this task pending until the scheduler is resumed. */
-					vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
+					taskPEND_WAKEUP( pxTCB );
 				}
 
-				if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+				if( taskIS_MORE_URGENT( pxTCB ) )
 				{
 					/* The notified task has a priority above the currently
 					executing task so a yield is required. */
@@ -5040,20 +5698,22 @@ TickType_t uxReturn;
 
 #if( configUSE_TASK_NOTIFICATIONS == 1 )
 
-	BaseType_t xTaskNotifyStateClear( TaskHandle_t xTask )
+	BaseType_t xTaskGenericNotifyStateClear( TaskHandle_t xTask, UBaseType_t uxIndexToClear )
 	{
 	TCB_t *pxTCB;
 	BaseType_t xReturn;
 
+		configASSERT( uxIndexToClear < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
 		/* If null is passed in here then it is the calling task that is having
 		its notification state cleared. */
 		pxTCB = prvGetTCBFromHandle( xTask );
 
 		taskENTER_CRITICAL();
 		{
-			if( pxTCB->ucNotifyState == taskNOTIFICATION_RECEIVED )
+			if( pxTCB->ucNotifyState[ uxIndexToClear ] == taskNOTIFICATION_RECEIVED )
 			{
-				pxTCB->ucNotifyState = taskNOT_WAITING_NOTIFICATION;
+				pxTCB->ucNotifyState[ uxIndexToClear ] = taskNOT_WAITING_NOTIFICATION;
 				xReturn = pdPASS;
 			}
 			else
@@ -5082,6 +5742,14 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait, const BaseT
 TickType_t xTimeToWake;
 const TickType_t xConstTickCount = xTickCount;
 
+	#if( configUSE_EDF_SCHEDULING == 1 )
+	{
+		/* A job that blocks after its deadline has missed it, whether it
+		blocks to wait for its next release or in the middle of its work. */
+		( void ) prvCheckDeadline( xConstTickCount );
+	}
+	#endif
+
 	#if( INCLUDE_xTaskAbortDelay == 1 )
 	{
 		/* About to enter a delayed list, so ensure the ucDelayAborted flag is
@@ -5127,13 +5795,13 @@ const TickType_t xConstTickCount = xTickCount;
 			{
 				/* Wake time has overflowed.  Place this item in the overflow
 				list. */
-				vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+				vListInsert( taskDELAYED_BUCKET( pxOverflowDelayedTaskList, xTimeToWake ), &( pxCurrentTCB->xStateListItem ) );
 			}
 			else
 			{
 				/* The wake time has not overflowed, so the current block list
 				is used. */
-				vListInsert( pxDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+				vListInsert( taskDELAYED_BUCKET( pxDelayedTaskList, xTimeToWake ), &( pxCurrentTCB->xStateListItem ) );
 
 				/* If the task entering the blocked state was placed at the
 				head of the list of blocked tasks then xNextTaskUnblockTime
@@ -5162,12 +5830,12 @@ const TickType_t xConstTickCount = xTickCount;
 		if( xTimeToWake < xConstTickCount )
 		{
 			/* Wake time has overflowed.  Place this item in the overflow list. */
-			vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+			vListInsert( taskDELAYED_BUCKET( pxOverflowDelayedTaskList, xTimeToWake ), &( pxCurrentTCB->xStateListItem ) );
 		}
 		else
 		{
 			/* The wake time has not overflowed, so the current block list is used. */
-			vListInsert( pxDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+			vListInsert( taskDELAYED_BUCKET( pxDelayedTaskList, xTimeToWake ), &( pxCurrentTCB->xStateListItem ) );
 
 			/* If the task entering the blocked state was placed at the head of the
 			list of blocked tasks then xNextTaskUnblockTime needs to be updated
@@ -5187,6 +5855,227 @@ const TickType_t xConstTickCount = xTickCount;
 	}
 	#endif /* INCLUDE_vTaskSuspend */
 }
+/*-----------------------------------------------------------*/
+
+#if( configUSE_EDF_SCHEDULING == 1 )
+
+	static TCB_t *prvSelectEarliestDeadlineTask( List_t * const pxList )
+	{
+	TCB_t *pxTCB, *pxEarliestTCB;
+	ListItem_t const *pxListItem;
+	ListItem_t const * const pxEndMarker = listGET_END_MARKER( pxList );
+
+		/* Advancing the index keeps tasks without a deadline, and tasks with
+		equal deadlines, sharing the processor round robin. */
+		listGET_OWNER_OF_NEXT_ENTRY( pxEarliestTCB, pxList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+		if( listCURRENT_LIST_LENGTH( pxList ) > ( UBaseType_t ) 1 )
+		{
+			for( pxListItem = listGET_HEAD_ENTRY( pxList ); pxListItem != pxEndMarker; pxListItem = listGET_NEXT( pxListItem ) )
+			{
+				pxTCB = listGET_LIST_ITEM_OWNER( pxListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+				if( taskDEADLINE_IS_EARLIER( pxTCB, pxEarliestTCB ) )
+				{
+					pxEarliestTCB = pxTCB;
+				}
+				else
+				{
+					mtCOVERAGE_TEST_MARKER();
+				}
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return pxEarliestTCB;
+	}
+
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_EDF_SCHEDULING == 1 )
+
+	static BaseType_t prvCheckDeadline( const TickType_t xConstTickCount )
+	{
+		/* The job may still complete during the tick its deadline falls in.
+		Later than that, by less than half the TickType_t range, is a miss. */
+		if( ( pxCurrentTCB->xRelativeDeadline != ( TickType_t ) 0 ) && ( pxCurrentTCB->ucDeadlineMissed == pdFALSE ) )
+		{
+			if( ( TickType_t ) ( xConstTickCount - pxCurrentTCB->xAbsoluteDeadline - ( TickType_t ) 1 ) < ( portMAX_DELAY >> 1 ) )
+			{
+				pxCurrentTCB->ucDeadlineMissed = pdTRUE;
+				( pxCurrentTCB->uxDeadlineMisses )++;
+				traceTASK_DEADLINE_MISSED( pxCurrentTCB );
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		return ( BaseType_t ) pxCurrentTCB->ucDeadlineMissed;
+	}
+
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
+#if( ( configUSE_EDF_SCHEDULING == 1 ) || ( configUSE_PERIODIC_TASKS == 1 ) )
+
+	static BaseType_t prvDelayUntilRelease( const TickType_t xReleaseTime, const TickType_t xConstTickCount )
+	{
+	BaseType_t xReturn;
+
+		/* The deadline follows from the release time, not from the time the
+		task actually starts to run, so a late job keeps its deadline.  The
+		tick that unblocks the task leaves it alone. */
+		taskSET_JOB_DEADLINE( pxCurrentTCB, xReleaseTime );
+
+		/* Same test as vTaskDelayUntil(), but with the signed distance to the
+		release time, which does not need the previous release time. */
+		if( ( ( TickType_t ) ( xReleaseTime - xConstTickCount ) != ( TickType_t ) 0 ) &&
+			( ( TickType_t ) ( xReleaseTime - xConstTickCount ) <= ( portMAX_DELAY >> 1 ) ) )
+		{
+			traceTASK_DELAY_UNTIL( xReleaseTime );
+			prvAddCurrentTaskToDelayedList( xReleaseTime - xConstTickCount, pdFALSE );
+			xReturn = pdTRUE;
+		}
+		else
+		{
+			xReturn = pdFALSE;
+		}
+
+		return xReturn;
+	}
+
+#endif /* ( configUSE_EDF_SCHEDULING == 1 ) || ( configUSE_PERIODIC_TASKS == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_PERIODIC_TASKS == 1 )
+
+	static void prvResetPeriodicStats( TCB_t * const pxTCB )
+	{
+		pxTCB->ulReleases = 0UL;
+		pxTCB->ulOverruns = 0UL;
+		pxTCB->ulMaxReleaseJitter = 0UL;
+		pxTCB->ulMaxResponseTime = 0UL;
+	}
+
+#endif /* configUSE_PERIODIC_TASKS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_PERIODIC_TASKS == 1 )
+
+	static void prvCompletePeriodicJob( const TickType_t xPeriod )
+	{
+	uint32_t ulResponseTime;
+
+		/* The response time runs from the release of the job until it
+		completes, so it includes the release jitter and any time the task was
+		preempted or blocked.  The first job has no recorded release. */
+		if( pxCurrentTCB->ucJobState == tskJOB_RUNNING )
+		{
+			ulResponseTime = configPERIODIC_STATS_ELAPSED( configPERIODIC_STATS_TIME(), pxCurrentTCB->ulReleaseTimestamp );
+
+			if( ulResponseTime > pxCurrentTCB->ulMaxResponseTime )
+			{
+				pxCurrentTCB->ulMaxResponseTime = ulResponseTime;
+			}
+			else
+			{
+				mtCOVERAGE_TEST_MARKER();
+			}
+		}
+		else
+		{
+			mtCOVERAGE_TEST_MARKER();
+		}
+
+		pxCurrentTCB->xPeriod = xPeriod;
+	}
+
+#endif /* configUSE_PERIODIC_TASKS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_PERIODIC_TASKS == 1 )
+
+	static void prvReleaseOverrunJob( const TickType_t xReleaseTime, const TickType_t xConstTickCount )
+	{
+		/* The job is stamped with its nominal release time, not with the time
+		it is noticed, so the overrun shows up in its release jitter.  The
+		elapsed ticks are converted with configPERIODIC_STATS_TIME_PER_TICK,
+		which is exact for the tick time base and within a tick otherwise. */
+		( pxCurrentTCB->ulOverruns )++;
+		( pxCurrentTCB->ulReleases )++;
+		pxCurrentTCB->ulReleaseTimestamp = configPERIODIC_STATS_TIME() - ( ( uint32_t ) ( TickType_t ) ( xConstTickCount - xReleaseTime ) * ( uint32_t ) configPERIODIC_STATS_TIME_PER_TICK );
+		pxCurrentTCB->ucJobState = tskJOB_RELEASED;
+	}
+
+#endif /* configUSE_PERIODIC_TASKS */
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TASK_NOTIFICATIONS == 1 )
+
+	static BaseType_t prvSetNotifiedValue( TCB_t * const pxTCB, const UBaseType_t uxIndexToNotify, const uint32_t ulValue, const eNotifyAction eAction, const uint8_t ucOriginalNotifyState, uint32_t * const pulPreviousNotificationValue )
+	{
+	BaseType_t xReturn = pdPASS;
+
+		if( pulPreviousNotificationValue != NULL )
+		{
+			*pulPreviousNotificationValue = pxTCB->ulNotifiedValue[ uxIndexToNotify ];
+		}
+
+		pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
+
+		switch( eAction )
+		{
+			case eSetBits	:
+				pxTCB->ulNotifiedValue[ uxIndexToNotify ] |= ulValue;
+				break;
+
+			case eIncrement	:
+				( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
+				break;
+
+			case eSetValueWithOverwrite	:
+				pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
+				break;
+
+			case eSetValueWithoutOverwrite :
+				if( ucOriginalNotifyState != taskNOTIFICATION_RECEIVED )
+				{
+					pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
+				}
+				else
+				{
+					/* The value could not be written to the task. */
+					xReturn = pdFAIL;
+				}
+				break;
+
+			case eNoAction:
+				/* The task is being notified without its notify value being
+				updated. */
+				break;
+
+			default:
+				/* Should not get here if all enums are handled.
+				Artificially force an assert by testing a value the
+				compiler can't assume is const. */
+				configASSERT( pxTCB->ulNotifiedValue[ uxIndexToNotify ] == ~0UL );
+				break;
+		}
+
+		return xReturn;
+	}
+
+#endif /* configUSE_TASK_NOTIFICATIONS */
 
 /* Code below here allows additional code to be inserted into this source file,
 especially where access to file scope functions and data is needed (for example
@@ -0,0 +1,407 @@
+/**
+ * @file    main.c
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   hal_dsp accuracy check and benchmark
+ *
+ * Builds ../../ETF5529_HAL/hal_dsp.c on the host with an emulated MPY32
+ * (msp430.h in this directory) and checks every filter against a double
+ * precision reference on a test signal of a sine, noise and a step. Build
+ * and run on the host with:
+ *
+ *   gcc -O2 -I. -I../SchedSim/Host_Sim -I../../FreeRTOS_source/include
+ *       -I../../ETF5529_HAL -o dspbench main.c ../../ETF5529_HAL/hal_dsp.c -lm
+ *   ./dspbench
+ *
+ * Tolerances, in Q15 LSB of the largest difference from the reference:
+ *  - ADC conversion and median: 0, both are exact
+ *  - moving average: 1 for truncation of the scaled sum, plus the error of
+ *    1/N rounded down to Q15 at full scale, 32768 - N * scale, which is 0
+ *    when N is a power of two
+ *  - IIR: 1, the remainder carried between samples keeps the error of the
+ *    recursion from growing
+ *  - CIC: 1 for the final shift, integrators and combs are exact
+ *
+ * Cost per sample is measured the same way as in KernelBench: the filters
+ * run in a child process which the parent single-steps with ptrace, and
+ * the instructions between markers are counted. The counts are host
+ * instructions, not MSP430 cycles, and include a few instructions for every
+ * emulated multiplier access, so they are only meaningful for comparing two
+ * versions of the filters built the same way. The multiplier accesses per
+ * sample are listed as well; on the target each is one MOV to or from a
+ * peripheral register. Exit status is 1 if a filter is out of tolerance.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/ptrace.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+/* User's includes */
+#include "msp430.h"
+#include "hal_dsp.h"
+
+/* Samples of the test signal */
+#define mainSAMPLES                 ( 4096 )
+/* Samples passed to every filter call, as a hal_adc buffer would be */
+#define mainBLOCK                   ( 32 )
+/* Filter parameters */
+#define mainAVERAGE_LENGTH          ( 5 )
+#define mainAVERAGE_LENGTH_POW2     ( 8 )
+#define mainIIR_ALPHA               HAL_DSP_Q15( 0.05 )
+#define mainCIC_ORDER               ( 3 )
+#define mainCIC_RATE_LOG2           ( 3 )
+#define mainMEDIAN_LENGTH           ( 5 )
+#define mainADC_STRIDE              ( 2 )
+
+/* Markers raised by the benchmark around every measured filter */
+#define mainMARKER_START            SIGUSR1
+#define mainMARKER_END              SIGUSR2
+
+#define mainPI                      ( 3.14159265358979323846 )
+
+typedef struct{
+    const char*     name;
+    double          maxError;
+    double          tolerance;
+    uint32_t        mpyAccesses;
+    uint16_t        samples;
+}Result_t;
+
+MPYEmulation_t              xMPY;
+uint32_t                    ulMPYAccesses;
+/* Critical section nesting of the host port macros used by hal_dsp.c */
+volatile uint16_t           usCriticalNesting;
+
+static q15_t                xSignal[mainSAMPLES];
+static q15_t                xOutput[mainSAMPLES];
+static uint16_t             usADC[mainSAMPLES * mainADC_STRIDE];
+
+/**
+ * @brief Sine, noise and a step, kept within half of full scale
+ */
+static void prvMakeSignal( void )
+{
+    uint32_t    seed = 1;
+    double      value;
+    int         i;
+
+    for( i = 0; i < mainSAMPLES; i++ )
+    {
+        seed    = seed * 1103515245UL + 12345UL;
+        value   = 0.3 * sin( 2.0 * mainPI * i / 97.0 );
+        value  += 0.1 * ( ( double )( ( seed >> 16 ) & 0x7FFF ) / 32768.0 - 0.5 );
+        value  += i >= mainSAMPLES / 2 ? 0.1 : -0.1;
+        xSignal[i] = ( q15_t )lrint( value * 32768.0 );
+        /* Channel 0 of two channel frames, channel 1 must be skipped */
+        usADC[i * mainADC_STRIDE]       = ( uint16_t )( ( xSignal[i] >> 4 ) + 2048 );
+        usADC[i * mainADC_STRIDE + 1]   = 0xFFF;
+    }
+}
+
+static double prvError( double reference, q15_t value )
+{
+    return fabs( reference - ( double )value );
+}
+
+static void prvCheckFromADC( Result_t* result )
+{
+    uint16_t    i;
+
+    result->maxError = 0;
+    vHALDSPFromADC( usADC, xOutput, mainSAMPLES, mainADC_STRIDE );
+    for( i = 0; i < mainSAMPLES; i++ )
+    {
+        double reference = ( ( double )usADC[i * mainADC_STRIDE] - 2048.0 ) * 16.0;
+        if( prvError( reference, xOutput[i] ) > result->maxError ) result->maxError = prvError( reference, xOutput[i] );
+    }
+    result->tolerance   = 0;
+    result->samples     = mainSAMPLES;
+}
+
+static void prvCheckMovingAverage( Result_t* result, uint8_t length )
+{
+    DSPMovingAverage_t  filter;
+    q15_t               history[mainAVERAGE_LENGTH_POW2];
+    uint16_t            i, j;
+    double              sum;
+
+    ( void )vHALDSPMovingAverageInit( &filter, history, length );
+    result->tolerance = 1.0 + ( 32768.0 - ( double )length * filter.xScale );
+    for( i = 0; i < mainSAMPLES; i += mainBLOCK )
+    {
+        vHALDSPMovingAverage( &filter, &xSignal[i], &xOutput[i], mainBLOCK );
+    }
+    result->maxError = 0;
+    for( i = 0; i < mainSAMPLES; i++ )
+    {
+        sum = 0;
+        for( j = 0; j < length && j <= i; j++ ) sum += xSignal[i - j];
+        if( prvError( sum / length, xOutput[i] ) > result->maxError ) result->maxError = prvError( sum / length, xOutput[i] );
+    }
+    result->samples = mainSAMPLES;
+}
+
+static void prvCheckIIR( Result_t* result )
+{
+    DSPIIR_t    filter;
+    uint16_t    i;
+    double      alpha, reference = 0;
+
+    ( void )vHALDSPIIRInit( &filter, mainIIR_ALPHA );
+    alpha = filter.xAlpha / 32768.0;
+    for( i = 0; i < mainSAMPLES; i += mainBLOCK )
+    {
+        vHALDSPIIR( &filter, &xSignal[i], &xOutput[i], mainBLOCK );
+    }
+    result->maxError = 0;
+    for( i = 0; i < mainSAMPLES; i++ )
+    {
+        reference = alpha * xSignal[i] + ( 1.0 - alpha ) * reference;
+        if( prvError( reference, xOutput[i] ) > result->maxError ) result->maxError = prvError( reference, xOutput[i] );
+    }
+    result->tolerance   = 1;
+    result->samples     = mainSAMPLES;
+}
+
+static void prvCheckCIC( Result_t* result )
+{
+    DSPCIC_t    filter;
+    uint16_t    i, written = 0;
+    uint8_t     stage;
+    uint16_t    rate = 1 << mainCIC_RATE_LOG2;
+    /* Every stage is a moving sum of rate samples */
+    static double stageIn[mainCIC_ORDER + 1][mainSAMPLES];
+    double      sum, reference;
+    int         k;
+
+    ( void )vHALDSPCICInit( &filter, mainCIC_ORDER, mainCIC_RATE_LOG2 );
+    for( i = 0; i < mainSAMPLES; i += mainBLOCK )
+    {
+        written += usHALDSPCIC( &filter, &xSignal[i], &xOutput[written], mainBLOCK );
+    }
+    for( i = 0; i < mainSAMPLES; i++ ) stageIn[0][i] = xSignal[i];
+    for( stage = 0; stage < mainCIC_ORDER; stage++ )
+    {
+        for( i = 0; i < mainSAMPLES; i++ )
+        {
+            sum = 0;
+            for( k = 0; k < rate && k <= i; k++ ) sum += stageIn[stage][i - k];
+            stageIn[stage + 1][i] = sum;
+        }
+    }
+    result->maxError = written == mainSAMPLES / rate ? 0 : 32768;
+    for( i = 0; i < written; i++ )
+    {
+        reference = stageIn[mainCIC_ORDER][( i + 1 ) * rate - 1] / ( double )( 1UL << filter.ucShift );
+        if( prvError( reference, xOutput[i] ) > result->maxError ) result->maxError = prvError( reference, xOutput[i] );
+    }
+    result->tolerance   = 1;
+    result->samples     = mainSAMPLES;
+}
+
+static int prvCompareQ15( const void* a, const void* b )
+{
+    return *( const q15_t* )a - *( const q15_t* )b;
+}
+
+static void prvCheckMedian( Result_t* result )
+{
+    DSPMedian_t filter;
+    q15_t       history[mainMEDIAN_LENGTH], sorted[mainMEDIAN_LENGTH];
+    q15_t       window[mainMEDIAN_LENGTH];
+    uint16_t    i, j;
+
+    ( void )vHALDSPMedianInit( &filter, history, sorted, mainMEDIAN_LENGTH );
+    for( i = 0; i < mainSAMPLES; i += mainBLOCK )
+    {
+        vHALDSPMedian( &filter, &xSignal[i], &xOutput[i], mainBLOCK );
+    }
+    result->maxError = 0;
+    for( i = 0; i < mainSAMPLES; i++ )
+    {
+        for( j = 0; j < mainMEDIAN_LENGTH; j++ ) window[j] = j <= i ? xSignal[i - j] : 0;
+        qsort( window, mainMEDIAN_LENGTH, sizeof( q15_t ), prvCompareQ15 );
+        if( prvError( window[mainMEDIAN_LENGTH / 2], xOutput[i] ) > result->maxError )
+        {
+            result->maxError = prvError( window[mainMEDIAN_LENGTH / 2], xOutput[i] );
+        }
+    }
+    result->tolerance   = 0;
+    result->samples     = mainSAMPLES;
+}
+
+/**
+ * @brief Runs every filter once between markers on one block of the signal
+ */
+static void prvRunBenchmark( void )
+{
+    DSPMovingAverage_t  average;
+    DSPIIR_t            iir;
+    DSPCIC_t            cic;
+    DSPMedian_t         median;
+    q15_t               history[mainAVERAGE_LENGTH_POW2], sorted[mainMEDIAN_LENGTH];
+
+    /* Nothing is measured, gives the cost of the markers themselves */
+    raise( mainMARKER_START );
+    raise( mainMARKER_END );
+
+    raise( mainMARKER_START );
+    vHALDSPFromADC( usADC, xOutput, mainBLOCK, mainADC_STRIDE );
+    raise( mainMARKER_END );
+
+    ( void )vHALDSPMovingAverageInit( &average, history, mainAVERAGE_LENGTH );
+    raise( mainMARKER_START );
+    vHALDSPMovingAverage( &average, xSignal, xOutput, mainBLOCK );
+    raise( mainMARKER_END );
+
+    ( void )vHALDSPMovingAverageInit( &average, history, mainAVERAGE_LENGTH_POW2 );
+    raise( mainMARKER_START );
+    vHALDSPMovingAverage( &average, xSignal, xOutput, mainBLOCK );
+    raise( mainMARKER_END );
+
+    ( void )vHALDSPIIRInit( &iir, mainIIR_ALPHA );
+    raise( mainMARKER_START );
+    vHALDSPIIR( &iir, xSignal, xOutput, mainBLOCK );
+    raise( mainMARKER_END );
+
+    ( void )vHALDSPCICInit( &cic, mainCIC_ORDER, mainCIC_RATE_LOG2 );
+    raise( mainMARKER_START );
+    ( void )usHALDSPCIC( &cic, xSignal, xOutput, mainBLOCK );
+    raise( mainMARKER_END );
+
+    ( void )vHALDSPMedianInit( &median, history, sorted, mainMEDIAN_LENGTH );
+    raise( mainMARKER_START );
+    vHALDSPMedian( &median, xSignal, xOutput, mainBLOCK );
+    raise( mainMARKER_END );
+}
+
+/**
+ * @brief Single-step the child between markers, fills counts per filter
+ */
+static int prvTraceBenchmark( pid_t child, uint64_t* counts, int countsLength )
+{
+    int         status, measured = 0, counting = 0, stopSignal;
+
+    for( ;; )
+    {
+        if( waitpid( child, &status, 0 ) < 0 )
+        {
+            perror( "waitpid" );
+            return -1;
+        }
+        if( WIFEXITED( status ) ) break;
+        if( !WIFSTOPPED( status ) )
+        {
+            fprintf( stderr, "benchmark terminated abnormally\n" );
+            return -1;
+        }
+        stopSignal = WSTOPSIG( status );
+        if( stopSignal == mainMARKER_START && measured < countsLength )
+        {
+            counting            = 1;
+            counts[measured]    = 0;
+            stopSignal          = 0;
+        }
+        else if( stopSignal == mainMARKER_END )
+        {
+            counting = 0;
+            measured++;
+            stopSignal = 0;
+        }
+        else if( stopSignal == SIGTRAP || stopSignal == SIGSTOP )
+        {
+            stopSignal = 0;
+        }
+        if( counting )
+        {
+            counts[measured]++;
+            if( ptrace( PTRACE_SINGLESTEP, child, NULL, ( void* )( intptr_t )stopSignal ) < 0 ) return -1;
+        }
+        else
+        {
+            if( ptrace( PTRACE_CONT, child, NULL, ( void* )( intptr_t )stopSignal ) < 0 ) return -1;
+        }
+    }
+    if( measured != countsLength )
+    {
+        fprintf( stderr, "benchmark measured %d of %d filters\n", measured, countsLength );
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief main function
+ */
+int main( void )
+{
+    Result_t        results[6] = {
+        { .name = "from_adc" },
+        { .name = "moving_average_5" },
+        { .name = "moving_average_8" },
+        { .name = "iir" },
+        { .name = "cic_3_8" },
+        { .name = "median_5" },
+    };
+    const int       resultCount = sizeof( results ) / sizeof( results[0] );
+    uint64_t        counts[sizeof( results ) / sizeof( results[0] ) + 1];
+    uint32_t        accesses;
+    pid_t           child;
+    int             i, failures = 0;
+
+    prvMakeSignal();
+
+    for( i = 0; i < resultCount; i++ )
+    {
+        accesses = ulMPYAccesses;
+        switch( i )
+        {
+        case 0: prvCheckFromADC( &results[i] ); break;
+        case 1: prvCheckMovingAverage( &results[i], mainAVERAGE_LENGTH ); break;
+        case 2: prvCheckMovingAverage( &results[i], mainAVERAGE_LENGTH_POW2 ); break;
+        case 3: prvCheckIIR( &results[i] ); break;
+        case 4: prvCheckCIC( &results[i] ); break;
+        default: prvCheckMedian( &results[i] ); break;
+        }
+        results[i].mpyAccesses = ulMPYAccesses - accesses;
+    }
+
+    child = fork();
+    if( child < 0 )
+    {
+        perror( "fork" );
+        return 2;
+    }
+    if( child == 0 )
+    {
+        if( ptrace( PTRACE_TRACEME, 0, NULL, NULL ) < 0 )
+        {
+            perror( "ptrace" );
+            _exit( 2 );
+        }
+        raise( SIGSTOP );
+        prvRunBenchmark();
+        _exit( 0 );
+    }
+    if( prvTraceBenchmark( child, counts, resultCount + 1 ) != 0 ) return 2;
+
+    printf( "%-20s %10s %10s %14s %12s\n", "Filter", "Error LSB", "Tolerance", "Instr/sample", "MPY/sample" );
+    for( i = 0; i < resultCount; i++ )
+    {
+        printf( "%-20s %10.3f %10.0f %14.1f %12.1f%s\n", results[i].name, results[i].maxError, results[i].tolerance,
+                ( double )( counts[i + 1] - counts[0] ) / mainBLOCK,
+                ( double )results[i].mpyAccesses / results[i].samples,
+                results[i].maxError > results[i].tolerance ? "  FAIL" : "" );
+        if( results[i].maxError > results[i].tolerance ) failures++;
+    }
+    return failures != 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file    msp430.h
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   Host emulation of the MPY32 registers used by hal_dsp.c
+ *
+ * Stands in for the device header when hal_dsp.c is built on the host. Every
+ * register access goes through prvMPYAccess, which first completes an
+ * operation started by the last write to OP2, so the results read after it
+ * are the ones the multiplier would have. Supported operations are the ones
+ * hal_dsp uses:
+ *  - MPYS32L, MPYS32H then OP2: signed 32x16 multiply, 48 bit result in
+ *    RES0..RES2, sign extended into RES3
+ *  - MACS then OP2: signed 16x16 multiply added to RESLO, RESHI
+ * RESLO and RESHI share storage with RES0 and RES1. Every access is also
+ * counted in ulMPYAccesses.
+ */
+
+#ifndef DSPBENCH_MSP430_H_
+#define DSPBENCH_MSP430_H_
+
+#include <stdint.h>
+
+#define MPY_OP1_32          0
+#define MPY_OP1_MACS        1
+
+typedef struct{
+    uint16_t        usOP1[2];
+    uint16_t        usOP2;
+    uint16_t        usRes[4];
+    uint8_t         ucMode;
+    uint8_t         ucPending;
+}MPYEmulation_t;
+
+extern MPYEmulation_t   xMPY;
+extern uint32_t         ulMPYAccesses;
+
+static inline void prvMPYComplete( void )
+{
+    int64_t     product;
+    int64_t     accumulator;
+
+    if( !xMPY.ucPending ) return;
+    xMPY.ucPending = 0;
+    if( xMPY.ucMode == MPY_OP1_32 )
+    {
+        product = ( int64_t )( int32_t )( ( ( uint32_t )xMPY.usOP1[1] << 16 ) | xMPY.usOP1[0] ) *
+                  ( int16_t )xMPY.usOP2;
+        xMPY.usRes[0] = ( uint16_t )product;
+        xMPY.usRes[1] = ( uint16_t )( product >> 16 );
+        xMPY.usRes[2] = ( uint16_t )( product >> 32 );
+        xMPY.usRes[3] = ( uint16_t )( product >> 48 );
+    }
+    else
+    {
+        accumulator  = ( int32_t )( ( ( uint32_t )xMPY.usRes[1] << 16 ) | xMPY.usRes[0] );
+        accumulator += ( int32_t )( int16_t )xMPY.usOP1[0] * ( int16_t )xMPY.usOP2;
+        xMPY.usRes[0] = ( uint16_t )accumulator;
+        xMPY.usRes[1] = ( uint16_t )( accumulator >> 16 );
+    }
+}
+
+static inline volatile uint16_t* prvMPYAccess( uint16_t* reg, uint8_t mode )
+{
+    prvMPYComplete();
+    ulMPYAccesses++;
+    if( mode != 0xFF ) xMPY.ucMode = mode;
+    return reg;
+}
+
+static inline volatile uint16_t* prvMPYStart( void )
+{
+    prvMPYComplete();
+    ulMPYAccesses++;
+    xMPY.ucPending = 1;
+    return &xMPY.usOP2;
+}
+
+#define MPYS32L     ( *prvMPYAccess( &xMPY.usOP1[0], MPY_OP1_32 ) )
+#define MPYS32H     ( *prvMPYAccess( &xMPY.usOP1[1], MPY_OP1_32 ) )
+#define MACS        ( *prvMPYAccess( &xMPY.usOP1[0], MPY_OP1_MACS ) )
+#define OP2         ( *prvMPYStart() )
+#define RES0        ( *prvMPYAccess( &xMPY.usRes[0], 0xFF ) )
+#define RES1        ( *prvMPYAccess( &xMPY.usRes[1], 0xFF ) )
+#define RES2        ( *prvMPYAccess( &xMPY.usRes[2], 0xFF ) )
+#define RES3        ( *prvMPYAccess( &xMPY.usRes[3], 0xFF ) )
+#define RESLO       RES0
+#define RESHI       RES1
+
+#endif /* DSPBENCH_MSP430_H_ */
@@ -0,0 +1,556 @@
+/**
+ * @file    main.c
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   Kernel primitive benchmark
+ *
+ * Runs a fixed mix of kernel workloads on the host port (../SchedSim/Host_Sim)
+ * and counts the instructions each of them executes. The benchmark runs in a
+ * child process which the parent single-steps with ptrace between markers,
+ * so counts are exact and the same on every run of the same binary. Build
+ * and run on the host with:
+ *
+ *   gcc -O2 -I. -I../SchedSim/Host_Sim -I../../FreeRTOS_source/include
+ *       -o kernelbench main.c ../SchedSim/Host_Sim/port.c
+ *       ../../FreeRTOS_source/tasks.c ../../FreeRTOS_source/queue.c
+ *       ../../FreeRTOS_source/list.c ../../FreeRTOS_source/timers.c
+ *       ../../FreeRTOS_source/event_groups.c
+ *       ../../FreeRTOS_source/portable/MemMang/heap_1.c
+ *   ./kernelbench -w baseline.txt      record counts before a change
+ *   ./kernelbench -b baseline.txt      compare after the change
+ *   ./kernelbench -s 64                64 more tasks blocked with a timeout
+ *
+ * Sleeper tasks (-s) stay blocked with different timeouts for the whole run,
+ * so the delayed list is as long as in an application with that many
+ * periodic tasks. timed_handoff blocks the controller with a timeout that
+ * expires after all of them, which is the longest delayed list insertion.
+ * notify_storm wakes a task waiting for its notification on every call,
+ * notify_burst and notify_burst_isr notify a task that is not waiting, which
+ * is the usual case when an interrupt or a task posts events faster than the
+ * receiver handles them. isr_storm wakes several tasks from interrupts while
+ * the scheduler is suspended and resumes it.
+ * Counts depend on the compiler and its options, so a baseline is only
+ * meaningful for a binary built the same way. When comparing, exit status is
+ * 1 if any workload executes more than the threshold (-t, percent, default
+ * 1) instructions per operation above its baseline.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/ptrace.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "timers.h"
+#include "event_groups.h"
+
+/* Operations performed by every workload */
+#define mainROUNDS                  ( 100 )
+/* Tasks woken by every event group broadcast */
+#define mainBROADCAST_WAITERS       ( 4 )
+/* Tasks woken by every interrupt storm */
+#define mainSTORM_WAITERS           ( 8 )
+/* Timers used by timer churn workload */
+#define mainCHURN_TIMERS            ( 4 )
+
+/* Controller drives every workload, helpers have higher priority so each
+operation completes before the controller continues */
+#define mainCONTROLLER_TASK_PRIO    ( 2 )
+#define mainHELPER_TASK_PRIO        ( 3 )
+/* Runs only when the controller blocks */
+#define mainLOW_HELPER_TASK_PRIO    ( 1 )
+
+/* Sleeper timeouts, all expire after the benchmark ends */
+#define mainSLEEPER_TIMEOUT         ( 2000 )
+#define mainSLEEPER_TIMEOUT_STEP    ( 97 )
+#define mainTIMED_HANDOFF_TIMEOUT   ( 30000 )
+
+/* Markers raised by the benchmark around every measured workload */
+#define mainMARKER_START            SIGUSR1
+#define mainMARKER_END              SIGUSR2
+
+typedef void ( *WorkloadFunction_t )( void );
+
+typedef struct{
+    const char*         name;
+    WorkloadFunction_t  function;
+}Workload_t;
+
+static QueueHandle_t        xPingQueue;
+static QueueHandle_t        xPongQueue;
+static SemaphoreHandle_t    xHandoffRequest;
+static SemaphoreHandle_t    xHandoffReply;
+static SemaphoreHandle_t    xTimedRequest;
+static SemaphoreHandle_t    xTimedReply;
+static SemaphoreHandle_t    xSleeperSemaphore;
+static int                  iSleepers;
+static TaskHandle_t         xNotifyTaskHandle;
+static TaskHandle_t         xBurstTaskHandle;
+static TimerHandle_t        xChurnTimers[mainCHURN_TIMERS];
+static EventGroupHandle_t   xBroadcastGroup;
+static SemaphoreHandle_t    xStormSemaphores[mainSTORM_WAITERS];
+
+#define mainBROADCAST_ALL_BITS      ( ( 1UL << ( mainBROADCAST_WAITERS + 1 ) ) - 1 )
+#define mainBROADCAST_CONTROLLER    ( 1UL << mainBROADCAST_WAITERS )
+
+/* Nothing is measured, gives the cost of the markers themselves */
+static void prvEmptyWorkload( void )
+{
+}
+
+static void prvQueuePingPong( void )
+{
+    uint32_t i, value;
+    for( i = 0; i < mainROUNDS; i++ )
+    {
+        ( void )xQueueSend( xPingQueue, &i, portMAX_DELAY );
+        ( void )xQueueReceive( xPongQueue, &value, portMAX_DELAY );
+    }
+}
+
+static void prvSemaphoreHandoff( void )
+{
+    uint32_t i;
+    for( i = 0; i < mainROUNDS; i++ )
+    {
+        ( void )xSemaphoreGive( xHandoffRequest );
+        ( void )xSemaphoreTake( xHandoffReply, portMAX_DELAY );
+    }
+}
+
+/* Reply comes from a lower priority task, so the controller is delayed every time */
+static void prvTimedHandoff( void )
+{
+    uint32_t i;
+    for( i = 0; i < mainROUNDS; i++ )
+    {
+        ( void )xSemaphoreGive( xTimedRequest );
+        ( void )xSemaphoreTake( xTimedReply, mainTIMED_HANDOFF_TIMEOUT );
+    }
+}
+
+static void prvNotificationStorm( void )
+{
+    uint32_t i;
+    for( i = 0; i < mainROUNDS; i++ )
+    {
+        ( void )xTaskNotifyGive( xNotifyTaskHandle );
+    }
+}
+
+/* Receiver is not waiting for its notification, only the value changes */
+static void prvNotificationBurst( void )
+{
+    uint32_t i;
+    for( i = 0; i < mainROUNDS; i++ )
+    {
+        ( void )xTaskNotify( xBurstTaskHandle, 1UL << ( i & 0x0F ), eSetBits );
+    }
+}
+
+/* Same from an interrupt, the controller stands in for the ISR */
+static void prvNotificationBurstFromISR( void )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uint32_t i;
+    for( i = 0; i < mainROUNDS; i++ )
+    {
+        vTaskNotifyGiveFromISR( xBurstTaskHandle, &xHigherPriorityTaskWoken );
+    }
+}
+
+/* Interrupts wake every storm waiter while the scheduler is suspended, all of
+them become ready when it is resumed */
+static void prvInterruptStorm( void )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    uint32_t i, j;
+    for( i = 0; i < mainROUNDS; i++ )
+    {
+        vTaskSuspendAll();
+        for( j = 0; j < mainSTORM_WAITERS; j++ )
+        {
+            ( void )xSemaphoreGiveFromISR( xStormSemaphores[j], &xHigherPriorityTaskWoken );
+        }
+        ( void )xTaskResumeAll();
+    }
+}
+
+static void prvTimerChurn( void )
+{
+    uint32_t i;
+    for( i = 0; i < mainROUNDS; i++ )
+    {
+        ( void )xTimerChangePeriod( xChurnTimers[i % mainCHURN_TIMERS], 10 + i, portMAX_DELAY );
+        ( void )xTimerStop( xChurnTimers[i % mainCHURN_TIMERS], portMAX_DELAY );
+    }
+}
+
+static void prvEventGroupBroadcast( void )
+{
+    uint32_t i;
+    for( i = 0; i < mainROUNDS; i++ )
+    {
+        /* Helpers already wait, the controller completes the barrier */
+        ( void )xEventGroupSync( xBroadcastGroup, mainBROADCAST_CONTROLLER, mainBROADCAST_ALL_BITS, portMAX_DELAY );
+    }
+}
+
+/* Same work as the tick interrupt when no task is due, nothing is unblocked */
+static void prvTickIncrement( void )
+{
+    uint32_t i;
+    for( i = 0; i < mainROUNDS; i++ )
+    {
+        ( void )xTaskIncrementTick();
+    }
+}
+
+static void prvTickRead( void )
+{
+    volatile TickType_t ticks;
+    uint32_t i;
+    for( i = 0; i < mainROUNDS; i++ )
+    {
+        ticks = xTaskGetTickCount();
+    }
+    ( void )ticks;
+}
+
+static const Workload_t xWorkloads[] = {
+    { "empty",              prvEmptyWorkload },
+    { "queue_ping_pong",    prvQueuePingPong },
+    { "semaphore_handoff",  prvSemaphoreHandoff },
+    { "timed_handoff",      prvTimedHandoff },
+    { "notify_storm",       prvNotificationStorm },
+    { "notify_burst",       prvNotificationBurst },
+    { "notify_burst_isr",   prvNotificationBurstFromISR },
+    { "isr_storm",          prvInterruptStorm },
+    { "timer_churn",        prvTimerChurn },
+    { "event_broadcast",    prvEventGroupBroadcast },
+    { "tick_increment",     prvTickIncrement },
+    { "tick_read",          prvTickRead },
+};
+#define mainWORKLOAD_COUNT          ( ( int )( sizeof( xWorkloads ) / sizeof( xWorkloads[0] ) ) )
+
+static void prvPongTaskFunction( void *pvParameters )
+{
+    uint32_t value;
+    ( void )pvParameters;
+    for( ;; )
+    {
+        ( void )xQueueReceive( xPingQueue, &value, portMAX_DELAY );
+        ( void )xQueueSend( xPongQueue, &value, portMAX_DELAY );
+    }
+}
+
+static void prvHandoffTaskFunction( void *pvParameters )
+{
+    ( void )pvParameters;
+    for( ;; )
+    {
+        ( void )xSemaphoreTake( xHandoffRequest, portMAX_DELAY );
+        ( void )xSemaphoreGive( xHandoffReply );
+    }
+}
+
+static void prvTimedHandoffTaskFunction( void *pvParameters )
+{
+    ( void )pvParameters;
+    for( ;; )
+    {
+        ( void )xSemaphoreTake( xTimedRequest, portMAX_DELAY );
+        ( void )xSemaphoreGive( xTimedReply );
+    }
+}
+
+/* Semaphore is never given, every sleeper just waits for its timeout */
+static void prvSleeperTaskFunction( void *pvParameters )
+{
+    TickType_t timeout = ( TickType_t )( mainSLEEPER_TIMEOUT + mainSLEEPER_TIMEOUT_STEP * ( uintptr_t )pvParameters );
+    for( ;; )
+    {
+        ( void )xSemaphoreTake( xSleeperSemaphore, timeout );
+    }
+}
+
+static void prvNotifyTaskFunction( void *pvParameters )
+{
+    ( void )pvParameters;
+    for( ;; )
+    {
+        ( void )ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+    }
+}
+
+/* Never waits for a notification, so every notification it gets is a burst */
+static void prvBurstTaskFunction( void *pvParameters )
+{
+    ( void )pvParameters;
+    for( ;; )
+    {
+        vTaskSuspend( NULL );
+    }
+}
+
+static void prvStormTaskFunction( void *pvParameters )
+{
+    for( ;; )
+    {
+        ( void )xSemaphoreTake( xStormSemaphores[( uintptr_t )pvParameters], portMAX_DELAY );
+    }
+}
+
+static void prvBroadcastTaskFunction( void *pvParameters )
+{
+    EventBits_t bit = ( EventBits_t )( 1UL << ( uintptr_t )pvParameters );
+    for( ;; )
+    {
+        ( void )xEventGroupSync( xBroadcastGroup, bit, mainBROADCAST_ALL_BITS, portMAX_DELAY );
+    }
+}
+
+static void prvChurnTimerCallback( TimerHandle_t xTimer )
+{
+    ( void )xTimer;
+}
+
+/**
+ * @brief "Controller Task" Function
+ *
+ * Runs every workload between markers and ends the scheduler
+ */
+static void prvControllerTaskFunction( void *pvParameters )
+{
+    int i;
+    ( void )pvParameters;
+    for( i = 0; i < mainWORKLOAD_COUNT; i++ )
+    {
+        raise( mainMARKER_START );
+        xWorkloads[i].function();
+        raise( mainMARKER_END );
+    }
+    vTaskEndScheduler();
+}
+
+void vApplicationIdleHook( void )
+{
+    vPortSimIdle();
+}
+
+static void prvRunBenchmark( void )
+{
+    uintptr_t i;
+
+    xPingQueue      = xQueueCreate( 1, sizeof( uint32_t ) );
+    xPongQueue      = xQueueCreate( 1, sizeof( uint32_t ) );
+    xHandoffRequest = xSemaphoreCreateBinary();
+    xHandoffReply   = xSemaphoreCreateBinary();
+    xTimedRequest   = xSemaphoreCreateBinary();
+    xTimedReply     = xSemaphoreCreateBinary();
+    xSleeperSemaphore = xSemaphoreCreateBinary();
+    xBroadcastGroup = xEventGroupCreate();
+    for( i = 0; i < mainSTORM_WAITERS; i++ )
+    {
+        xStormSemaphores[i] = xSemaphoreCreateBinary();
+    }
+    for( i = 0; i < mainCHURN_TIMERS; i++ )
+    {
+        xChurnTimers[i] = xTimerCreate( "Churn", 10, pdFALSE, NULL, prvChurnTimerCallback );
+    }
+    xTaskCreate( prvPongTaskFunction, "Pong", configMINIMAL_STACK_SIZE, NULL, mainHELPER_TASK_PRIO, NULL );
+    xTaskCreate( prvHandoffTaskFunction, "Handoff", configMINIMAL_STACK_SIZE, NULL, mainHELPER_TASK_PRIO, NULL );
+    xTaskCreate( prvTimedHandoffTaskFunction, "Timed", configMINIMAL_STACK_SIZE, NULL, mainLOW_HELPER_TASK_PRIO, NULL );
+    for( i = 0; i < mainSTORM_WAITERS; i++ )
+    {
+        xTaskCreate( prvStormTaskFunction, "Storm", configMINIMAL_STACK_SIZE, ( void* )i, mainHELPER_TASK_PRIO, NULL );
+    }
+    for( i = 0; i < ( uintptr_t )iSleepers; i++ )
+    {
+        xTaskCreate( prvSleeperTaskFunction, "Sleeper", configMINIMAL_STACK_SIZE, ( void* )i, mainHELPER_TASK_PRIO, NULL );
+    }
+    xTaskCreate( prvNotifyTaskFunction, "Notify", configMINIMAL_STACK_SIZE, NULL, mainHELPER_TASK_PRIO, &xNotifyTaskHandle );
+    xTaskCreate( prvBurstTaskFunction, "Burst", configMINIMAL_STACK_SIZE, NULL, mainHELPER_TASK_PRIO, &xBurstTaskHandle );
+    for( i = 0; i < mainBROADCAST_WAITERS; i++ )
+    {
+        xTaskCreate( prvBroadcastTaskFunction, "Waiter", configMINIMAL_STACK_SIZE, ( void* )i, mainHELPER_TASK_PRIO, NULL );
+    }
+    xTaskCreate( prvControllerTaskFunction, "Controller", configMINIMAL_STACK_SIZE, NULL, mainCONTROLLER_TASK_PRIO, NULL );
+
+    vTaskStartScheduler();
+}
+
+/**
+ * @brief Single-step the child between markers, fills counts per workload
+ */
+static int prvTraceBenchmark( pid_t child, uint64_t* counts )
+{
+    int         status, workload = 0, counting = 0, stopSignal;
+
+    for( ;; )
+    {
+        if( waitpid( child, &status, 0 ) < 0 )
+        {
+            perror( "waitpid" );
+            return -1;
+        }
+        if( WIFEXITED( status ) ) break;
+        if( !WIFSTOPPED( status ) )
+        {
+            fprintf( stderr, "benchmark terminated abnormally\n" );
+            return -1;
+        }
+        stopSignal = WSTOPSIG( status );
+        if( stopSignal == mainMARKER_START )
+        {
+            counting            = 1;
+            counts[workload]    = 0;
+            stopSignal              = 0;
+        }
+        else if( stopSignal == mainMARKER_END )
+        {
+            counting = 0;
+            workload++;
+            stopSignal = 0;
+        }
+        else if( stopSignal == SIGTRAP || stopSignal == SIGSTOP )
+        {
+            stopSignal = 0;
+        }
+        if( counting )
+        {
+            counts[workload]++;
+            if( ptrace( PTRACE_SINGLESTEP, child, NULL, ( void* )( intptr_t )stopSignal ) < 0 ) return -1;
+        }
+        else
+        {
+            if( ptrace( PTRACE_CONT, child, NULL, ( void* )( intptr_t )stopSignal ) < 0 ) return -1;
+        }
+    }
+    if( workload != mainWORKLOAD_COUNT )
+    {
+        fprintf( stderr, "benchmark finished %d of %d workloads\n", workload, mainWORKLOAD_COUNT );
+        return -1;
+    }
+    return 0;
+}
+
+static int prvLoadBaseline( const char* fileName, uint64_t* baseline )
+{
+    FILE*               file = fopen( fileName, "r" );
+    char                name[32];
+    unsigned long long  value;
+    int                 i;
+
+    if( file == NULL )
+    {
+        perror( fileName );
+        return -1;
+    }
+    for( i = 0; i < mainWORKLOAD_COUNT; i++ ) baseline[i] = 0;
+    while( fscanf( file, "%31s %llu", name, &value ) == 2 )
+    {
+        for( i = 0; i < mainWORKLOAD_COUNT; i++ )
+        {
+            if( strcmp( name, xWorkloads[i].name ) == 0 ) baseline[i] = value;
+        }
+    }
+    fclose( file );
+    return 0;
+}
+
+/**
+ * @brief main function
+ */
+int main( int argc, char** argv )
+{
+    const char*     baselineFile    = NULL;
+    const char*     outputFile      = NULL;
+    double          threshold       = 1.0;
+    uint64_t        counts[mainWORKLOAD_COUNT];
+    uint64_t        baseline[mainWORKLOAD_COUNT];
+    uint64_t        perOperation;
+    double          change;
+    FILE*           output;
+    pid_t           child;
+    int             option, i, regressions = 0;
+
+    while( ( option = getopt( argc, argv, "b:w:t:s:" ) ) != -1 )
+    {
+        switch( option )
+        {
+        case 'b': baselineFile  = optarg; break;
+        case 'w': outputFile    = optarg; break;
+        case 't': threshold     = atof( optarg ); break;
+        case 's': iSleepers     = atoi( optarg ); break;
+        default:
+            fprintf( stderr, "usage: %s [-b baseline] [-w baseline] [-t percent] [-s sleepers]\n", argv[0] );
+            return 2;
+        }
+    }
+    if( baselineFile != NULL && prvLoadBaseline( baselineFile, baseline ) != 0 ) return 2;
+
+    child = fork();
+    if( child < 0 )
+    {
+        perror( "fork" );
+        return 2;
+    }
+    if( child == 0 )
+    {
+        if( ptrace( PTRACE_TRACEME, 0, NULL, NULL ) < 0 )
+        {
+            perror( "ptrace" );
+            _exit( 2 );
+        }
+        raise( SIGSTOP );
+        prvRunBenchmark();
+        _exit( 0 );
+    }
+    if( prvTraceBenchmark( child, counts ) != 0 ) return 2;
+
+    /* Per operation counts without the cost of the markers */
+    printf( "%-20s %12s %12s %12s %8s\n", "Workload", "Instructions", "Per op", "Baseline", "Change" );
+    for( i = 1; i < mainWORKLOAD_COUNT; i++ )
+    {
+        perOperation = ( counts[i] - counts[0] ) / mainROUNDS;
+        printf( "%-20s %12llu %12llu", xWorkloads[i].name, ( unsigned long long )counts[i],
+                ( unsigned long long )perOperation );
+        if( baselineFile != NULL && baseline[i] != 0 )
+        {
+            change = 100.0 * ( ( double )perOperation - ( double )baseline[i] ) / ( double )baseline[i];
+            printf( " %12llu %+7.2f%%%s\n", ( unsigned long long )baseline[i], change,
+                    change > threshold ? "  REGRESSION" : "" );
+            if( change > threshold ) regressions++;
+        }
+        else
+        {
+            printf( " %12s %8s\n", "-", "-" );
+        }
+        counts[i] = perOperation;
+    }
+    if( outputFile != NULL )
+    {
+        output = fopen( outputFile, "w" );
+        if( output == NULL )
+        {
+            perror( outputFile );
+            return 2;
+        }
+        for( i = 1; i < mainWORKLOAD_COUNT; i++ )
+        {
+            fprintf( output, "%s %llu\n", xWorkloads[i].name, ( unsigned long long )counts[i] );
+        }
+        fclose( output );
+    }
+    return regressions != 0;
+}
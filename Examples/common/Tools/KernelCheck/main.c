@@ -0,0 +1,375 @@
+/**
+ * @file    main.c
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   Kernel feature checks
+ *
+ * Runs the optional kernel features that the SRV_2_x examples do not turn on
+ * on the host port (../SchedSim/Host_Sim) and checks their results. Time
+ * only passes while the idle task runs, so every blocked time is an exact
+ * number of ticks. Build and run on the host with:
+ *
+ *   gcc -O2 -I. -I../SchedSim/Host_Sim -I../../FreeRTOS_source/include
+ *       -o kernelcheck main.c ../SchedSim/Host_Sim/port.c
+ *       ../../FreeRTOS_source/tasks.c ../../FreeRTOS_source/queue.c
+ *       ../../FreeRTOS_source/list.c ../../FreeRTOS_source/croutine.c
+ *       ../../FreeRTOS_source/portable/MemMang/heap_1.c
+ *   ./kernelcheck
+ *
+ * Queue statistics (configUSE_QUEUE_STATISTICS):
+ *  - peak occupancy is kept after the queue drains and restarts from the
+ *    current occupancy on reset
+ *  - sends that fail are counted from tasks, with and without a timeout,
+ *    and from interrupts, for a queue and a semaphore
+ *  - a receiver that is woken, loses the item to a higher priority task and
+ *    blocks again is blocked from its first block until it gets an item
+ *  - wakeups count every task the queue readies
+ *  - the registry listing holds every registered queue with the same
+ *    statistics as vQueueGetStatistics
+ * Co-routine notifications (crNOTIFY_TAKE):
+ *  - every notification given from a task to a waiting co-routine is taken
+ *  - gives before the co-routine runs are taken as one
+ *  - a waiting co-routine times out once every timeout, and a give from an
+ *    interrupt wakes it without a timeout
+ *  - a give in the tick the timeout expires wakes the co-routine with the
+ *    notification instead of being lost
+ *  - a co-routine in crDELAY keeps its rate while the others are notified
+ * Every failed check is printed with its line, exit status is 1 if any
+ * check fails.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "croutine.h"
+
+/* Controller runs every check, receiver has lower priority so an item sent
+to it can be taken back before it runs */
+#define mainCONTROLLER_TASK_PRIO    ( 2 )
+#define mainLOW_HELPER_TASK_PRIO    ( 1 )
+
+#define mainDATA_QUEUE_LENGTH       ( 4 )
+#define mainSEND_TIMEOUT            ( 5 )
+/* Receiver loses its first item after mainFIRST_WAIT ticks and gets the
+second one mainSECOND_WAIT ticks later, all before its timeout */
+#define mainRECEIVE_TIMEOUT         ( 1000 )
+#define mainFIRST_WAIT              ( 10 )
+#define mainSECOND_WAIT             ( 20 )
+#define mainREGISTRY_ENTRIES        ( configQUEUE_REGISTRY_SIZE )
+
+#define mainCR_COUNT                ( 3 )
+#define mainCR_NOTIFICATIONS        ( 20 )
+#define mainCR_TIMEOUT              ( 5 )
+#define mainCR_TIMEOUTS             ( 4 )
+#define mainCR_PERIOD               ( 3 )
+
+#define mainCHECK( condition )      prvCheck( ( condition ) != 0, #condition, __LINE__ )
+
+static QueueHandle_t        xDataQueue;
+static QueueHandle_t        xRelayQueue;
+static SemaphoreHandle_t    xFlagSemaphore;
+static TaskHandle_t         xControllerHandle;
+static CoRoutineHandle_t    xCounterHandle;
+static CoRoutineHandle_t    xWaiterHandle;
+static volatile uint32_t    ulCounterTaken;
+static volatile uint32_t    ulWaiterTaken;
+static volatile uint32_t    ulWaiterTimeouts;
+static volatile TickType_t  xWaiterLastRun;
+static volatile uint32_t    ulTickerRuns;
+static int                  iChecks;
+static int                  iFailures;
+
+static void prvCheck( int passed, const char* expression, int line )
+{
+    iChecks++;
+    if( !passed )
+    {
+        printf( "FAIL line %d: %s\n", line, expression );
+        iFailures++;
+    }
+}
+
+static int prvSameStatistics( const QueueStats_t* a, const QueueStats_t* b )
+{
+    return a->uxPeakMessagesWaiting == b->uxPeakMessagesWaiting && a->ulSendFailures == b->ulSendFailures &&
+           a->ulSendBlockedTicks == b->ulSendBlockedTicks && a->ulReceiveBlockedTicks == b->ulReceiveBlockedTicks &&
+           a->ulWakeups == b->ulWakeups;
+}
+
+/**
+ * @brief Peak occupancy and failed sends from tasks and interrupts
+ */
+static void prvCheckOccupancy( void )
+{
+    BaseType_t      xHigherPriorityTaskWoken = pdFALSE;
+    QueueStats_t    stats;
+    uint32_t        i, value = 0;
+
+    /* Peak stays after the queue drains */
+    for( i = 0; i < mainDATA_QUEUE_LENGTH - 1; i++ ) ( void )xQueueSend( xDataQueue, &i, 0 );
+    for( i = 0; i < mainDATA_QUEUE_LENGTH - 1; i++ ) ( void )xQueueReceive( xDataQueue, &value, 0 );
+    vQueueGetStatistics( xDataQueue, &stats );
+    mainCHECK( stats.uxPeakMessagesWaiting == mainDATA_QUEUE_LENGTH - 1 );
+
+    /* Full queue, send fails without blocking, after blocking and from an interrupt */
+    for( i = 0; i < mainDATA_QUEUE_LENGTH; i++ ) ( void )xQueueSend( xDataQueue, &i, 0 );
+    mainCHECK( xQueueSend( xDataQueue, &value, 0 ) == errQUEUE_FULL );
+    mainCHECK( xQueueSend( xDataQueue, &value, mainSEND_TIMEOUT ) == errQUEUE_FULL );
+    mainCHECK( xQueueSendFromISR( xDataQueue, &value, &xHigherPriorityTaskWoken ) == errQUEUE_FULL );
+    vQueueGetStatistics( xDataQueue, &stats );
+    mainCHECK( stats.uxPeakMessagesWaiting == mainDATA_QUEUE_LENGTH );
+    mainCHECK( stats.ulSendFailures == 3 );
+    mainCHECK( stats.ulSendBlockedTicks == mainSEND_TIMEOUT );
+    mainCHECK( stats.ulReceiveBlockedTicks == 0 );
+    mainCHECK( stats.ulWakeups == 0 );
+
+    /* Give to a semaphore that is already given */
+    mainCHECK( xSemaphoreGiveFromISR( xFlagSemaphore, &xHigherPriorityTaskWoken ) == pdTRUE );
+    mainCHECK( xSemaphoreGiveFromISR( xFlagSemaphore, &xHigherPriorityTaskWoken ) == errQUEUE_FULL );
+    mainCHECK( xSemaphoreGive( xFlagSemaphore ) == pdFAIL );
+    vQueueGetStatistics( xFlagSemaphore, &stats );
+    mainCHECK( stats.uxPeakMessagesWaiting == 1 );
+    mainCHECK( stats.ulSendFailures == 2 );
+
+    /* Reset restarts the peak from the items still in the queue */
+    ( void )xQueueReceive( xDataQueue, &value, 0 );
+    vQueueResetStatistics( xDataQueue );
+    vQueueGetStatistics( xDataQueue, &stats );
+    mainCHECK( stats.uxPeakMessagesWaiting == mainDATA_QUEUE_LENGTH - 1 );
+    mainCHECK( stats.ulSendFailures == 0 && stats.ulSendBlockedTicks == 0 );
+    while( xQueueReceive( xDataQueue, &value, 0 ) == pdPASS );
+}
+
+/* Tells the controller every time it gets an item */
+static void prvReceiverTaskFunction( void *pvParameters )
+{
+    uint32_t value;
+
+    ( void )pvParameters;
+    for( ;; )
+    {
+        if( xQueueReceive( xRelayQueue, &value, mainRECEIVE_TIMEOUT ) == pdPASS )
+        {
+            ( void )xTaskNotifyGive( xControllerHandle );
+        }
+    }
+}
+
+/**
+ * @brief Blocked time of a receive that blocks again after losing its item
+ */
+static void prvCheckBlockedTime( void )
+{
+    QueueStats_t    stats;
+    uint32_t        value = 0;
+
+    vQueueResetStatistics( xRelayQueue );
+    /* Receiver runs and blocks as soon as the controller does */
+    xTaskCreate( prvReceiverTaskFunction, "Receiver", configMINIMAL_STACK_SIZE, NULL, mainLOW_HELPER_TASK_PRIO, NULL );
+    vTaskDelay( mainFIRST_WAIT );
+    /* Readies the receiver, the item is taken back before it runs */
+    ( void )xQueueSend( xRelayQueue, &value, 0 );
+    ( void )xQueueReceive( xRelayQueue, &value, 0 );
+    vTaskDelay( mainSECOND_WAIT );
+    ( void )xQueueSend( xRelayQueue, &value, 0 );
+    ( void )ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+    vQueueGetStatistics( xRelayQueue, &stats );
+    mainCHECK( stats.ulReceiveBlockedTicks == mainFIRST_WAIT + mainSECOND_WAIT );
+    mainCHECK( stats.ulWakeups == 2 );
+    mainCHECK( stats.uxPeakMessagesWaiting == 1 );
+    mainCHECK( stats.ulSendFailures == 0 && stats.ulSendBlockedTicks == 0 );
+}
+
+/**
+ * @brief Registry listing against the statistics of every queue
+ */
+static void prvCheckRegistry( void )
+{
+    static QueueRegistryStats_t registry[mainREGISTRY_ENTRIES];
+    QueueStats_t                stats;
+    UBaseType_t                 entries, i;
+
+    entries = uxQueueGetRegistryStatistics( registry, mainREGISTRY_ENTRIES );
+    mainCHECK( entries == 3 );
+    printf( "%-10s %6s %6s %8s %12s %12s %8s\n", "Queue", "Length", "Peak", "Failures", "Send ticks",
+            "Recv ticks", "Wakeups" );
+    for( i = 0; i < entries; i++ )
+    {
+        vQueueGetStatistics( registry[i].xHandle, &stats );
+        mainCHECK( prvSameStatistics( &registry[i].xStats, &stats ) );
+        mainCHECK( registry[i].pcQueueName == pcQueueGetName( registry[i].xHandle ) );
+        mainCHECK( registry[i].uxLength == ( registry[i].xHandle == xDataQueue ? mainDATA_QUEUE_LENGTH : 1 ) );
+        printf( "%-10s %6lu %6lu %8lu %12lu %12lu %8lu\n", registry[i].pcQueueName, ( unsigned long )registry[i].uxLength,
+                ( unsigned long )registry[i].xStats.uxPeakMessagesWaiting, ( unsigned long )registry[i].xStats.ulSendFailures,
+                ( unsigned long )registry[i].xStats.ulSendBlockedTicks, ( unsigned long )registry[i].xStats.ulReceiveBlockedTicks,
+                ( unsigned long )registry[i].xStats.ulWakeups );
+    }
+
+    /* Listing stops at the array size and follows the registry */
+    mainCHECK( uxQueueGetRegistryStatistics( registry, 2 ) == 2 );
+    vQueueUnregisterQueue( xFlagSemaphore );
+    entries = uxQueueGetRegistryStatistics( registry, mainREGISTRY_ENTRIES );
+    mainCHECK( entries == 2 );
+    for( i = 0; i < entries; i++ ) mainCHECK( registry[i].xHandle != xFlagSemaphore );
+}
+
+/* Waits without a timeout, counts notifications taken */
+static void prvCounterCoRoutine( CoRoutineHandle_t xHandle, UBaseType_t uxIndex )
+{
+    static BaseType_t xResult;
+
+    ( void )uxIndex;
+    xCounterHandle = xHandle;
+    crSTART( xHandle );
+    for( ;; )
+    {
+        crNOTIFY_TAKE( xHandle, portMAX_DELAY, &xResult );
+        if( xResult == pdPASS ) ulCounterTaken++;
+    }
+    crEND();
+}
+
+/* Waits with a timeout, counts notifications taken and timeouts */
+static void prvWaiterCoRoutine( CoRoutineHandle_t xHandle, UBaseType_t uxIndex )
+{
+    static BaseType_t xResult;
+
+    ( void )uxIndex;
+    xWaiterHandle = xHandle;
+    crSTART( xHandle );
+    for( ;; )
+    {
+        crNOTIFY_TAKE( xHandle, mainCR_TIMEOUT, &xResult );
+        if( xResult == pdPASS ) ulWaiterTaken++;
+        else ulWaiterTimeouts++;
+        xWaiterLastRun = xTaskGetTickCount();
+    }
+    crEND();
+}
+
+static void prvTickerCoRoutine( CoRoutineHandle_t xHandle, UBaseType_t uxIndex )
+{
+    ( void )uxIndex;
+    crSTART( xHandle );
+    for( ;; )
+    {
+        crDELAY( xHandle, mainCR_PERIOD );
+        ulTickerRuns++;
+    }
+    crEND();
+}
+
+/**
+ * @brief Notifications, timeouts and give races of waiting co-routines
+ *
+ * Co-routines run from the idle task, every vTaskDelay lets them run
+ */
+static void prvCheckCoRoutineNotifications( void )
+{
+    TickType_t  startTick = xTaskGetTickCount();
+    uint32_t    startTickerRuns = ulTickerRuns;
+    uint32_t    taken, timeouts, runs, elapsed, i, woken = 0;
+
+    /* Counter has been waiting since the idle task first ran */
+    taken = ulCounterTaken;
+    for( i = 0; i < mainCR_NOTIFICATIONS; i++ )
+    {
+        if( xCoRoutineNotifyGive( xCounterHandle ) == pdTRUE ) woken++;
+        vTaskDelay( 1 );
+    }
+    mainCHECK( woken == mainCR_NOTIFICATIONS );
+    mainCHECK( ulCounterTaken - taken == mainCR_NOTIFICATIONS );
+
+    /* Only the first give readies it, one take clears the count */
+    taken = ulCounterTaken;
+    mainCHECK( xCoRoutineNotifyGive( xCounterHandle ) == pdTRUE );
+    mainCHECK( xCoRoutineNotifyGive( xCounterHandle ) == pdFALSE );
+    mainCHECK( xCoRoutineNotifyGiveFromISR( xCounterHandle ) == pdFALSE );
+    vTaskDelay( 1 );
+    mainCHECK( ulCounterTaken - taken == 1 );
+
+    /* Idle task runs on every tick in between, whatever the phase of the waiter */
+    timeouts = ulWaiterTimeouts;
+    taken = ulWaiterTaken;
+    vTaskDelay( mainCR_TIMEOUT * mainCR_TIMEOUTS );
+    mainCHECK( ulWaiterTimeouts - timeouts == mainCR_TIMEOUTS );
+    mainCHECK( ulWaiterTaken == taken );
+
+    /* Interrupt wakes it before the timeout */
+    timeouts = ulWaiterTimeouts;
+    mainCHECK( xCoRoutineNotifyGiveFromISR( xWaiterHandle ) == pdTRUE );
+    vTaskDelay( 1 );
+    mainCHECK( ulWaiterTaken - taken == 1 );
+    mainCHECK( ulWaiterTimeouts == timeouts );
+
+    /* Controller runs in the tick the waiter times out, before the idle task
+    moves the waiter from its delayed list */
+    vTaskDelay( ( TickType_t )( xWaiterLastRun + mainCR_TIMEOUT - xTaskGetTickCount() ) );
+    mainCHECK( xCoRoutineNotifyGive( xWaiterHandle ) == pdTRUE );
+    vTaskDelay( 1 );
+    mainCHECK( ulWaiterTaken - taken == 2 );
+    mainCHECK( ulWaiterTimeouts == timeouts );
+
+    /* Ticker is not disturbed by the others */
+    elapsed = ( uint32_t )( TickType_t )( xTaskGetTickCount() - startTick );
+    runs = ulTickerRuns - startTickerRuns;
+    mainCHECK( runs == elapsed / mainCR_PERIOD || runs == elapsed / mainCR_PERIOD + 1 );
+}
+
+/**
+ * @brief "Controller Task" Function
+ *
+ * Runs every check and ends the scheduler
+ */
+static void prvControllerTaskFunction( void *pvParameters )
+{
+    ( void )pvParameters;
+    prvCheckOccupancy();
+    prvCheckBlockedTime();
+    prvCheckRegistry();
+    prvCheckCoRoutineNotifications();
+    vTaskEndScheduler();
+}
+
+void vApplicationIdleHook( void )
+{
+    uint8_t i;
+
+    /* On the target the idle task loops many times between ticks, here it
+    sleeps until the next tick, so every co-routine gets its chance first */
+    for( i = 0; i < mainCR_COUNT; i++ )
+    {
+        vCoRoutineSchedule();
+    }
+    vPortSimIdle();
+}
+
+/**
+ * @brief main function
+ */
+int main( void )
+{
+    xDataQueue      = xQueueCreate( mainDATA_QUEUE_LENGTH, sizeof( uint32_t ) );
+    xRelayQueue     = xQueueCreate( 1, sizeof( uint32_t ) );
+    xFlagSemaphore  = xSemaphoreCreateBinary();
+    vQueueAddToRegistry( xDataQueue, "Data" );
+    vQueueAddToRegistry( xRelayQueue, "Relay" );
+    vQueueAddToRegistry( xFlagSemaphore, "Flag" );
+    xCoRoutineCreate( prvCounterCoRoutine, 0, 0 );
+    xCoRoutineCreate( prvWaiterCoRoutine, 0, 0 );
+    xCoRoutineCreate( prvTickerCoRoutine, 1, 0 );
+    xTaskCreate( prvControllerTaskFunction, "Controller", configMINIMAL_STACK_SIZE, NULL, mainCONTROLLER_TASK_PRIO,
+                 &xControllerHandle );
+
+    vTaskStartScheduler();
+
+    printf( "%d checks, %d failures\n", iChecks, iFailures );
+    return iFailures != 0;
+}
@@ -0,0 +1,416 @@
+/**
+ * @file    main.c
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   Response time analysis
+ *
+ * Worst-case response time analysis of a fixed priority task set described
+ * in the SchedSim task set format (see ../SchedSim/taskset.h). Build and run
+ * on the host with:
+ *
+ *   gcc -O2 -I../SchedSim -o rta main.c ../SchedSim/taskset.c
+ *   ./rta ../SchedSim/tasksets/SRV_2_16.txt
+ *
+ * Every task is released by one or more streams of events, each stream
+ * described by its minimal period and release jitter:
+ *  - periodic task: its period, jitter is tick_jitter
+ *  - task released by an interrupt: interrupt period and jitter
+ *  - task released by another task: streams of the releasing task, with
+ *    jitter increased by the releasing task response time less its
+ *    execution time, as the signal comes somewhere in between
+ * Signals merged by a binary semaphore or notification are ignored, which
+ * is pessimistic. Blocking comes from priority inheritance: for every mutex
+ * whose ceiling is at least the task priority, the longest lock time of a
+ * lower priority task on that mutex. Tasks of the same priority interfere
+ * with each other because of time slicing, or with scheduler edf because
+ * of earlier deadlines. Full interference bounds both orders, so EDF task
+ * sets are analysed the same way, only more pessimistically. The tick costs
+ * tick_cost per tick period. Response times are computed with the busy period recurrence
+ *
+ *   w(q) = (q + 1)C + B + sum over hp(j) ceil((w(q) + Jj) / Tj) Cj
+ *
+ * and iterated until the jitter of all task released tasks is stable.
+ * Response time of periodic task is measured from the nominal release, so
+ * R = max w(q) - qT + J. Other tasks are measured from the signal that
+ * released the job, the earliest of which for job q is at qT - J, so
+ * R = max w(q) - max(0, qT - J). This is how deadlines are checked and how
+ * SchedSim, which runs the kernel on the host port, measures response
+ * times, so its maxima for the same task set never exceed these bounds.
+ * Exit status is 1 if a deadline can be missed and
+ * 2 if the task set could not be loaded.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+/* User's includes */
+#include "taskset.h"
+
+/* System tick period in microseconds, same as configTICK_RATE_HZ of 1000 */
+#define mainTICK_PERIOD_US          ( 1000 )
+
+#define mainMAX_STREAMS             ( 16 )
+#define mainUNBOUNDED               ( UINT64_MAX )
+/* Response times above this are treated as unbounded */
+#define mainHORIZON_US              ( 100000000ULL )
+/* Holistic iterations before jitter is considered divergent */
+#define mainMAX_ITERATIONS          ( 100 )
+
+typedef struct{
+    uint64_t            period;
+    uint64_t            jitter;
+}RtaStream_t;
+
+typedef struct{
+    RtaStream_t         streams[mainMAX_STREAMS];
+    int                 streamCount;
+    uint64_t            blocking;
+    uint64_t            response;
+    /* Released, directly or through other tasks, by its own signal */
+    uint8_t             cyclic;
+}RtaTask_t;
+
+static Taskset_t        xTaskset;
+static RtaTask_t        xTasks[TASKSET_MAX_TASKS];
+
+static uint64_t prvDivCeil( uint64_t a, uint64_t b )
+{
+    return ( a + b - 1 ) / b;
+}
+
+static int prvAddStream( RtaTask_t* task, uint64_t period, uint64_t jitter )
+{
+    if( task->streamCount == mainMAX_STREAMS ) return -1;
+    task->streams[task->streamCount].period = period;
+    task->streams[task->streamCount].jitter = jitter;
+    task->streamCount++;
+    return 0;
+}
+
+/* Does the signal release task i */
+static int prvSignalReleases( const TasksetSignal_t* signal, int i, uint32_t bit )
+{
+    const TasksetTask_t* spec = &xTaskset.tasks[i];
+
+    switch( signal->kind )
+    {
+    case TASKSET_SIGNAL_NOTIFY:
+        return spec->waitKind == TASKSET_WAIT_NOTIFY && signal->target == i;
+    case TASKSET_SIGNAL_GIVE:
+    case TASKSET_SIGNAL_SEND:
+        return spec->waitKind == TASKSET_WAIT_OBJECT && signal->target == spec->waitObject;
+    case TASKSET_SIGNAL_SET:
+        return spec->waitKind == TASKSET_WAIT_OBJECT && signal->target == spec->waitObject &&
+               ( signal->bits & bit ) != 0;
+    default:
+        return 0;
+    }
+}
+
+/* Collect release streams of task i from all signals that release it */
+static int prvCollectStreams( int i, RtaTask_t* task, uint32_t bit )
+{
+    const RtaTask_t*    source;
+    uint64_t            jitter;
+    int                 k, s;
+
+    task->streamCount = 0;
+    for( k = 0; k < xTaskset.isrCount; k++ )
+    {
+        if( !prvSignalReleases( &xTaskset.isrs[k].signal, i, bit ) ) continue;
+        if( prvAddStream( task, xTaskset.isrs[k].period, xTaskset.isrs[k].jitter ) != 0 ) return -1;
+    }
+    for( k = 0; k < xTaskset.taskCount; k++ )
+    {
+        if( !prvSignalReleases( &xTaskset.tasks[k].signal, i, bit ) ) continue;
+        source = &xTasks[k];
+        for( s = 0; s < source->streamCount; s++ )
+        {
+            if( source->response == mainUNBOUNDED || source->streams[s].jitter == mainUNBOUNDED )
+                jitter = mainUNBOUNDED;
+            else if( source->response > xTaskset.tasks[k].exec )
+                jitter = source->streams[s].jitter + source->response - xTaskset.tasks[k].exec;
+            else
+                jitter = source->streams[s].jitter;
+            if( prvAddStream( task, source->streams[s].period, jitter ) != 0 ) return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Build release streams of task i from current response times
+ *
+ * Task waiting for several event bits is released at most as often as the
+ * least frequently set of those bits, so only streams of that bit are used.
+ */
+static int prvBuildStreams( int i )
+{
+    const TasksetTask_t*    spec = &xTaskset.tasks[i];
+    RtaTask_t*              task = &xTasks[i];
+    RtaTask_t               candidate;
+    double                  rate, bestRate = -1.0;
+    uint32_t                bit;
+    int                     s;
+
+    if( spec->waitKind == TASKSET_WAIT_PERIOD )
+    {
+        task->streamCount = 0;
+        return prvAddStream( task, spec->period, xTaskset.tickJitter );
+    }
+    if( spec->waitKind == TASKSET_WAIT_NOTIFY ||
+        xTaskset.objects[spec->waitObject].kind != TASKSET_OBJECT_EVENTS )
+    {
+        return prvCollectStreams( i, task, 0 );
+    }
+    for( bit = 1; bit != 0; bit <<= 1 )
+    {
+        if( ( spec->waitBits & bit ) == 0 ) continue;
+        if( prvCollectStreams( i, &candidate, bit ) != 0 ) return -1;
+        rate = 0.0;
+        for( s = 0; s < candidate.streamCount; s++ ) rate += 1.0 / ( double )candidate.streams[s].period;
+        if( bestRate < 0.0 || rate < bestRate )
+        {
+            bestRate            = rate;
+            task->streamCount   = candidate.streamCount;
+            memcpy( task->streams, candidate.streams, sizeof( candidate.streams ) );
+        }
+    }
+    return 0;
+}
+
+/* Blocking from lower priority tasks holding a mutex with ceiling >= prio */
+static uint64_t prvBlocking( int i )
+{
+    uint32_t    priority = xTaskset.tasks[i].priority;
+    uint32_t    ceiling;
+    uint64_t    blocking = 0, longest;
+    int         m, j;
+
+    for( m = 0; m < xTaskset.objectCount; m++ )
+    {
+        if( xTaskset.objects[m].kind != TASKSET_OBJECT_MUTEX ) continue;
+        ceiling = 0;
+        longest = 0;
+        for( j = 0; j < xTaskset.taskCount; j++ )
+        {
+            if( xTaskset.tasks[j].lockObject != m ) continue;
+            if( xTaskset.tasks[j].priority > ceiling ) ceiling = xTaskset.tasks[j].priority;
+            if( xTaskset.tasks[j].priority < priority && xTaskset.tasks[j].lockTime > longest )
+                longest = xTaskset.tasks[j].lockTime;
+        }
+        if( ceiling >= priority ) blocking += longest;
+    }
+    return blocking;
+}
+
+/**
+ * @brief Demand of everything but job q of stream own of task i in window w
+ */
+static uint64_t prvInterference( int i, int own, uint64_t w )
+{
+    uint64_t    demand = 0;
+    int         j, s;
+
+    if( xTaskset.tickCost != 0 )
+        demand += prvDivCeil( w + xTaskset.tickJitter, xTaskset.tickPeriod ) * xTaskset.tickCost;
+    for( j = 0; j < xTaskset.taskCount; j++ )
+    {
+        if( xTaskset.tasks[j].priority < xTaskset.tasks[i].priority ) continue;
+        for( s = 0; s < xTasks[j].streamCount; s++ )
+        {
+            if( j == i && s == own ) continue;
+            if( xTasks[j].streams[s].jitter == mainUNBOUNDED ) return mainUNBOUNDED;
+            demand += prvDivCeil( w + xTasks[j].streams[s].jitter, xTasks[j].streams[s].period ) *
+                      xTaskset.tasks[j].exec;
+        }
+    }
+    return demand;
+}
+
+/* Worst-case response time of task i over all of its release streams */
+static uint64_t prvResponseTime( int i )
+{
+    const TasksetTask_t*    spec = &xTaskset.tasks[i];
+    const RtaTask_t*        task = &xTasks[i];
+    const RtaStream_t*      stream;
+    uint64_t                response = 0, w, next, interference, r;
+    uint64_t                q;
+    double                  utilization;
+    int                     j, s;
+
+    /* Busy period never ends if priority level is fully utilized */
+    utilization = ( double )xTaskset.tickCost / ( double )xTaskset.tickPeriod;
+    for( j = 0; j < xTaskset.taskCount; j++ )
+    {
+        if( xTaskset.tasks[j].priority < spec->priority ) continue;
+        for( s = 0; s < xTasks[j].streamCount; s++ )
+            utilization += ( double )xTaskset.tasks[j].exec / ( double )xTasks[j].streams[s].period;
+    }
+    if( utilization >= 1.0 ) return mainUNBOUNDED;
+
+    for( s = 0; s < task->streamCount; s++ )
+    {
+        stream = &task->streams[s];
+        if( stream->jitter == mainUNBOUNDED ) return mainUNBOUNDED;
+        for( q = 0; ; q++ )
+        {
+            w = ( q + 1 ) * spec->exec + task->blocking;
+            for( ;; )
+            {
+                interference = prvInterference( i, s, w );
+                if( interference == mainUNBOUNDED ) return mainUNBOUNDED;
+                next = ( q + 1 ) * spec->exec + task->blocking + interference;
+                if( next > mainHORIZON_US ) return mainUNBOUNDED;
+                if( next == w ) break;
+                w = next;
+            }
+            if( spec->waitKind == TASKSET_WAIT_PERIOD )
+                r = w + stream->jitter - q * stream->period;
+            else if( q * stream->period > stream->jitter )
+                r = w - ( q * stream->period - stream->jitter );
+            else
+                r = w;
+            if( r > response ) response = r;
+            /* Busy period ends before the next job of this stream arrives */
+            if( w + stream->jitter <= ( q + 1 ) * stream->period ) break;
+        }
+    }
+    return response;
+}
+
+/* Is there a chain of signals from task k that releases task i */
+static int prvReaches( int k, int i, uint32_t visited )
+{
+    int j;
+
+    for( j = 0; j < xTaskset.taskCount; j++ )
+    {
+        if( !prvSignalReleases( &xTaskset.tasks[k].signal, j, xTaskset.tasks[j].waitBits ) ) continue;
+        if( j == i ) return 1;
+        if( ( visited & ( 1UL << j ) ) == 0 && prvReaches( j, i, visited | ( 1UL << j ) ) ) return 1;
+    }
+    return 0;
+}
+
+/* Holistic analysis, jitter of released tasks depends on response times */
+static void prvAnalyse( void )
+{
+    uint64_t    response;
+    int         i, iteration, changed = 1;
+
+    for( i = 0; i < xTaskset.taskCount; i++ )
+    {
+        xTasks[i].blocking  = prvBlocking( i );
+        xTasks[i].response  = 0;
+        xTasks[i].cyclic    = prvReaches( i, i, 1UL << i );
+    }
+    for( iteration = 0; changed && iteration < mainMAX_ITERATIONS; iteration++ )
+    {
+        changed = 0;
+        for( i = 0; i < xTaskset.taskCount; i++ )
+        {
+            if( !xTasks[i].cyclic && prvBuildStreams( i ) != 0 )
+            {
+                fprintf( stderr, "%s: more than %d release streams\n", xTaskset.tasks[i].name, mainMAX_STREAMS );
+                xTasks[i].cyclic = 1;
+            }
+            if( xTasks[i].cyclic )
+            {
+                /* Released without bound, interferes with every lower task */
+                xTasks[i].streamCount = 0;
+                ( void )prvAddStream( &xTasks[i], xTaskset.tickPeriod, mainUNBOUNDED );
+            }
+        }
+        for( i = 0; i < xTaskset.taskCount; i++ )
+        {
+            response = prvResponseTime( i );
+            if( response != xTasks[i].response ) changed = 1;
+            xTasks[i].response = response;
+        }
+    }
+    /* Jitter keeps growing around a cycle of signals */
+    if( changed )
+    {
+        for( i = 0; i < xTaskset.taskCount; i++ ) xTasks[i].response = mainUNBOUNDED;
+    }
+}
+
+static void prvPrintTime( uint64_t us )
+{
+    if( us == mainUNBOUNDED )
+        printf( " %11s", "unbounded" );
+    else
+        printf( " %7llu.%03llu", ( unsigned long long )( us / 1000 ), ( unsigned long long )( us % 1000 ) );
+}
+
+static int prvReport( const char* fileName )
+{
+    const TasksetTask_t*    spec;
+    const RtaTask_t*        task;
+    uint64_t                period, jitter;
+    int                     i, s, misses = 0;
+
+    printf( "%s: tick %u us, tick cost %u us, tick jitter %u us\n\n", fileName,
+            ( unsigned )xTaskset.tickPeriod, ( unsigned )xTaskset.tickCost, ( unsigned )xTaskset.tickJitter );
+    printf( "%-16s Prio     Exec ms   Period ms   Jitter ms    Block ms     Resp ms  Deadline ms  Result\n", "Task" );
+    for( i = 0; i < xTaskset.taskCount; i++ )
+    {
+        spec    = &xTaskset.tasks[i];
+        task    = &xTasks[i];
+        period  = 0;
+        jitter  = 0;
+        for( s = 0; s < task->streamCount; s++ )
+        {
+            if( period == 0 || task->streams[s].period < period ) period = task->streams[s].period;
+            if( task->streams[s].jitter > jitter ) jitter = task->streams[s].jitter;
+        }
+        printf( "%-16s %4u", spec->name, ( unsigned )spec->priority );
+        prvPrintTime( spec->exec );
+        prvPrintTime( period );
+        prvPrintTime( jitter );
+        prvPrintTime( task->blocking );
+        prvPrintTime( task->response );
+        if( spec->deadline != 0 )
+            prvPrintTime( spec->deadline );
+        else
+            printf( " %11s", "-" );
+        if( task->streamCount == 0 && task->response != mainUNBOUNDED )
+        {
+            printf( "  never released\n" );
+        }
+        else if( spec->deadline == 0 )
+        {
+            printf( "  -\n" );
+        }
+        else if( task->response > spec->deadline )
+        {
+            printf( "  MISS\n" );
+            misses++;
+        }
+        else
+        {
+            printf( "  ok\n" );
+        }
+    }
+    printf( "\nTask set is %sschedulable\n", misses ? "NOT " : "" );
+    return misses != 0;
+}
+
+/**
+ * @brief main function
+ */
+int main( int argc, char** argv )
+{
+    if( argc != 2 )
+    {
+        fprintf( stderr, "usage: %s TASKSET\n", argv[0] );
+        return 2;
+    }
+    if( xTasksetLoad( argv[1], mainTICK_PERIOD_US, &xTaskset ) != 0 ) return 2;
+
+    prvAnalyse();
+    return prvReport( argv[1] );
+}
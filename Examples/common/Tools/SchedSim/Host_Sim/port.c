@@ -0,0 +1,249 @@
+/*
+ * FreeRTOS Kernel V10.2.0
+ * Copyright (C) 2019 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+#include <ucontext.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*-----------------------------------------------------------
+ * Implementation of functions defined in portable.h for the deterministic
+ * host simulation port.
+ *----------------------------------------------------------*/
+
+/* Each task runs on its own host stack, the FreeRTOS stack only holds a
+pointer to the task's SimThread_t.  Host stacks need to be much larger than
+the target stacks because of the host C library. */
+#ifndef configSIM_HOST_STACK_SIZE
+	#define configSIM_HOST_STACK_SIZE	( 64U * 1024U )
+#endif
+
+typedef struct SimThread
+{
+	ucontext_t xContext;
+	uint16_t usCriticalNesting;
+	TaskFunction_t pxCode;
+	void *pvParameters;
+} SimThread_t;
+
+/* We require the address of the pxCurrentTCB variable, but don't want to know
+any details of its type.  The first member of the TCB is the top of stack. */
+typedef void TCB_t;
+extern volatile TCB_t * volatile pxCurrentTCB;
+
+volatile uint16_t usCriticalNesting = portNO_CRITICAL_SECTION_NESTING;
+
+/* The context vTaskStartScheduler() was called from, returned to by
+vPortEndScheduler(). */
+static ucontext_t xSchedulerStartContext;
+
+/* Simulated time, all in microseconds. */
+static uint64_t ullSimTime = 0ULL;
+static uint64_t ullNextTickTime = portSIM_TICK_PERIOD_US;
+static uint64_t ullEndTime = UINT64_MAX;
+static uint64_t ullIdleTime = 0ULL;
+static uint32_t ulContextSwitches = 0UL;
+/*-----------------------------------------------------------*/
+
+/*
+ * Entry point of every task coroutine.
+ */
+static void prvTaskEntry( void );
+
+/*
+ * The simulated tick interrupt.
+ */
+static void prvSimTick( void );
+/*-----------------------------------------------------------*/
+
+static SimThread_t *prvCurrentThread( void )
+{
+StackType_t *pxTopOfStack = *( ( StackType_t ** ) pxCurrentTCB );
+
+	return ( SimThread_t * ) *pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+SimThread_t *pxThread;
+
+	pxThread = ( SimThread_t * ) malloc( sizeof( SimThread_t ) );
+	configASSERT( pxThread );
+
+	pxThread->usCriticalNesting = portNO_CRITICAL_SECTION_NESTING;
+	pxThread->pxCode = pxCode;
+	pxThread->pvParameters = pvParameters;
+
+	( void ) getcontext( &( pxThread->xContext ) );
+	pxThread->xContext.uc_stack.ss_sp = malloc( configSIM_HOST_STACK_SIZE );
+	pxThread->xContext.uc_stack.ss_size = configSIM_HOST_STACK_SIZE;
+	pxThread->xContext.uc_link = NULL;
+	configASSERT( pxThread->xContext.uc_stack.ss_sp );
+	makecontext( &( pxThread->xContext ), prvTaskEntry, 0 );
+
+	*pxTopOfStack = ( StackType_t ) pxThread;
+
+	return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTaskEntry( void )
+{
+SimThread_t *pxThread = prvCurrentThread();
+
+	usCriticalNesting = pxThread->usCriticalNesting;
+	pxThread->pxCode( pxThread->pvParameters );
+
+	/* Tasks must not return. */
+	configASSERT( pdFALSE );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+	usCriticalNesting = portNO_CRITICAL_SECTION_NESTING;
+
+	/* Run the first task.  This only returns once vPortEndScheduler() has
+	been called. */
+	( void ) swapcontext( &xSchedulerStartContext, &( prvCurrentThread()->xContext ) );
+
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+	( void ) setcontext( &xSchedulerStartContext );
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+SimThread_t *pxFrom, *pxTo;
+
+	pxFrom = prvCurrentThread();
+	pxFrom->usCriticalNesting = usCriticalNesting;
+
+	vTaskSwitchContext();
+
+	pxTo = prvCurrentThread();
+
+	if( pxTo != pxFrom )
+	{
+		ulContextSwitches++;
+		( void ) swapcontext( &( pxFrom->xContext ), &( pxTo->xContext ) );
+	}
+
+	/* Running as pxFrom again. */
+	usCriticalNesting = pxFrom->usCriticalNesting;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSimTick( void )
+{
+	ullNextTickTime += portSIM_TICK_PERIOD_US;
+
+	if( ullSimTime >= ullEndTime )
+	{
+		vTaskEndScheduler();
+	}
+
+	if( xTaskIncrementTick() != pdFALSE )
+	{
+		vPortYield();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortSimExecute( uint32_t ulMicroseconds )
+{
+uint64_t ullToNextTick;
+
+	/* Time can only pass outside of critical sections, just as the tick
+	interrupt can only be taken outside of them on the target. */
+	configASSERT( usCriticalNesting == portNO_CRITICAL_SECTION_NESTING );
+
+	while( ulMicroseconds > 0UL )
+	{
+		ullToNextTick = ullNextTickTime - ullSimTime;
+
+		/* Work that ends exactly on a tick boundary completes before the
+		tick is taken. */
+		if( ( uint64_t ) ulMicroseconds <= ullToNextTick )
+		{
+			ullSimTime += ulMicroseconds;
+			ulMicroseconds = 0UL;
+		}
+		else
+		{
+			/* The tick may switch to another task, in which case the rest of
+			the execution time is consumed once this task runs again. */
+			ullSimTime = ullNextTickTime;
+			ulMicroseconds -= ( uint32_t ) ullToNextTick;
+			prvSimTick();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortSimIdle( void )
+{
+	/* Nothing is ready to run, so the CPU sleeps until the next tick. */
+	ullIdleTime += ullNextTickTime - ullSimTime;
+	ullSimTime = ullNextTickTime;
+	prvSimTick();
+}
+/*-----------------------------------------------------------*/
+
+void vPortSimSetEndTime( uint64_t ullTime )
+{
+	ullEndTime = ullTime;
+}
+/*-----------------------------------------------------------*/
+
+uint64_t ullPortSimGetTime( void )
+{
+	return ullSimTime;
+}
+/*-----------------------------------------------------------*/
+
+uint64_t ullPortSimGetIdleTime( void )
+{
+	return ullIdleTime;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulPortSimGetContextSwitches( void )
+{
+	return ulContextSwitches;
+}
+/*-----------------------------------------------------------*/
+
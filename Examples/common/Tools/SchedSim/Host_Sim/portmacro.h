@@ -0,0 +1,123 @@
+/*
+ * FreeRTOS Kernel V10.2.0
+ * Copyright (C) 2019 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://www.FreeRTOS.org
+ * http://aws.amazon.com/freertos
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+/*-----------------------------------------------------------
+ * Port specific definitions.
+ *
+ * Deterministic host simulation port.  Tasks run as ucontext coroutines in a
+ * single host thread and time only passes when the running task calls
+ * vPortSimExecute() or the idle task calls vPortSimIdle().  The tick
+ * interrupt is generated synchronously whenever simulated time crosses a tick
+ * boundary, so a run is fully reproducible.
+ *-----------------------------------------------------------
+ */
+
+#include <stdint.h>
+
+/* Type definitions. */
+#define portCHAR		char
+#define portFLOAT		float
+#define portDOUBLE		double
+#define portLONG		long
+#define portSHORT		short
+#define portSTACK_TYPE	uintptr_t
+#define portBASE_TYPE	long
+#define portPOINTER_SIZE_TYPE uintptr_t
+
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#if( configUSE_16_BIT_TICKS == 1 )
+	typedef uint16_t TickType_t;
+	#define portMAX_DELAY ( TickType_t ) 0xffff
+#else
+	typedef uint32_t TickType_t;
+	#define portMAX_DELAY ( TickType_t ) 0xffffffffUL
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* There are no asynchronous interrupts, the simulated tick and any simulated
+interrupt sources run from within vPortSimExecute() and vPortSimIdle(), so
+masking interrupts has nothing to do. */
+#define portDISABLE_INTERRUPTS()
+#define portENABLE_INTERRUPTS()
+/*-----------------------------------------------------------*/
+
+/* Critical section control macros.  The nesting count is still kept, and
+saved per task, so kernel code that yields from within a critical section
+behaves as it does on the target. */
+#define portNO_CRITICAL_SECTION_NESTING		( ( uint16_t ) 0 )
+
+extern volatile uint16_t usCriticalNesting;
+#define portENTER_CRITICAL()	{ usCriticalNesting++; }
+#define portEXIT_CRITICAL()		{ if( usCriticalNesting > portNO_CRITICAL_SECTION_NESTING ) { usCriticalNesting--; } }
+
+/* Short updates that never yield only have to mask interrupts, which is
+nothing here as well. */
+#define portMASK_INTERRUPTS( uxSavedStatus )		( uxSavedStatus ) = 0
+#define portRESTORE_INTERRUPTS( uxSavedStatus )		( void ) ( uxSavedStatus )
+/*-----------------------------------------------------------*/
+
+/* Task utilities. */
+extern void vPortYield( void );
+#define portYIELD() vPortYield()
+
+/* Simulated interrupts run from the tick hook, inside xTaskIncrementTick().
+A context switch they request is recorded by the kernel in xYieldPending and
+performed when the tick returns, so there is nothing to do here. */
+#define portYIELD_FROM_ISR( x ) ( void ) ( x )
+/*-----------------------------------------------------------*/
+
+/* Hardware specifics. */
+#define portBYTE_ALIGNMENT			8
+#define portSTACK_GROWTH			( -1 )
+#define portTICK_PERIOD_MS			( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portNOP()
+/*-----------------------------------------------------------*/
+
+/* Task function macros as described on the FreeRTOS.org WEB site. */
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void *pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void *pvParameters )
+/*-----------------------------------------------------------*/
+
+/* Simulation control, see port.c.  Times are in microseconds. */
+#define portSIM_TICK_PERIOD_US		( 1000000ULL / ( uint64_t ) configTICK_RATE_HZ )
+
+void vPortSimExecute( uint32_t ulMicroseconds );
+void vPortSimIdle( void );
+void vPortSimSetEndTime( uint64_t ullEndTime );
+uint64_t ullPortSimGetTime( void );
+uint64_t ullPortSimGetIdleTime( void );
+uint32_t ulPortSimGetContextSwitches( void );
+
+#endif /* PORTMACRO_H */
+
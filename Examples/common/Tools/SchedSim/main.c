@@ -0,0 +1,700 @@
+/**
+ * @file    main.c
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   Scheduling simulator
+ *
+ * Runs a task set (see taskset.h) on the unmodified kernel sources using the
+ * deterministic host port in Host_Sim. Tasks consume their execution time in
+ * simulated time, interrupts are raised from the tick hook, and every job
+ * is measured from its release (period start, interrupt or signal from the
+ * releasing task) until it finishes. Build and run on the host with:
+ *
+ *   gcc -O2 -I. -IHost_Sim -I../../FreeRTOS_source/include -o schedsim
+ *       main.c taskset.c Host_Sim/port.c ../../FreeRTOS_source/tasks.c
+ *       ../../FreeRTOS_source/queue.c ../../FreeRTOS_source/list.c
+ *       ../../FreeRTOS_source/timers.c ../../FreeRTOS_source/event_groups.c
+ *       ../../FreeRTOS_source/portable/MemMang/heap_1.c
+ *   ./schedsim tasksets/SRV_2_16.txt
+ *   ./schedsim -u 50
+ *
+ * With scheduler edf in the task set, deadlines are given to the kernel
+ * with vTaskSetDeadline and periodic tasks wait with
+ * xTaskWaitForNextRelease. -u compares fixed priority with EDF scheduling
+ * over a range of utilizations instead of running a task set file: for
+ * every utilization it generates SETS (default 50) sets of periodic tasks
+ * with implicit deadlines and runs each set twice, once with rate monotonic
+ * priorities and once with all tasks at one priority and scheduler edf.
+ * Every run is a child process, as the kernel can only be started once.
+ *
+ * Exit status is 1 if any deadline was missed and 2 if the task set could
+ * not be loaded.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+#include "event_groups.h"
+
+/* User's includes */
+#include "taskset.h"
+
+/* Tick period in microseconds */
+#define mainTICK_PERIOD_US          ( ( uint32_t ) portSIM_TICK_PERIOD_US )
+
+/* Maximal number of pending releases kept per object */
+#define mainSTAMP_COUNT             ( 32 )
+
+/* Utilization sweep, tasks per set, default sets per point and run time */
+#define mainSWEEP_TASKS             ( 5 )
+#define mainSWEEP_SETS              ( 50 )
+#define mainSWEEP_DURATION          ( 2000000ULL )
+#define mainSWEEP_FIRST_PERCENT     ( 60 )
+#define mainSWEEP_STEP_PERCENT      ( 5 )
+/* Liu and Layland bound n(2^(1/n) - 1) for mainSWEEP_TASKS tasks */
+#define mainSWEEP_RM_BOUND          ( 74.3 )
+
+/* Run-time state of one kernel object. Release time of every pending
+signal is kept next to the object so a job can be measured from the time
+its release was signaled. Queues carry the release time as the item, event
+groups keep one stamp per bit and use stampCount as mask of pending bits. */
+typedef struct{
+    void*               handle;
+    uint64_t            stamps[mainSTAMP_COUNT];
+    uint32_t            stampHead;
+    uint32_t            stampCount;
+}SimObject_t;
+
+/* Run-time state and statistics of one task */
+typedef struct{
+    TaskHandle_t        handle;
+    /* Release time of the current job, valid while inJob is set */
+    uint64_t            release;
+    uint8_t             inJob;
+    /* Pending notification */
+    uint64_t            notifyStamp;
+    uint8_t             notifyPending;
+    uint32_t            jobs;
+    uint32_t            misses;
+    uint32_t            lost;
+    uint64_t            responseMax;
+    uint64_t            responseTotal;
+    uint64_t            cpuTime;
+}SimTask_t;
+
+/* Run-time state of one interrupt source */
+typedef struct{
+    uint64_t            next;
+    uint64_t            base;
+    uint32_t            raised;
+    uint32_t            lost;
+}SimIsr_t;
+
+static Taskset_t        xTaskset;
+static SimObject_t      xObjects[TASKSET_MAX_OBJECTS];
+static SimTask_t        xTasks[TASKSET_MAX_TASKS];
+static SimIsr_t         xIsrs[TASKSET_MAX_ISRS];
+
+/* Task whose CPU time is currently accumulated, -1 for kernel tasks */
+static int              xRunningTask    = -1;
+static uint64_t         ullSwitchedInTime;
+
+/* Fixed seed, interrupt jitter is pseudo random but every run is the same */
+static uint32_t         ulRandomState   = 0x12345678UL;
+
+/* Sweep periods in microseconds, hyperperiod is 200 ms */
+static const uint32_t   ulSweepPeriods[] = { 10000, 20000, 25000, 40000, 50000, 100000 };
+
+static uint32_t prvRandom( void )
+{
+    ulRandomState = ulRandomState * 1103515245UL + 12345UL;
+    return ulRandomState >> 16;
+}
+
+static void prvStampPush( SimObject_t* object, uint64_t stamp )
+{
+    if( object->stampCount < mainSTAMP_COUNT )
+    {
+        object->stamps[( object->stampHead + object->stampCount ) % mainSTAMP_COUNT] = stamp;
+        object->stampCount++;
+    }
+}
+
+static uint64_t prvStampPop( SimObject_t* object )
+{
+    uint64_t stamp = ullPortSimGetTime();
+    if( object->stampCount > 0 )
+    {
+        stamp = object->stamps[object->stampHead];
+        object->stampHead = ( object->stampHead + 1 ) % mainSTAMP_COUNT;
+        object->stampCount--;
+    }
+    return stamp;
+}
+
+/**
+ * @brief Signal the object or task described by signal
+ *
+ * Called from task context and, with fromISR set, from the simulated
+ * interrupts. Release time is recorded before the kernel call because the
+ * released task may preempt the caller from within the call. Returns
+ * pdFALSE if the signal did not release a job of its own.
+ */
+static BaseType_t prvSignal( const TasksetSignal_t* signal, BaseType_t fromISR )
+{
+    uint64_t        now     = ullPortSimGetTime();
+    SimObject_t*    object  = &xObjects[signal->target];
+    SimTask_t*      task    = &xTasks[signal->target];
+    BaseType_t      result  = pdTRUE;
+    BaseType_t      woken   = pdFALSE;
+    uint32_t        bit;
+
+    switch( signal->kind )
+    {
+    case TASKSET_SIGNAL_GIVE:
+        prvStampPush( object, now );
+        if( fromISR )
+            result = xSemaphoreGiveFromISR( ( SemaphoreHandle_t )object->handle, &woken );
+        else
+            result = xSemaphoreGive( ( SemaphoreHandle_t )object->handle );
+        if( result != pdTRUE )
+        {
+            /* Semaphore was already at its maximal count, drop the stamp */
+            object->stampCount--;
+        }
+        break;
+    case TASKSET_SIGNAL_SEND:
+        if( fromISR )
+            result = xQueueSendFromISR( ( QueueHandle_t )object->handle, &now, &woken );
+        else
+            result = xQueueSend( ( QueueHandle_t )object->handle, &now, 0 );
+        break;
+    case TASKSET_SIGNAL_NOTIFY:
+        if( task->notifyPending )
+        {
+            result = pdFALSE;
+        }
+        else
+        {
+            task->notifyStamp   = now;
+            task->notifyPending = 1;
+        }
+        if( fromISR )
+            vTaskNotifyGiveFromISR( task->handle, &woken );
+        else
+            xTaskNotifyGive( task->handle );
+        break;
+    case TASKSET_SIGNAL_SET:
+        /* One stamp per event bit, set while the bit is pending */
+        for( bit = 0; bit < 32; bit++ )
+        {
+            if( ( signal->bits & ( 1UL << bit ) ) == 0 ) continue;
+            if( object->stampCount & ( 1UL << bit ) )
+            {
+                result = pdFALSE;
+            }
+            else
+            {
+                object->stamps[bit] = now;
+                object->stampCount |= ( 1UL << bit );
+            }
+        }
+        if( fromISR )
+        {
+            if( xEventGroupSetBitsFromISR( ( EventGroupHandle_t )object->handle, signal->bits, &woken ) != pdPASS )
+                result = pdFALSE;
+        }
+        else
+        {
+            ( void )xEventGroupSetBits( ( EventGroupHandle_t )object->handle, signal->bits );
+        }
+        break;
+    default:
+        break;
+    }
+    portYIELD_FROM_ISR( woken );
+    return result;
+}
+
+/* Block until the next job of the task is released, returns release time */
+static uint64_t prvWaitForRelease( const TasksetTask_t* spec, SimTask_t* task )
+{
+    SimObject_t*    object;
+    uint64_t        release = 0;
+    uint64_t        stamp;
+    uint32_t        bit;
+
+    if( spec->waitKind == TASKSET_WAIT_NOTIFY )
+    {
+        ( void )ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+        release             = task->notifyStamp;
+        task->notifyPending = 0;
+        return release;
+    }
+    object = &xObjects[spec->waitObject];
+    switch( xTaskset.objects[spec->waitObject].kind )
+    {
+    case TASKSET_OBJECT_SEMAPHORE:
+        ( void )xSemaphoreTake( ( SemaphoreHandle_t )object->handle, portMAX_DELAY );
+        release = prvStampPop( object );
+        break;
+    case TASKSET_OBJECT_QUEUE:
+        ( void )xQueueReceive( ( QueueHandle_t )object->handle, &release, portMAX_DELAY );
+        break;
+    case TASKSET_OBJECT_EVENTS:
+        ( void )xEventGroupWaitBits( ( EventGroupHandle_t )object->handle, spec->waitBits,
+                                     pdTRUE, pdTRUE, portMAX_DELAY );
+        /* Job is released when the last of the bits was set */
+        for( bit = 0; bit < 32; bit++ )
+        {
+            if( ( spec->waitBits & ( 1UL << bit ) ) == 0 ) continue;
+            stamp = object->stamps[bit];
+            if( stamp > release ) release = stamp;
+            object->stampCount &= ~( 1UL << bit );
+        }
+        break;
+    default:
+        break;
+    }
+    return release;
+}
+
+static void prvJobDone( const TasksetTask_t* spec, SimTask_t* task, uint64_t release )
+{
+    uint64_t response = ullPortSimGetTime() - release;
+
+    task->jobs++;
+    task->responseTotal += response;
+    if( response > task->responseMax ) task->responseMax = response;
+    if( spec->deadline != 0 && response > spec->deadline ) task->misses++;
+}
+
+/**
+ * @brief Body of every simulated task
+ *
+ * Waits for release, executes for exec microseconds of which the last
+ * lockTime are spent holding the mutex, signals the next object in the
+ * chain and records the response time of the job.
+ */
+static void prvSimTaskFunction( void *pvParameters )
+{
+    int                     index   = ( int )( intptr_t )pvParameters;
+    const TasksetTask_t*    spec    = &xTaskset.tasks[index];
+    SimTask_t*              task    = &xTasks[index];
+    SemaphoreHandle_t       mutex   = NULL;
+    TickType_t              lastWake;
+
+    if( spec->lockObject >= 0 ) mutex = ( SemaphoreHandle_t )xObjects[spec->lockObject].handle;
+
+    /* First job is released at the tick the scheduler started, not when the
+    task first runs */
+    lastWake = 0;
+    if( spec->waitKind == TASKSET_WAIT_PERIOD )
+    {
+        task->release   = spec->offset;
+        task->inJob     = 1;
+        if( spec->offset != 0 ) vTaskDelayUntil( &lastWake, spec->offset / mainTICK_PERIOD_US );
+    }
+    for( ;; )
+    {
+        if( spec->waitKind != TASKSET_WAIT_PERIOD )
+        {
+            task->release   = prvWaitForRelease( spec, task );
+            task->inJob     = 1;
+        }
+        vPortSimExecute( spec->exec - spec->lockTime );
+        if( mutex != NULL )
+        {
+            ( void )xSemaphoreTake( mutex, portMAX_DELAY );
+            vPortSimExecute( spec->lockTime );
+            ( void )xSemaphoreGive( mutex );
+        }
+        if( spec->signal.kind != TASKSET_SIGNAL_NONE && prvSignal( &spec->signal, pdFALSE ) != pdTRUE )
+        {
+            task->lost++;
+        }
+        prvJobDone( spec, task, task->release );
+        if( spec->waitKind == TASKSET_WAIT_PERIOD )
+        {
+            /* Next job is already released if this one overran its period */
+            task->release += spec->period;
+            if( xTaskset.scheduler == TASKSET_SCHEDULER_EDF )
+                ( void )xTaskWaitForNextRelease( &lastWake, spec->period / mainTICK_PERIOD_US );
+            else
+                vTaskDelayUntil( &lastWake, spec->period / mainTICK_PERIOD_US );
+        }
+        else
+        {
+            task->inJob = 0;
+        }
+    }
+}
+
+/**
+ * @brief Tick hook raises simulated interrupts
+ */
+void vApplicationTickHook( void )
+{
+    uint64_t    now = ullPortSimGetTime();
+    uint32_t    jitterTicks;
+    int         i;
+
+    for( i = 0; i < xTaskset.isrCount; i++ )
+    {
+        while( now >= xIsrs[i].next )
+        {
+            xIsrs[i].raised++;
+            if( prvSignal( &xTaskset.isrs[i].signal, pdTRUE ) != pdTRUE ) xIsrs[i].lost++;
+            xIsrs[i].base  += xTaskset.isrs[i].period;
+            jitterTicks     = xTaskset.isrs[i].jitter / mainTICK_PERIOD_US;
+            xIsrs[i].next   = xIsrs[i].base;
+            if( jitterTicks != 0 ) xIsrs[i].next += ( uint64_t )( prvRandom() % ( jitterTicks + 1 ) ) * mainTICK_PERIOD_US;
+        }
+    }
+}
+
+/**
+ * @brief Idle hook, CPU sleeps until the next tick
+ */
+void vApplicationIdleHook( void )
+{
+    vPortSimIdle();
+}
+
+void vSimTaskSwitchedIn( void )
+{
+    TaskHandle_t    current = xTaskGetCurrentTaskHandle();
+    uint64_t        now     = ullPortSimGetTime();
+    int             i;
+
+    if( xRunningTask >= 0 ) xTasks[xRunningTask].cpuTime += now - ullSwitchedInTime;
+    ullSwitchedInTime   = now;
+    xRunningTask        = -1;
+    for( i = 0; i < xTaskset.taskCount; i++ )
+    {
+        if( xTasks[i].handle == current ) xRunningTask = i;
+    }
+}
+
+/* Jobs released but not finished by the end of the run */
+static void prvCountUnfinishedJobs( void )
+{
+    uint64_t                end = ullPortSimGetTime();
+    const TasksetTask_t*    spec;
+    SimTask_t*              task;
+    SimObject_t*            object;
+    uint64_t                release;
+    int                     i, pending;
+
+    for( i = 0; i < xTaskset.taskCount; i++ )
+    {
+        spec    = &xTaskset.tasks[i];
+        task    = &xTasks[i];
+        pending = task->inJob;
+        release = task->release;
+        if( !pending && spec->waitKind == TASKSET_WAIT_NOTIFY )
+        {
+            pending = task->notifyPending;
+            release = task->notifyStamp;
+        }
+        else if( !pending && spec->waitKind == TASKSET_WAIT_OBJECT )
+        {
+            object = &xObjects[spec->waitObject];
+            if( xTaskset.objects[spec->waitObject].kind == TASKSET_OBJECT_SEMAPHORE && object->stampCount > 0 )
+            {
+                pending = 1;
+                release = object->stamps[object->stampHead];
+            }
+            else if( xTaskset.objects[spec->waitObject].kind == TASKSET_OBJECT_QUEUE )
+            {
+                pending = xQueuePeek( ( QueueHandle_t )object->handle, &release, 0 ) == pdTRUE;
+            }
+        }
+        if( pending && spec->deadline != 0 && release + spec->deadline < end ) task->misses++;
+    }
+}
+
+static void prvPrintTime( uint64_t us )
+{
+    printf( " %7llu.%03llu", ( unsigned long long )( us / 1000 ), ( unsigned long long )( us % 1000 ) );
+}
+
+static int prvReport( const char* fileName )
+{
+    uint64_t    duration    = ullPortSimGetTime();
+    uint64_t    idle        = ullPortSimGetIdleTime();
+    uint32_t    misses      = 0;
+    int         i;
+
+    printf( "%s: %llu ms simulated, tick %u us, %s scheduling\n\n", fileName,
+            ( unsigned long long )( duration / 1000 ), ( unsigned )mainTICK_PERIOD_US,
+            xTaskset.scheduler == TASKSET_SCHEDULER_EDF ? "EDF" : "fixed priority" );
+    printf( "%-16s Prio   Jobs   Resp max ms  Resp avg ms  Deadline ms  Misses  Lost   CPU %%\n", "Task" );
+    for( i = 0; i < xTaskset.taskCount; i++ )
+    {
+        printf( "%-16s %4u %6u ", xTaskset.tasks[i].name, ( unsigned )xTaskset.tasks[i].priority,
+                ( unsigned )xTasks[i].jobs );
+        prvPrintTime( xTasks[i].responseMax );
+        prvPrintTime( xTasks[i].jobs ? xTasks[i].responseTotal / xTasks[i].jobs : 0 );
+        if( xTaskset.tasks[i].deadline != 0 )
+            prvPrintTime( xTaskset.tasks[i].deadline );
+        else
+            printf( " %11s", "-" );
+        printf( "  %6u %5u %7.2f\n", ( unsigned )xTasks[i].misses, ( unsigned )xTasks[i].lost,
+                100.0 * ( double )xTasks[i].cpuTime / ( double )duration );
+        misses += xTasks[i].misses;
+    }
+    if( xTaskset.isrCount > 0 )
+    {
+        printf( "\n%-16s Raised   Lost\n", "Interrupt" );
+        for( i = 0; i < xTaskset.isrCount; i++ )
+        {
+            printf( "%-16s %6u %6u\n", xTaskset.isrs[i].name, ( unsigned )xIsrs[i].raised,
+                    ( unsigned )xIsrs[i].lost );
+        }
+    }
+    printf( "\nCPU utilization %.2f %%, context switches %u, deadline misses %u\n",
+            100.0 * ( double )( duration - idle ) / ( double )duration,
+            ( unsigned )ulPortSimGetContextSwitches(), ( unsigned )misses );
+    return misses != 0;
+}
+
+static int prvCreateObjects( void )
+{
+    const TasksetObject_t*  spec;
+    int                     i;
+
+    for( i = 0; i < xTaskset.objectCount; i++ )
+    {
+        spec = &xTaskset.objects[i];
+        switch( spec->kind )
+        {
+        case TASKSET_OBJECT_SEMAPHORE:
+            if( spec->length >= mainSTAMP_COUNT )
+            {
+                fprintf( stderr, "%s: maximal count is %d\n", spec->name, mainSTAMP_COUNT - 1 );
+                return -1;
+            }
+            if( spec->length == 1 )
+                xObjects[i].handle = xSemaphoreCreateBinary();
+            else
+                xObjects[i].handle = xSemaphoreCreateCounting( spec->length, 0 );
+            break;
+        case TASKSET_OBJECT_MUTEX:
+            xObjects[i].handle = xSemaphoreCreateMutex();
+            break;
+        case TASKSET_OBJECT_QUEUE:
+            xObjects[i].handle = xQueueCreate( spec->length, sizeof( uint64_t ) );
+            break;
+        case TASKSET_OBJECT_EVENTS:
+            xObjects[i].handle = xEventGroupCreate();
+            break;
+        }
+        configASSERT( xObjects[i].handle != NULL );
+    }
+    return 0;
+}
+
+static int prvCreateTasks( void )
+{
+    const TasksetTask_t*    spec;
+    int                     i;
+
+    for( i = 0; i < xTaskset.taskCount; i++ )
+    {
+        spec = &xTaskset.tasks[i];
+        /* Idle priority is not supported, idle task sleeps whenever it runs */
+        if( spec->priority == tskIDLE_PRIORITY || spec->priority >= configMAX_PRIORITIES )
+        {
+            fprintf( stderr, "%s: priority must be in range 1..%d\n", spec->name, configMAX_PRIORITIES - 1 );
+            return -1;
+        }
+        xTaskCreate( prvSimTaskFunction, spec->name, configMINIMAL_STACK_SIZE,
+                     ( void* )( intptr_t )i, spec->priority, &xTasks[i].handle );
+        configASSERT( xTasks[i].handle != NULL );
+        if( xTaskset.scheduler == TASKSET_SCHEDULER_EDF && spec->deadline != 0 )
+        {
+            /* Kernel deadline is whole ticks, never later than the measured one */
+            vTaskSetDeadline( xTasks[i].handle, spec->deadline >= mainTICK_PERIOD_US ?
+                              spec->deadline / mainTICK_PERIOD_US : 1 );
+        }
+    }
+    for( i = 0; i < xTaskset.isrCount; i++ )
+    {
+        xIsrs[i].base = xTaskset.isrs[i].offset;
+        xIsrs[i].next = xIsrs[i].base;
+    }
+    return 0;
+}
+
+/* Run xTaskset in a child process, returns total jobs and missed jobs */
+static int prvSweepRun( uint32_t* jobs, uint32_t* misses )
+{
+    uint32_t    result[2] = { 0, 0 };
+    int         fds[2];
+    int         i, status;
+    pid_t       pid;
+
+    if( pipe( fds ) != 0 ) return -1;
+    pid = fork();
+    if( pid < 0 ) return -1;
+    if( pid == 0 )
+    {
+        close( fds[0] );
+        if( prvCreateObjects() != 0 || prvCreateTasks() != 0 ) _exit( 2 );
+        vPortSimSetEndTime( xTaskset.duration );
+        vTaskStartScheduler();
+        vSimTaskSwitchedIn();
+        prvCountUnfinishedJobs();
+        for( i = 0; i < xTaskset.taskCount; i++ )
+        {
+            result[0] += xTasks[i].jobs;
+            result[1] += xTasks[i].misses;
+        }
+        if( write( fds[1], result, sizeof( result ) ) != sizeof( result ) ) _exit( 2 );
+        _exit( 0 );
+    }
+    close( fds[1] );
+    if( read( fds[0], result, sizeof( result ) ) != sizeof( result ) ) result[0] = 0;
+    close( fds[0] );
+    if( waitpid( pid, &status, 0 ) != pid || !WIFEXITED( status ) || WEXITSTATUS( status ) != 0 ) return -1;
+    *jobs   = result[0];
+    *misses = result[1];
+    return 0;
+}
+
+/**
+ * @brief Generate a periodic task set with total utilization percent
+ *
+ * Utilization is split among the tasks in random proportions, periods are
+ * picked from ulSweepPeriods. Priorities are rate monotonic, ties broken by
+ * task order.
+ */
+static void prvSweepGenerate( uint32_t percent )
+{
+    uint32_t    weights[mainSWEEP_TASKS];
+    uint32_t    total = 0;
+    uint32_t    priority;
+    int         i, j;
+
+    memset( &xTaskset, 0, sizeof( xTaskset ) );
+    xTaskset.tickPeriod = mainTICK_PERIOD_US;
+    xTaskset.duration   = mainSWEEP_DURATION;
+    xTaskset.taskCount  = mainSWEEP_TASKS;
+    for( i = 0; i < mainSWEEP_TASKS; i++ )
+    {
+        weights[i]  = 1 + prvRandom() % 100;
+        total      += weights[i];
+    }
+    for( i = 0; i < mainSWEEP_TASKS; i++ )
+    {
+        TasksetTask_t* task = &xTaskset.tasks[i];
+
+        snprintf( task->name, sizeof( task->name ), "T%d", i );
+        task->waitKind      = TASKSET_WAIT_PERIOD;
+        task->waitObject    = -1;
+        task->lockObject    = -1;
+        task->period        = ulSweepPeriods[prvRandom() % ( sizeof( ulSweepPeriods ) / sizeof( ulSweepPeriods[0] ) )];
+        task->deadline      = task->period;
+        task->exec          = ( uint32_t )( ( uint64_t )task->period * percent * weights[i] / ( 100ULL * total ) );
+        if( task->exec == 0 ) task->exec = 1;
+    }
+    for( i = 0; i < mainSWEEP_TASKS; i++ )
+    {
+        priority = mainSWEEP_TASKS;
+        for( j = 0; j < mainSWEEP_TASKS; j++ )
+        {
+            if( xTaskset.tasks[j].period < xTaskset.tasks[i].period ||
+                ( xTaskset.tasks[j].period == xTaskset.tasks[i].period && j < i ) ) priority--;
+        }
+        xTaskset.tasks[i].priority = priority;
+    }
+}
+
+/* Make every task of xTaskset an EDF task of the same priority */
+static void prvSweepToEDF( void )
+{
+    int i;
+
+    xTaskset.scheduler = TASKSET_SCHEDULER_EDF;
+    for( i = 0; i < xTaskset.taskCount; i++ ) xTaskset.tasks[i].priority = 1;
+}
+
+static int prvSweep( uint32_t sets )
+{
+    uint32_t    jobs[2], misses[2], feasible[2];
+    uint32_t    runJobs, runMisses;
+    uint32_t    percent, set;
+    int         mode;
+    Taskset_t   generated;
+
+    printf( "Utilization sweep: %u sets of %d periodic tasks per point, deadline equal to\n"
+            "period, %llu ms simulated per run. Liu and Layland bound is %.1f %%.\n\n",
+            ( unsigned )sets, mainSWEEP_TASKS, ( unsigned long long )( mainSWEEP_DURATION / 1000 ),
+            mainSWEEP_RM_BOUND );
+    printf( "Util %%   FP feasible %%  EDF feasible %%   FP missed %%  EDF missed %%\n" );
+    for( percent = mainSWEEP_FIRST_PERCENT; percent <= 100; percent += mainSWEEP_STEP_PERCENT )
+    {
+        memset( jobs, 0, sizeof( jobs ) );
+        memset( misses, 0, sizeof( misses ) );
+        memset( feasible, 0, sizeof( feasible ) );
+        for( set = 0; set < sets; set++ )
+        {
+            prvSweepGenerate( percent );
+            generated = xTaskset;
+            for( mode = 0; mode < 2; mode++ )
+            {
+                xTaskset = generated;
+                if( mode == 1 ) prvSweepToEDF();
+                if( prvSweepRun( &runJobs, &runMisses ) != 0 )
+                {
+                    fprintf( stderr, "simulation of generated task set failed\n" );
+                    return 2;
+                }
+                jobs[mode]     += runJobs;
+                misses[mode]   += runMisses;
+                if( runMisses == 0 ) feasible[mode]++;
+            }
+        }
+        printf( "%6u %14.1f %14.1f %13.2f %13.2f\n", ( unsigned )percent,
+                100.0 * feasible[0] / sets, 100.0 * feasible[1] / sets,
+                100.0 * misses[0] / jobs[0], 100.0 * misses[1] / jobs[1] );
+    }
+    return 0;
+}
+
+/**
+ * @brief main function
+ */
+int main( int argc, char** argv )
+{
+    if( argc >= 2 && strcmp( argv[1], "-u" ) == 0 && argc <= 3 )
+    {
+        return prvSweep( argc == 3 && atoi( argv[2] ) > 0 ? ( uint32_t )atoi( argv[2] ) : mainSWEEP_SETS );
+    }
+    if( argc != 2 )
+    {
+        fprintf( stderr, "usage: %s TASKSET | -u [SETS]\n", argv[0] );
+        return 2;
+    }
+    if( xTasksetLoad( argv[1], mainTICK_PERIOD_US, &xTaskset ) != 0 ) return 2;
+    if( prvCreateObjects() != 0 || prvCreateTasks() != 0 ) return 2;
+
+    /* Runs until the end time is reached */
+    vPortSimSetEndTime( xTaskset.duration );
+    vTaskStartScheduler();
+
+    vSimTaskSwitchedIn();
+    prvCountUnfinishedJobs();
+    return prvReport( argv[1] );
+}
@@ -0,0 +1,362 @@
+/**
+ * @file    taskset.c
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   Task set description
+ *
+ * Parser for the task set files, see taskset.h for the file format
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "taskset.h"
+
+#define TASKSET_MAX_LINE            256
+#define TASKSET_MAX_TOKENS          12
+
+/*Task names referenced by notify= before the task is declared*/
+typedef struct{
+    char                name[TASKSET_MAX_NAME];
+    TasksetSignal_t*    signal;
+    int                 line;
+}TasksetForwardRef_t;
+
+static const char*          pcFileName;
+static int                  xLine;
+static uint32_t             ulTickPeriod;
+static TasksetForwardRef_t  xForwardRefs[TASKSET_MAX_TASKS + TASKSET_MAX_ISRS];
+static int                  xForwardRefCount;
+
+static int prvError(const char* message, const char* token){
+    fprintf(stderr, "%s:%d: %s '%s'\n", pcFileName, xLine, message, token);
+    return -1;
+}
+
+static int prvParseNumber(const char* text, uint32_t* value){
+    char*           end;
+    unsigned long   number = strtoul(text, &end, 0);
+    if(end == text || *end != 0) return -1;
+    *value = (uint32_t)number;
+    return 0;
+}
+
+static int prvParseTime(const char* text, uint32_t* value){
+    char*           end;
+    unsigned long   number = strtoul(text, &end, 10);
+    if(end == text) return -1;
+    if(strcmp(end, "us") == 0){
+        *value = (uint32_t)number;
+    }else if(strcmp(end, "ms") == 0){
+        *value = (uint32_t)(number * 1000);
+    }else if(strcmp(end, "t") == 0){
+        *value = (uint32_t)(number * ulTickPeriod);
+    }else{
+        return -1;
+    }
+    return 0;
+}
+
+static int prvFindObject(const Taskset_t* taskset, const char* name){
+    int i;
+    for(i = 0; i < taskset->objectCount; i++){
+        if(strcmp(taskset->objects[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+static int prvFindTask(const Taskset_t* taskset, const char* name){
+    int i;
+    for(i = 0; i < taskset->taskCount; i++){
+        if(strcmp(taskset->tasks[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+/*Split "NAME:VALUE", returns pointer to VALUE or NULL*/
+static char* prvSplit(char* text){
+    char* colon = strchr(text, ':');
+    if(colon == NULL) return NULL;
+    *colon = 0;
+    return colon + 1;
+}
+
+static int prvParseSignal(Taskset_t* taskset, const char* key, char* value, TasksetSignal_t* signal){
+    char*   bits;
+    if(strcmp(key, "give") != 0 && strcmp(key, "send") != 0 &&
+       strcmp(key, "set") != 0 && strcmp(key, "notify") != 0){
+        return 1;
+    }
+    if(signal->kind != TASKSET_SIGNAL_NONE) return prvError("only one signal allowed, got", key);
+    if(strcmp(key, "give") == 0){
+        signal->kind    = TASKSET_SIGNAL_GIVE;
+        signal->target  = prvFindObject(taskset, value);
+        if(signal->target < 0 || taskset->objects[signal->target].kind != TASKSET_OBJECT_SEMAPHORE){
+            return prvError("unknown semaphore", value);
+        }
+    }else if(strcmp(key, "send") == 0){
+        signal->kind    = TASKSET_SIGNAL_SEND;
+        signal->target  = prvFindObject(taskset, value);
+        if(signal->target < 0 || taskset->objects[signal->target].kind != TASKSET_OBJECT_QUEUE){
+            return prvError("unknown queue", value);
+        }
+    }else if(strcmp(key, "set") == 0){
+        bits            = prvSplit(value);
+        signal->kind    = TASKSET_SIGNAL_SET;
+        signal->target  = prvFindObject(taskset, value);
+        if(signal->target < 0 || taskset->objects[signal->target].kind != TASKSET_OBJECT_EVENTS){
+            return prvError("unknown event group", value);
+        }
+        if(bits == NULL || prvParseNumber(bits, &signal->bits) != 0 || signal->bits == 0){
+            return prvError("expected event bits in", key);
+        }
+    }else if(strcmp(key, "notify") == 0){
+        signal->kind    = TASKSET_SIGNAL_NOTIFY;
+        signal->target  = -1;
+        if(xForwardRefCount == TASKSET_MAX_TASKS + TASKSET_MAX_ISRS){
+            return prvError("too many notifications", value);
+        }
+        strncpy(xForwardRefs[xForwardRefCount].name, value, TASKSET_MAX_NAME - 1);
+        xForwardRefs[xForwardRefCount].signal   = signal;
+        xForwardRefs[xForwardRefCount].line     = xLine;
+        xForwardRefCount++;
+    }
+    return 0;
+}
+
+static int prvParseObject(Taskset_t* taskset, TasksetObjectKind_t kind, char** tokens, int count){
+    TasksetObject_t*    object;
+    char*               value;
+    int                 i;
+
+    if(count < 2) return prvError("missing name for", tokens[0]);
+    if(prvFindObject(taskset, tokens[1]) >= 0) return prvError("duplicate object", tokens[1]);
+    if(taskset->objectCount == TASKSET_MAX_OBJECTS) return prvError("too many objects", tokens[1]);
+
+    object          = &taskset->objects[taskset->objectCount];
+    object->kind    = kind;
+    object->length  = 1;
+    strncpy(object->name, tokens[1], TASKSET_MAX_NAME - 1);
+    for(i = 2; i < count; i++){
+        value = strchr(tokens[i], '=');
+        if(value == NULL) return prvError("expected key=value", tokens[i]);
+        *value++ = 0;
+        if((strcmp(tokens[i], "length") == 0 && kind == TASKSET_OBJECT_QUEUE) ||
+           (strcmp(tokens[i], "max") == 0 && kind == TASKSET_OBJECT_SEMAPHORE)){
+            if(prvParseNumber(value, &object->length) != 0 || object->length == 0){
+                return prvError("invalid number", value);
+            }
+        }else{
+            return prvError("unknown parameter", tokens[i]);
+        }
+    }
+    taskset->objectCount++;
+    return 0;
+}
+
+static int prvParseIsr(Taskset_t* taskset, char** tokens, int count){
+    TasksetIsr_t*   isr;
+    char*           value;
+    int             i, result;
+
+    if(count < 2) return prvError("missing name for", tokens[0]);
+    if(taskset->isrCount == TASKSET_MAX_ISRS) return prvError("too many interrupts", tokens[1]);
+
+    isr = &taskset->isrs[taskset->isrCount];
+    memset(isr, 0, sizeof(TasksetIsr_t));
+    strncpy(isr->name, tokens[1], TASKSET_MAX_NAME - 1);
+    for(i = 2; i < count; i++){
+        value = strchr(tokens[i], '=');
+        if(value == NULL) return prvError("expected key=value", tokens[i]);
+        *value++ = 0;
+        if(strcmp(tokens[i], "period") == 0){
+            if(prvParseTime(value, &isr->period) != 0) return prvError("invalid time", value);
+        }else if(strcmp(tokens[i], "offset") == 0){
+            if(prvParseTime(value, &isr->offset) != 0) return prvError("invalid time", value);
+        }else if(strcmp(tokens[i], "jitter") == 0){
+            if(prvParseTime(value, &isr->jitter) != 0) return prvError("invalid time", value);
+        }else{
+            result = prvParseSignal(taskset, tokens[i], value, &isr->signal);
+            if(result < 0) return result;
+            if(result > 0) return prvError("unknown parameter", tokens[i]);
+        }
+    }
+    /*Simulated interrupts are raised from the tick*/
+    if(isr->period == 0 || isr->period % ulTickPeriod != 0 ||
+       isr->offset % ulTickPeriod != 0 || isr->jitter % ulTickPeriod != 0){
+        return prvError("period, offset and jitter must be whole ticks for", isr->name);
+    }
+    if(isr->signal.kind == TASKSET_SIGNAL_NONE) return prvError("missing signal for", isr->name);
+    taskset->isrCount++;
+    return 0;
+}
+
+static int prvParseTask(Taskset_t* taskset, char** tokens, int count){
+    TasksetTask_t*  task;
+    char*           value;
+    char*           detail;
+    int             i, result, hasWait = 0;
+
+    if(count < 2) return prvError("missing name for", tokens[0]);
+    if(prvFindTask(taskset, tokens[1]) >= 0) return prvError("duplicate task", tokens[1]);
+    if(taskset->taskCount == TASKSET_MAX_TASKS) return prvError("too many tasks", tokens[1]);
+
+    task = &taskset->tasks[taskset->taskCount];
+    memset(task, 0, sizeof(TasksetTask_t));
+    strncpy(task->name, tokens[1], TASKSET_MAX_NAME - 1);
+    task->waitObject    = -1;
+    task->lockObject    = -1;
+    task->priority      = 0xFFFFFFFF;
+    for(i = 2; i < count; i++){
+        value = strchr(tokens[i], '=');
+        if(value == NULL) return prvError("expected key=value", tokens[i]);
+        *value++ = 0;
+        if(strcmp(tokens[i], "prio") == 0){
+            if(prvParseNumber(value, &task->priority) != 0) return prvError("invalid number", value);
+        }else if(strcmp(tokens[i], "period") == 0){
+            if(prvParseTime(value, &task->period) != 0) return prvError("invalid time", value);
+        }else if(strcmp(tokens[i], "offset") == 0){
+            if(prvParseTime(value, &task->offset) != 0) return prvError("invalid time", value);
+        }else if(strcmp(tokens[i], "exec") == 0){
+            if(prvParseTime(value, &task->exec) != 0) return prvError("invalid time", value);
+        }else if(strcmp(tokens[i], "deadline") == 0){
+            if(prvParseTime(value, &task->deadline) != 0) return prvError("invalid time", value);
+        }else if(strcmp(tokens[i], "lock") == 0){
+            detail              = prvSplit(value);
+            task->lockObject    = prvFindObject(taskset, value);
+            if(task->lockObject < 0 || taskset->objects[task->lockObject].kind != TASKSET_OBJECT_MUTEX){
+                return prvError("unknown mutex", value);
+            }
+            if(detail == NULL || prvParseTime(detail, &task->lockTime) != 0){
+                return prvError("expected lock time in", tokens[i]);
+            }
+        }else if(strcmp(tokens[i], "wait") == 0){
+            hasWait = 1;
+            if(strcmp(value, "notify") == 0){
+                task->waitKind      = TASKSET_WAIT_NOTIFY;
+            }else{
+                detail              = prvSplit(value);
+                task->waitKind      = TASKSET_WAIT_OBJECT;
+                task->waitObject    = prvFindObject(taskset, value);
+                if(task->waitObject < 0 || taskset->objects[task->waitObject].kind == TASKSET_OBJECT_MUTEX){
+                    return prvError("cannot wait on", value);
+                }
+                if(taskset->objects[task->waitObject].kind == TASKSET_OBJECT_EVENTS){
+                    if(detail == NULL || prvParseNumber(detail, &task->waitBits) != 0 || task->waitBits == 0){
+                        return prvError("expected event bits in", tokens[i]);
+                    }
+                }
+            }
+        }else{
+            result = prvParseSignal(taskset, tokens[i], value, &task->signal);
+            if(result < 0) return result;
+            if(result > 0) return prvError("unknown parameter", tokens[i]);
+        }
+    }
+    if(task->priority == 0xFFFFFFFF) return prvError("missing prio for", task->name);
+    if(task->exec == 0) return prvError("missing exec for", task->name);
+    if(task->lockTime > task->exec) return prvError("lock time longer than exec for", task->name);
+    if(hasWait == (task->period != 0)) return prvError("expected either period or wait for", task->name);
+    if(!hasWait){
+        /*Periodic tasks are released with vTaskDelayUntil*/
+        task->waitKind = TASKSET_WAIT_PERIOD;
+        if(task->period % ulTickPeriod != 0 || task->offset % ulTickPeriod != 0){
+            return prvError("period and offset must be whole ticks for", task->name);
+        }
+        if(task->deadline == 0) task->deadline = task->period;
+    }else if(task->offset != 0){
+        return prvError("offset is only valid for periodic task", task->name);
+    }
+    taskset->taskCount++;
+    return 0;
+}
+
+int xTasksetLoad(const char* fileName, uint32_t tickPeriod, Taskset_t* taskset){
+    FILE*   file;
+    char    line[TASKSET_MAX_LINE];
+    char*   tokens[TASKSET_MAX_TOKENS];
+    char*   comment;
+    int     count, i, result = 0;
+
+    file = fopen(fileName, "r");
+    if(file == NULL){
+        perror(fileName);
+        return -1;
+    }
+    memset(taskset, 0, sizeof(Taskset_t));
+    taskset->tickPeriod = tickPeriod;
+    pcFileName          = fileName;
+    ulTickPeriod        = tickPeriod;
+    xForwardRefCount    = 0;
+    xLine               = 0;
+
+    while(result == 0 && fgets(line, sizeof(line), file) != NULL){
+        xLine++;
+        comment = strchr(line, '#');
+        if(comment != NULL) *comment = 0;
+        count = 0;
+        tokens[count] = strtok(line, " \t\r\n");
+        while(tokens[count] != NULL && count < TASKSET_MAX_TOKENS - 1){
+            tokens[++count] = strtok(NULL, " \t\r\n");
+        }
+        if(count == 0) continue;
+        if(tokens[count] != NULL){
+            result = prvError("too many parameters for", tokens[0]);
+        }else if(strcmp(tokens[0], "duration") == 0){
+            uint32_t duration = 0;
+            if(count != 2 || prvParseTime(tokens[1], &duration) != 0){
+                result = prvError("expected time after", tokens[0]);
+            }
+            taskset->duration = duration;
+        }else if(strcmp(tokens[0], "scheduler") == 0){
+            if(count == 2 && strcmp(tokens[1], "fp") == 0){
+                taskset->scheduler = TASKSET_SCHEDULER_FP;
+            }else if(count == 2 && strcmp(tokens[1], "edf") == 0){
+                taskset->scheduler = TASKSET_SCHEDULER_EDF;
+            }else{
+                result = prvError("expected fp or edf after", tokens[0]);
+            }
+        }else if(strcmp(tokens[0], "tick_cost") == 0){
+            if(count != 2 || prvParseTime(tokens[1], &taskset->tickCost) != 0){
+                result = prvError("expected time after", tokens[0]);
+            }
+        }else if(strcmp(tokens[0], "tick_jitter") == 0){
+            if(count != 2 || prvParseTime(tokens[1], &taskset->tickJitter) != 0){
+                result = prvError("expected time after", tokens[0]);
+            }
+        }else if(strcmp(tokens[0], "semaphore") == 0){
+            result = prvParseObject(taskset, TASKSET_OBJECT_SEMAPHORE, tokens, count);
+        }else if(strcmp(tokens[0], "mutex") == 0){
+            result = prvParseObject(taskset, TASKSET_OBJECT_MUTEX, tokens, count);
+        }else if(strcmp(tokens[0], "queue") == 0){
+            result = prvParseObject(taskset, TASKSET_OBJECT_QUEUE, tokens, count);
+        }else if(strcmp(tokens[0], "events") == 0){
+            result = prvParseObject(taskset, TASKSET_OBJECT_EVENTS, tokens, count);
+        }else if(strcmp(tokens[0], "isr") == 0){
+            result = prvParseIsr(taskset, tokens, count);
+        }else if(strcmp(tokens[0], "task") == 0){
+            result = prvParseTask(taskset, tokens, count);
+        }else{
+            result = prvError("unknown keyword", tokens[0]);
+        }
+    }
+    fclose(file);
+
+    /*Resolve notification targets now that all tasks are known*/
+    for(i = 0; result == 0 && i < xForwardRefCount; i++){
+        xForwardRefs[i].signal->target = prvFindTask(taskset, xForwardRefs[i].name);
+        if(xForwardRefs[i].signal->target < 0){
+            xLine   = xForwardRefs[i].line;
+            result  = prvError("unknown task", xForwardRefs[i].name);
+        }else if(taskset->tasks[xForwardRefs[i].signal->target].waitKind != TASKSET_WAIT_NOTIFY){
+            xLine   = xForwardRefs[i].line;
+            result  = prvError("task does not wait for notification", xForwardRefs[i].name);
+        }
+    }
+    if(result == 0 && taskset->duration == 0){
+        xLine   = 0;
+        result  = prvError("missing", "duration");
+    }
+    return result;
+}
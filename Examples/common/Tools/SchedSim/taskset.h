@@ -0,0 +1,139 @@
+/**
+ * @file    taskset.h
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   Task set description
+ *
+ * Parser for the task set files used by the host scheduling tools. One
+ * line describes one kernel object, interrupt source or task:
+ *
+ *   duration    TIME
+ *   scheduler   fp | edf
+ *   tick_cost   TIME
+ *   tick_jitter TIME
+ *   semaphore   NAME [max=N]
+ *   mutex       NAME
+ *   queue       NAME length=N
+ *   events      NAME
+ *   isr         NAME period=TIME [offset=TIME] [jitter=TIME] SIGNAL
+ *   task        NAME prio=N (period=TIME [offset=TIME] | wait=WAIT)
+ *                    exec=TIME [lock=MUTEX:TIME] [deadline=TIME] [SIGNAL]
+ *
+ *   WAIT   := SEMAPHORE | QUEUE | EVENTS:BITS | notify
+ *   SIGNAL := give=SEMAPHORE | send=QUEUE | notify=TASK | set=EVENTS:BITS
+ *   TIME   := number followed by us, ms or t (system ticks)
+ *
+ * tick_cost is the execution time of the tick interrupt and tick_jitter the
+ * longest time the tick can be held off, e.g. by a critical section. Both
+ * default to 0 and are only used by the response time analysis.
+ *
+ * scheduler edf gives every task that has a deadline the same deadline in the
+ * kernel (configUSE_EDF_SCHEDULING), so ready tasks of equal priority run in
+ * order of their absolute deadlines. With the default fp they share the
+ * processor round robin, as in the examples.
+ *
+ * Periodic tasks have an implicit deadline equal to the period, event
+ * driven tasks have no deadline unless one is given. Everything after '#'
+ * is a comment. Objects must be declared before they are used, tasks can
+ * be referenced before they are declared.
+ */
+
+#ifndef TASKSET_H_
+#define TASKSET_H_
+
+#include <stdint.h>
+
+#define TASKSET_MAX_NAME            16
+#define TASKSET_MAX_OBJECTS         16
+#define TASKSET_MAX_TASKS           16
+#define TASKSET_MAX_ISRS            8
+
+typedef enum{
+    TASKSET_SCHEDULER_FP,
+    TASKSET_SCHEDULER_EDF
+}TasksetScheduler_t;
+
+typedef enum{
+    TASKSET_OBJECT_SEMAPHORE,
+    TASKSET_OBJECT_MUTEX,
+    TASKSET_OBJECT_QUEUE,
+    TASKSET_OBJECT_EVENTS
+}TasksetObjectKind_t;
+
+typedef enum{
+    TASKSET_WAIT_PERIOD,
+    TASKSET_WAIT_OBJECT,
+    TASKSET_WAIT_NOTIFY
+}TasksetWaitKind_t;
+
+typedef enum{
+    TASKSET_SIGNAL_NONE,
+    TASKSET_SIGNAL_GIVE,
+    TASKSET_SIGNAL_SEND,
+    TASKSET_SIGNAL_NOTIFY,
+    TASKSET_SIGNAL_SET
+}TasksetSignalKind_t;
+
+typedef struct{
+    char                    name[TASKSET_MAX_NAME];
+    TasksetObjectKind_t     kind;
+    /*Queue length or semaphore maximal count*/
+    uint32_t                length;
+}TasksetObject_t;
+
+typedef struct{
+    TasksetSignalKind_t     kind;
+    /*Object index, or task index for TASKSET_SIGNAL_NOTIFY*/
+    int                     target;
+    /*Event bits for TASKSET_SIGNAL_SET*/
+    uint32_t                bits;
+}TasksetSignal_t;
+
+typedef struct{
+    char                    name[TASKSET_MAX_NAME];
+    uint32_t                period;
+    uint32_t                offset;
+    /*Release is delayed by up to jitter after each period*/
+    uint32_t                jitter;
+    TasksetSignal_t         signal;
+}TasksetIsr_t;
+
+typedef struct{
+    char                    name[TASKSET_MAX_NAME];
+    uint32_t                priority;
+    TasksetWaitKind_t       waitKind;
+    /*Object index for TASKSET_WAIT_OBJECT*/
+    int                     waitObject;
+    /*Event bits for TASKSET_WAIT_OBJECT on event group*/
+    uint32_t                waitBits;
+    uint32_t                period;
+    uint32_t                offset;
+    /*Execution time, includes lockTime*/
+    uint32_t                exec;
+    /*Mutex index or -1, mutex is held for the last lockTime of the job*/
+    int                     lockObject;
+    uint32_t                lockTime;
+    /*Relative to release, 0 if the job has no deadline*/
+    uint32_t                deadline;
+    TasksetSignal_t         signal;
+}TasksetTask_t;
+
+/*All times are in microseconds*/
+typedef struct{
+    uint32_t                tickPeriod;
+    uint64_t                duration;
+    TasksetScheduler_t      scheduler;
+    uint32_t                tickCost;
+    uint32_t                tickJitter;
+    int                     objectCount;
+    TasksetObject_t         objects[TASKSET_MAX_OBJECTS];
+    int                     isrCount;
+    TasksetIsr_t            isrs[TASKSET_MAX_ISRS];
+    int                     taskCount;
+    TasksetTask_t           tasks[TASKSET_MAX_TASKS];
+}Taskset_t;
+
+/*Parse task set file, returns 0 on success or prints error and returns -1*/
+int         xTasksetLoad(const char* fileName, uint32_t tickPeriod, Taskset_t* taskset);
+
+#endif /* TASKSET_H_ */
@@ -0,0 +1,344 @@
+/**
+ * @file    main.c
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   hal_7seg glyph table check and benchmark
+ *
+ * Builds ../../ETF5529_HAL/hal_7seg.c on the host with emulated ports
+ * (msp430.h in this directory) and checks vHAL7SEGWriteDigit:
+ *  - digits 0-9 leave every port exactly as the switch that wrote one
+ *    segment at a time did before the glyph table, for random port states
+ *  - every other glyph lights the segments listed in xLetters, decoded back
+ *    from the active low port bits
+ *  - bits that are not segments are never changed, and a glyph that does
+ *    not exist returns 1 without touching a port
+ * Build and run on the host with:
+ *
+ *   gcc -O2 -I. -I../../ETF5529_HAL -o sevensegcheck main.c
+ *       ../../ETF5529_HAL/hal_7seg.c
+ *   ./sevensegcheck
+ *
+ * Both versions are then measured the same way as in KernelBench: they run
+ * in a child process which the parent single-steps with ptrace, and the
+ * instructions between markers are counted, averaged over digits 0-9. The
+ * counts are host instructions, not MSP430 cycles, so they only compare
+ * the two versions. The port accesses per digit are listed as well, each
+ * is one MSP430 instruction with an absolute address operand. Exit status
+ * is 1 if a check fails.
+ */
+
+/* Standard includes. */
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/ptrace.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/* User's includes */
+#include "msp430.h"
+#include "hal_7seg.h"
+
+/* Random port states every digit is checked from */
+#define mainPORT_STATES             ( 256 )
+#define mainDIGITS                  ( 10 )
+
+/* Markers raised by the benchmark around every measured version */
+#define mainMARKER_START            SIGUSR1
+#define mainMARKER_END              SIGUSR2
+
+typedef uint8_t ( *WriteDigitFunction_t )( uint8_t digit );
+
+volatile uint8_t            ucPortOut[9];
+volatile uint8_t            ucPortDir[9];
+uint32_t                    ulPortAccesses;
+volatile uint16_t           usTimerA1[6];
+
+/* Segments of glyphs after the digits, in HAL_7SEG_GLYPH order */
+static const char* const    xLetters[HAL_7SEG_GLYPH_COUNT - mainDIGITS] = {
+    "abcefg",   /* A */
+    "cdefg",    /* b */
+    "adef",     /* C */
+    "bcdeg",    /* d */
+    "adefg",    /* E */
+    "aefg",     /* F */
+    "",         /* Blank */
+    "g",        /* - */
+    "d",        /* _ */
+    "abfg",     /* Degree */
+    "bcefg",    /* H */
+    "def",      /* L */
+    "abefg",    /* P */
+};
+
+/* Port and mask of every segment, a to g */
+static const uint8_t        ucSegmentPort[7] = {
+    HAL_7SEG_SEGMENT_A_PORT, HAL_7SEG_SEGMENT_B_PORT, HAL_7SEG_SEGMENT_C_PORT, HAL_7SEG_SEGMENT_D_PORT,
+    HAL_7SEG_SEGMENT_E_PORT, HAL_7SEG_SEGMENT_F_PORT, HAL_7SEG_SEGMENT_G_PORT
+};
+static const uint8_t        ucSegmentMask[7] = {
+    HAL_7SEG_SEGMENT_A_MASK, HAL_7SEG_SEGMENT_B_MASK, HAL_7SEG_SEGMENT_C_MASK, HAL_7SEG_SEGMENT_D_MASK,
+    HAL_7SEG_SEGMENT_E_MASK, HAL_7SEG_SEGMENT_F_MASK, HAL_7SEG_SEGMENT_G_MASK
+};
+
+/**
+ * @brief vHAL7SEGWriteDigit as it was before the glyph table
+ */
+static uint8_t prvSwitchWriteDigit( uint8_t digit )
+{
+    switch(digit){
+        case 0:
+            HAL_7SEG_SEGMENT_A_ON;  HAL_7SEG_SEGMENT_B_ON;  HAL_7SEG_SEGMENT_C_ON;  HAL_7SEG_SEGMENT_D_ON;
+            HAL_7SEG_SEGMENT_E_ON;  HAL_7SEG_SEGMENT_F_ON;  HAL_7SEG_SEGMENT_G_OFF;
+            break;
+        case 1:
+            HAL_7SEG_SEGMENT_A_OFF; HAL_7SEG_SEGMENT_B_ON;  HAL_7SEG_SEGMENT_C_ON;  HAL_7SEG_SEGMENT_D_OFF;
+            HAL_7SEG_SEGMENT_E_OFF; HAL_7SEG_SEGMENT_F_OFF; HAL_7SEG_SEGMENT_G_OFF;
+            break;
+        case 2:
+            HAL_7SEG_SEGMENT_A_ON;  HAL_7SEG_SEGMENT_B_ON;  HAL_7SEG_SEGMENT_C_OFF; HAL_7SEG_SEGMENT_D_ON;
+            HAL_7SEG_SEGMENT_E_ON;  HAL_7SEG_SEGMENT_F_OFF; HAL_7SEG_SEGMENT_G_ON;
+            break;
+        case 3:
+            HAL_7SEG_SEGMENT_A_ON;  HAL_7SEG_SEGMENT_B_ON;  HAL_7SEG_SEGMENT_C_ON;  HAL_7SEG_SEGMENT_D_ON;
+            HAL_7SEG_SEGMENT_E_OFF; HAL_7SEG_SEGMENT_F_OFF; HAL_7SEG_SEGMENT_G_ON;
+            break;
+        case 4:
+            HAL_7SEG_SEGMENT_A_OFF; HAL_7SEG_SEGMENT_B_ON;  HAL_7SEG_SEGMENT_C_ON;  HAL_7SEG_SEGMENT_D_OFF;
+            HAL_7SEG_SEGMENT_E_OFF; HAL_7SEG_SEGMENT_F_ON;  HAL_7SEG_SEGMENT_G_ON;
+            break;
+        case 5:
+            HAL_7SEG_SEGMENT_A_ON;  HAL_7SEG_SEGMENT_B_OFF; HAL_7SEG_SEGMENT_C_ON;  HAL_7SEG_SEGMENT_D_ON;
+            HAL_7SEG_SEGMENT_E_OFF; HAL_7SEG_SEGMENT_F_ON;  HAL_7SEG_SEGMENT_G_ON;
+            break;
+        case 6:
+            HAL_7SEG_SEGMENT_A_ON;  HAL_7SEG_SEGMENT_B_OFF; HAL_7SEG_SEGMENT_C_ON;  HAL_7SEG_SEGMENT_D_ON;
+            HAL_7SEG_SEGMENT_E_ON;  HAL_7SEG_SEGMENT_F_ON;  HAL_7SEG_SEGMENT_G_ON;
+            break;
+        case 7:
+            HAL_7SEG_SEGMENT_A_ON;  HAL_7SEG_SEGMENT_B_ON;  HAL_7SEG_SEGMENT_C_ON;  HAL_7SEG_SEGMENT_D_OFF;
+            HAL_7SEG_SEGMENT_E_OFF; HAL_7SEG_SEGMENT_F_OFF; HAL_7SEG_SEGMENT_G_OFF;
+            break;
+        case 8:
+            HAL_7SEG_SEGMENT_A_ON;  HAL_7SEG_SEGMENT_B_ON;  HAL_7SEG_SEGMENT_C_ON;  HAL_7SEG_SEGMENT_D_ON;
+            HAL_7SEG_SEGMENT_E_ON;  HAL_7SEG_SEGMENT_F_ON;  HAL_7SEG_SEGMENT_G_ON;
+            break;
+        case 9:
+            HAL_7SEG_SEGMENT_A_ON;  HAL_7SEG_SEGMENT_B_ON;  HAL_7SEG_SEGMENT_C_ON;  HAL_7SEG_SEGMENT_D_OFF;
+            HAL_7SEG_SEGMENT_E_OFF; HAL_7SEG_SEGMENT_F_ON;  HAL_7SEG_SEGMENT_G_ON;
+            break;
+        default:
+            return 1;
+    }
+    return 0;
+}
+
+static void prvSetPorts( uint32_t state )
+{
+    ucPortOut[2] = ( uint8_t )state;
+    ucPortOut[3] = ( uint8_t )( state >> 8 );
+    ucPortOut[4] = ( uint8_t )( state >> 16 );
+    ucPortOut[8] = ( uint8_t )( state >> 24 );
+}
+
+/**
+ * @brief Segments that are lit, active low port bits decoded to "abcdefg" order
+ */
+static void prvLitSegments( char* segments )
+{
+    uint8_t i;
+
+    for( i = 0; i < 7; i++ )
+    {
+        if( ( ucPortOut[ucSegmentPort[i]] & ucSegmentMask[i] ) == 0 ) *segments++ = 'a' + i;
+    }
+    *segments = '\0';
+}
+
+/**
+ * @brief Port bits that are not segments must keep their value
+ */
+static int prvOtherBitsKept( const volatile uint8_t* before )
+{
+    uint8_t segmentBits[9] = { 0 };
+    uint8_t i;
+
+    for( i = 0; i < 7; i++ ) segmentBits[ucSegmentPort[i]] |= ucSegmentMask[i];
+    for( i = 0; i < 9; i++ )
+    {
+        if( ( ( before[i] ^ ucPortOut[i] ) & ~segmentBits[i] ) != 0 ) return 0;
+    }
+    return 1;
+}
+
+static int prvCheckGlyphs( void )
+{
+    uint8_t     expected[9], before[9];
+    char        segments[8];
+    uint32_t    state = 12345;
+    int         failures = 0;
+    uint16_t    i;
+    uint8_t     glyph;
+
+    for( i = 0; i < mainPORT_STATES; i++ )
+    {
+        state = state * 1103515245UL + 12345UL;
+        for( glyph = 0; glyph < HAL_7SEG_GLYPH_COUNT + 1; glyph++ )
+        {
+            prvSetPorts( state );
+            memcpy( before, ( const void* )ucPortOut, sizeof( before ) );
+            if( glyph < mainDIGITS )
+            {
+                ( void )prvSwitchWriteDigit( glyph );
+                memcpy( expected, ( const void* )ucPortOut, sizeof( expected ) );
+                prvSetPorts( state );
+                if( vHAL7SEGWriteDigit( glyph ) != 0 || memcmp( expected, ( const void* )ucPortOut, sizeof( expected ) ) != 0 )
+                {
+                    printf( "digit %u differs from the switch for ports %08lx\n", glyph, ( unsigned long )state );
+                    failures++;
+                }
+            }
+            else if( glyph < HAL_7SEG_GLYPH_COUNT )
+            {
+                if( vHAL7SEGWriteDigit( glyph ) != 0 ) failures++;
+                prvLitSegments( segments );
+                if( strcmp( segments, xLetters[glyph - mainDIGITS] ) != 0 || !prvOtherBitsKept( before ) )
+                {
+                    printf( "glyph %u lights \"%s\", expected \"%s\"\n", glyph, segments, xLetters[glyph - mainDIGITS] );
+                    failures++;
+                }
+            }
+            else if( vHAL7SEGWriteDigit( glyph ) != 1 || memcmp( before, ( const void* )ucPortOut, sizeof( before ) ) != 0 )
+            {
+                printf( "glyph %u does not exist but was written\n", glyph );
+                failures++;
+            }
+        }
+    }
+    return failures;
+}
+
+/**
+ * @brief Writes digits 0-9 with both versions between markers
+ */
+static void prvRunBenchmark( void )
+{
+    static const WriteDigitFunction_t functions[2] = { prvSwitchWriteDigit, vHAL7SEGWriteDigit };
+    uint8_t i, digit;
+
+    /* Nothing is measured, gives the cost of the markers themselves */
+    raise( mainMARKER_START );
+    raise( mainMARKER_END );
+    for( i = 0; i < 2; i++ )
+    {
+        raise( mainMARKER_START );
+        for( digit = 0; digit < mainDIGITS; digit++ ) ( void )functions[i]( digit );
+        raise( mainMARKER_END );
+    }
+}
+
+/**
+ * @brief Single-step the child between markers, fills counts per version
+ */
+static int prvTraceBenchmark( pid_t child, uint64_t* counts, int countsLength )
+{
+    int         status, measured = 0, counting = 0, stopSignal;
+
+    for( ;; )
+    {
+        if( waitpid( child, &status, 0 ) < 0 )
+        {
+            perror( "waitpid" );
+            return -1;
+        }
+        if( WIFEXITED( status ) ) break;
+        if( !WIFSTOPPED( status ) )
+        {
+            fprintf( stderr, "benchmark terminated abnormally\n" );
+            return -1;
+        }
+        stopSignal = WSTOPSIG( status );
+        if( stopSignal == mainMARKER_START && measured < countsLength )
+        {
+            counting            = 1;
+            counts[measured]    = 0;
+            stopSignal          = 0;
+        }
+        else if( stopSignal == mainMARKER_END )
+        {
+            counting = 0;
+            measured++;
+            stopSignal = 0;
+        }
+        else if( stopSignal == SIGTRAP || stopSignal == SIGSTOP )
+        {
+            stopSignal = 0;
+        }
+        if( counting )
+        {
+            counts[measured]++;
+            if( ptrace( PTRACE_SINGLESTEP, child, NULL, ( void* )( intptr_t )stopSignal ) < 0 ) return -1;
+        }
+        else
+        {
+            if( ptrace( PTRACE_CONT, child, NULL, ( void* )( intptr_t )stopSignal ) < 0 ) return -1;
+        }
+    }
+    if( measured != countsLength )
+    {
+        fprintf( stderr, "benchmark measured %d of %d versions\n", measured, countsLength );
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief main function
+ */
+int main( void )
+{
+    static const char* const    names[2] = { "switch", "glyph_table" };
+    uint32_t                    accesses[2];
+    uint64_t                    counts[3];
+    pid_t                       child;
+    int                         failures, i;
+    uint8_t                     digit;
+
+    failures = prvCheckGlyphs();
+    printf( "%d glyphs checked from %d port states, %d failures\n", HAL_7SEG_GLYPH_COUNT + 1, mainPORT_STATES, failures );
+
+    for( i = 0; i < 2; i++ )
+    {
+        ulPortAccesses = 0;
+        for( digit = 0; digit < mainDIGITS; digit++ ) ( void )( i == 0 ? prvSwitchWriteDigit( digit ) : vHAL7SEGWriteDigit( digit ) );
+        accesses[i] = ulPortAccesses;
+    }
+
+    child = fork();
+    if( child < 0 )
+    {
+        perror( "fork" );
+        return 2;
+    }
+    if( child == 0 )
+    {
+        if( ptrace( PTRACE_TRACEME, 0, NULL, NULL ) < 0 )
+        {
+            perror( "ptrace" );
+            _exit( 2 );
+        }
+        raise( SIGSTOP );
+        prvRunBenchmark();
+        _exit( 0 );
+    }
+    if( prvTraceBenchmark( child, counts, 3 ) != 0 ) return 2;
+
+    printf( "%-20s %14s %14s\n", "Version", "Instr/digit", "Ports/digit" );
+    for( i = 0; i < 2; i++ )
+    {
+        printf( "%-20s %14.1f %14.1f\n", names[i], ( double )( counts[i + 1] - counts[0] ) / mainDIGITS,
+                ( double )accesses[i] / mainDIGITS );
+    }
+    return failures != 0;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file    msp430.h
+ * @author  Haris Turkmanovic (haris@etf.rs)
+ * @date    2021
+ * @brief   Host emulation of the registers used by hal_7seg.c
+ *
+ * Stands in for the device header when hal_7seg.c is built on the host.
+ * Port registers are plain variables, every use of a segment port (P2, P3,
+ * P4 and P8) is counted in ulPortAccesses, which is the number of MSP430 instructions that touch
+ * a port: a compound assignment such as P3OUT |= mask is one BIS.B, a plain
+ * read or write is one MOV.B. Display ports P6 and P7 are not counted, their
+ * addresses are taken in a static initialiser. Timer registers and the interrupt state only
+ * have to exist.
+ */
+
+#ifndef SEVENSEGCHECK_MSP430_H_
+#define SEVENSEGCHECK_MSP430_H_
+
+#include <stdint.h>
+
+/*Indexed by port number*/
+extern volatile uint8_t     ucPortOut[9];
+extern volatile uint8_t     ucPortDir[9];
+extern uint32_t             ulPortAccesses;
+extern volatile uint16_t    usTimerA1[6];
+
+static inline volatile uint8_t* prvPortAccess( volatile uint8_t* reg )
+{
+    ulPortAccesses++;
+    return reg;
+}
+
+#define P2OUT               ( *prvPortAccess( &ucPortOut[2] ) )
+#define P3OUT               ( *prvPortAccess( &ucPortOut[3] ) )
+#define P4OUT               ( *prvPortAccess( &ucPortOut[4] ) )
+#define P6OUT               ( ucPortOut[6] )
+#define P7OUT               ( ucPortOut[7] )
+#define P8OUT               ( *prvPortAccess( &ucPortOut[8] ) )
+#define P2DIR               ( ucPortDir[2] )
+#define P3DIR               ( ucPortDir[3] )
+#define P4DIR               ( ucPortDir[4] )
+#define P6DIR               ( ucPortDir[6] )
+#define P7DIR               ( ucPortDir[7] )
+#define P8DIR               ( ucPortDir[8] )
+
+#define TA1CTL              ( usTimerA1[0] )
+#define TA1CCTL0            ( usTimerA1[1] )
+#define TA1CCTL1            ( usTimerA1[2] )
+#define TA1CCR0             ( usTimerA1[3] )
+#define TA1CCR1             ( usTimerA1[4] )
+#define TA1IV               ( usTimerA1[5] )
+#define CCIE                ( 0x0010 )
+#define TASSEL_1            ( 0x0100 )
+#define MC_0                ( 0x0000 )
+#define MC_1                ( 0x0010 )
+#define TACLR               ( 0x0004 )
+
+/*Interrupt functions become plain functions*/
+#define interrupt(vector)   unused
+#define __get_interrupt_state()     ( ( unsigned short )0 )
+#define __set_interrupt_state(x)    ( ( void )( x ) )
+#define __disable_interrupt()
+#define __even_in_range(x, y)       ( x )
+
+#endif /* SEVENSEGCHECK_MSP430_H_ */